@@ -3,8 +3,13 @@ out vec4 FragColor;
 
 in vec2 TexCoords;
 
+uniform sampler2D texture1;
+// 0：按纹理坐标着色；1：使用异步上传的纹理
+uniform float textureMix;
+
 void main()
 {
     // Funky colors based on texture coordinates just to see something
-    FragColor = vec4(TexCoords.x, TexCoords.y, 0.5, 1.0);
+    vec4 funky = vec4(TexCoords.x, TexCoords.y, 0.5, 1.0);
+    FragColor = mix(funky, texture(texture1, TexCoords), textureMix);
 }
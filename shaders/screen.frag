@@ -4,10 +4,29 @@ out vec4 FragColor;
 in vec2 TexCoords;
 
 uniform sampler2D screenTexture;
+// 纹理中有效内容占分配尺寸的比例；所有采样（含中心）都不越过内容边界
+uniform vec2 uvScale;
+// 一个纹素的纹理坐标尺寸
+uniform vec2 texelSize;
+// 锐化放大强度，0 表示只做双线性
+uniform float sharpness;
+
+vec3 Fetch(vec2 uv)
+{
+    return texture(screenTexture, clamp(uv, 0.5 * texelSize, uvScale - 0.5 * texelSize)).rgb;
+}
 
 void main()
 {
-    vec3 col = texture(screenTexture, TexCoords).rgb;
+    // 内容尺寸小于分配尺寸时，边缘之外是上一帧更大画面的残留，中心采样同样要钳制
+    vec3 col = Fetch(TexCoords);
+    if (sharpness > 0.0)
+    {
+        // 反锐化掩模：加上中心与 4 邻域平均值之差
+        vec3 neighbors = Fetch(TexCoords + vec2(texelSize.x, 0.0)) + Fetch(TexCoords - vec2(texelSize.x, 0.0)) +
+                         Fetch(TexCoords + vec2(0.0, texelSize.y)) + Fetch(TexCoords - vec2(0.0, texelSize.y));
+        col = clamp(col + sharpness * (4.0 * col - neighbors), 0.0, 1.0);
+    }
     
     // Grayscale effect
     float average = 0.2126 * col.r + 0.7152 * col.g + 0.0722 * col.b;
@@ -4,8 +4,14 @@ layout (location = 1) in vec2 aTexCoords;
 
 out vec2 TexCoords;
 
+// 绘制区域（纹理坐标空间 x0, y0, x1, y1），默认 (0, 0, 1, 1) 为全屏
+uniform vec4 region;
+// 纹理中有效内容占分配尺寸的比例（渲染目标按尺寸分档分配时小于 1）
+uniform vec2 uvScale;
+
 void main()
 {
-    gl_Position = vec4(aPos.x, aPos.y, 0.0, 1.0); 
-    TexCoords = aTexCoords;
+    vec2 uv = mix(region.xy, region.zw, aTexCoords);
+    gl_Position = vec4(uv * 2.0 - 1.0, 0.0, 1.0);
+    TexCoords = uv * uvScale;
 }
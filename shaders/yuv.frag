@@ -0,0 +1,41 @@
+#version 330 core
+// RGB -> YUV 4:2:0 平面转换，输出行序自顶向下（回读后第 0 行即画面顶部），与编码器期望的 I420 布局一致
+layout (location = 0) out vec4 Plane0; // 亮度 pass 写 Y；色度 pass 写 U
+layout (location = 1) out vec4 Plane1; // 色度 pass 写 V
+
+uniform sampler2D sourceTexture;
+// 0：亮度平面（全分辨率）；1：色度平面（宽高各减半，2x2 像素取平均）
+uniform int chroma;
+// 转换矩阵的三行（BT.601 / BT.709）
+uniform vec3 yCoeffs;
+uniform vec3 uCoeffs;
+uniform vec3 vCoeffs;
+// 量化范围：缩放与偏移（归一化到 0~1），全范围或有限范围（16–235 / 16–240）
+uniform vec2 yRange;
+uniform vec2 cRange;
+
+vec3 Fetch(ivec2 p, ivec2 size)
+{
+    p = clamp(p, ivec2(0), size - 1);
+    // 源纹理自底向上
+    return texelFetch(sourceTexture, ivec2(p.x, size.y - 1 - p.y), 0).rgb;
+}
+
+void main()
+{
+    ivec2 size = textureSize(sourceTexture, 0);
+    ivec2 pos = ivec2(gl_FragCoord.xy);
+    if (chroma == 0)
+    {
+        float y = dot(yCoeffs, Fetch(pos, size));
+        Plane0 = vec4(y * yRange.x + yRange.y);
+        Plane1 = vec4(0.0);
+    }
+    else
+    {
+        ivec2 p = pos * 2;
+        vec3 rgb = (Fetch(p, size) + Fetch(p + ivec2(1, 0), size) + Fetch(p + ivec2(0, 1), size) + Fetch(p + ivec2(1, 1), size)) * 0.25;
+        Plane0 = vec4(dot(uCoeffs, rgb) * cRange.x + cRange.y);
+        Plane1 = vec4(dot(vCoeffs, rgb) * cRange.x + cRange.y);
+    }
+}
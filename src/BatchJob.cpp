@@ -0,0 +1,328 @@
+#include "BatchJob.h"
+#include "Headless.h"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+    std::string Trim(const std::string &text)
+    {
+        size_t begin = text.find_first_not_of(" \t\r\n");
+        if (begin == std::string::npos)
+            return std::string();
+        size_t end = text.find_last_not_of(" \t\r\n");
+        return text.substr(begin, end - begin + 1);
+    }
+
+    // 去掉行尾注释：前面有空白的 # 或 ; 之后的内容（路径中紧贴的 # 不受影响）
+    std::string StripComment(const std::string &text)
+    {
+        for (size_t i = 1; i < text.size(); ++i)
+        {
+            if ((text[i] == '#' || text[i] == ';') && (text[i - 1] == ' ' || text[i - 1] == '\t'))
+                return text.substr(0, i);
+        }
+        return text;
+    }
+
+    std::string JsonString(const std::string &text)
+    {
+        std::string out = "\"";
+        for (char c : text)
+        {
+            switch (c)
+            {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if ((unsigned char)c < 0x20)
+                {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                    out += escaped;
+                }
+                else
+                {
+                    out += c;
+                }
+            }
+        }
+        return out + "\"";
+    }
+
+    struct KeyValue
+    {
+        std::string key, value;
+        int line;
+    };
+
+    // 把一段作业的键值应用到 job 上：作业专用键直接解析，其余转换成命令行参数交给 ParseRenderArgs
+    bool ApplyKeys(const std::vector<KeyValue> &keys, BatchJob &job)
+    {
+        std::vector<std::string> args = {"batch"};
+        bool hasFrames = false, hasDuration = false;
+        for (const KeyValue &kv : keys)
+        {
+            std::istringstream values(kv.value);
+            if (kv.key == "name")
+            {
+                job.name = kv.value;
+            }
+            else if (kv.key == "mode")
+            {
+                if (kv.value != "single" && kv.value != "multi" && kv.value != "sfr")
+                {
+                    std::printf("第 %d 行: 未知的渲染模式 %s (可选 single/multi/sfr)\n", kv.line, kv.value.c_str());
+                    return false;
+                }
+                args.push_back("--" + kv.value);
+            }
+            else if (kv.key == "width" || kv.key == "height")
+            {
+                int size = 0;
+                if (!(values >> size) || size <= 0 || size > 16384)
+                {
+                    std::printf("第 %d 行: 无效的尺寸 %s\n", kv.line, kv.value.c_str());
+                    return false;
+                }
+                (kv.key == "width" ? job.width : job.height) = size;
+            }
+            else if (kv.key == "camera")
+            {
+                SceneScript::CameraPose pose;
+                if (!(values >> pose.eye.x >> pose.eye.y >> pose.eye.z >> pose.target.x >> pose.target.y >> pose.target.z))
+                {
+                    std::printf("第 %d 行: 相机格式为 ex ey ez tx ty tz [fov]\n", kv.line);
+                    return false;
+                }
+                values >> pose.fovDegrees;
+                job.settings.script.cameras.push_back(pose);
+                job.settings.script.active = true;
+            }
+            else if (kv.key == "rotation-axis")
+            {
+                glm::vec3 &axis = job.settings.script.rotationAxis;
+                if (!(values >> axis.x >> axis.y >> axis.z))
+                {
+                    std::printf("第 %d 行: 旋转轴格式为 x y z\n", kv.line);
+                    return false;
+                }
+                job.settings.script.active = true;
+            }
+            else if (kv.key == "rotation-speed")
+            {
+                if (!(values >> job.settings.script.rotationDegreesPerSecond))
+                {
+                    std::printf("第 %d 行: 无效的旋转速度 %s\n", kv.line, kv.value.c_str());
+                    return false;
+                }
+                job.settings.script.active = true;
+            }
+            else if (kv.value == "false" || kv.value == "no" || kv.value == "off")
+            {
+                continue;
+            }
+            else
+            {
+                hasFrames |= kv.key == "frames";
+                hasDuration |= kv.key == "duration";
+                args.push_back("--" + kv.key);
+                if (!kv.value.empty() && kv.value != "true" && kv.value != "yes" && kv.value != "on")
+                {
+                    // 多个取值（例如 readback 的深度）按空白拆开
+                    std::string token;
+                    while (values >> token)
+                        args.push_back(token);
+                }
+            }
+        }
+
+        std::vector<char *> argv;
+        for (std::string &arg : args)
+            argv.push_back(&arg[0]);
+        std::vector<std::string> unknown;
+        ParseRenderArgs((int)argv.size(), argv.data(), job.settings, &unknown);
+        if (!unknown.empty())
+        {
+            // 拼写错误的键不能静默忽略，否则作业会按默认参数跑完
+            for (const KeyValue &kv : keys)
+            {
+                if (kv.key == unknown[0])
+                {
+                    std::printf("第 %d 行: 未知的键或缺少取值 %s\n", kv.line, kv.key.c_str());
+                    return false;
+                }
+            }
+            std::printf("未知的键或缺少取值 %s\n", unknown[0].c_str());
+            return false;
+        }
+
+        // 只给了帧数时按帧数结束，不受默认时长限制
+        if (hasFrames && !hasDuration)
+            job.settings.durationSeconds = 24 * 3600.0;
+        job.settings.headless = true;
+        return true;
+    }
+}
+
+namespace Batch
+{
+    bool LoadJobs(const std::string &path, const RenderSettings &defaults, std::vector<BatchJob> &jobs)
+    {
+        std::ifstream file(path);
+        if (!file)
+        {
+            std::printf("无法打开作业文件: %s\n", path.c_str());
+            return false;
+        }
+
+        std::vector<KeyValue> common;
+        std::vector<std::vector<KeyValue>> sections;
+        std::vector<int> sectionLines;
+        std::string line;
+        int lineNumber = 0;
+        while (std::getline(file, line))
+        {
+            lineNumber++;
+            line = Trim(StripComment(line));
+            if (line.empty() || line[0] == '#' || line[0] == ';')
+                continue;
+            if (line == "[job]")
+            {
+                sections.emplace_back();
+                sectionLines.push_back(lineNumber);
+                continue;
+            }
+            size_t equals = line.find('=');
+            if (equals == std::string::npos)
+            {
+                std::printf("%s 第 %d 行: 应为 key = value 或 [job]\n", path.c_str(), lineNumber);
+                return false;
+            }
+            KeyValue kv{Trim(line.substr(0, equals)), Trim(line.substr(equals + 1)), lineNumber};
+            (sections.empty() ? common : sections.back()).push_back(kv);
+        }
+
+        for (size_t i = 0; i < sections.size(); ++i)
+        {
+            BatchJob job;
+            job.settings = defaults;
+            job.line = sectionLines[i];
+            // 作业自己的键排在默认键之后，后出现的覆盖先出现的
+            std::vector<KeyValue> keys = common;
+            keys.insert(keys.end(), sections[i].begin(), sections[i].end());
+            if (!ApplyKeys(keys, job))
+                return false;
+            if (job.name.empty())
+                job.name = "job" + std::to_string(i + 1);
+            jobs.push_back(job);
+        }
+        if (jobs.empty())
+            std::printf("作业文件 %s 中没有 [job] 段\n", path.c_str());
+        return !jobs.empty();
+    }
+
+    // 作业至少呈现了一帧，且给了帧数时达到了要求
+    static bool JobOk(const BatchJob &job, const HeadlessReport &report)
+    {
+        long long limit = job.settings.frameLimit;
+        return report.presentedFrames > 0 && (limit <= 0 || (long long)report.presentedFrames >= limit);
+    }
+
+    static void WriteSummary(const std::string &path, const std::string &jobFile, const std::vector<BatchJob> &jobs,
+                             const std::vector<HeadlessReport> &reports, double totalSeconds)
+    {
+        // 先写临时文件再改名，调度器读取时不会看到写了一半的 JSON
+        std::string temp = path + ".tmp";
+        FILE *file = std::fopen(temp.c_str(), "w");
+        if (!file)
+        {
+            std::printf("无法写入汇总文件: %s\n", path.c_str());
+            return;
+        }
+        size_t okJobs = 0;
+        for (size_t i = 0; i < reports.size(); ++i)
+            okJobs += JobOk(jobs[i], reports[i]);
+        // ranJobs 为已运行的作业数，okJobs 只统计达到要求帧数的作业
+        std::fprintf(file, "{\n  \"jobFile\": %s,\n  \"ranJobs\": %zu,\n  \"okJobs\": %zu,\n  \"totalJobs\": %zu,\n  \"totalSeconds\": %.3f,\n  \"jobs\": [",
+                     JsonString(jobFile).c_str(), reports.size(), okJobs, jobs.size(), totalSeconds);
+        for (size_t i = 0; i < reports.size(); ++i)
+        {
+            const BatchJob &job = jobs[i];
+            const RenderSettings &s = job.settings;
+            const HeadlessReport &r = reports[i];
+            bool ok = JobOk(job, r);
+            std::fprintf(file, "%s\n    {\n", i ? "," : "");
+            std::fprintf(file, "      \"name\": %s,\n      \"status\": \"%s\",\n", JsonString(job.name).c_str(), ok ? "ok" : "incomplete");
+            std::fprintf(file, "      \"mode\": \"%s\",\n      \"width\": %d,\n      \"height\": %d,\n", RenderModeName(s.renderMode), job.width, job.height);
+            std::fprintf(file, "      \"requestedFrames\": %lld,\n      \"frames\": %llu,\n      \"renderedFrames\": %llu,\n      \"droppedFrames\": %llu,\n",
+                         s.frameLimit, r.presentedFrames, r.renderedFrames, r.droppedFrames);
+            std::fprintf(file, "      \"wallSeconds\": %.3f,\n      \"fps\": %.2f,\n", r.seconds, r.presentFps);
+            std::fprintf(file, "      \"outputs\": {");
+            const char *separator = "";
+            auto output = [&](const char *key, const std::string &value) {
+                if (value.empty())
+                    return;
+                std::fprintf(file, "%s\n        \"%s\": %s", separator, key, JsonString(value).c_str());
+                separator = ",";
+            };
+            output("export", s.exportDir);
+            output("sink", s.sinkPath);
+            output("shm", s.shmName);
+            output("container", s.containerPath);
+            output("snapshots", s.recordPath);
+            std::fprintf(file, "%s}", *separator ? "\n      " : "");
+            if (s.readbackDepth > 0)
+                std::fprintf(file, ",\n      \"readback\": {\"frames\": %llu, \"skipped\": %llu, \"latencyMs\": %.3f, \"MBps\": %.1f}",
+                             r.readbackFrames, r.readbackSkipped, r.readbackLatencyMs, r.readbackMBps);
+            if (s.damageKeyframe > 0 && s.readbackDepth > 0)
+                std::fprintf(file, ",\n      \"damage\": {\"keyframes\": %llu, \"deltaFrames\": %llu, \"coverage\": %.4f}",
+                             r.damageKeyframes, r.damageDeltaFrames, r.damageCoverage);
+            std::fprintf(file, ",\n      \"vram\": {\"peakBytes\": %zu, \"peakUnaliasedBytes\": %zu}", r.peakBytes, r.peakUnaliasedBytes);
+            if (s.renderMode == RenderMode::Single)
+                std::fprintf(file, ",\n      \"gpu\": {\"msaa\": %d, \"sceneMs\": %.3f, \"resolveMs\": %.3f}", s.msaaSamples,
+                             r.gpuSceneMs, r.gpuResolveMs);
+            if (!s.exportDir.empty())
+                std::fprintf(file, ",\n      \"export\": {\"frames\": %llu, \"fps\": %.2f, \"perCoreMBps\": %.1f}",
+                             r.exportedFrames, r.exportFps, r.exportPerCoreMBps);
+            std::fprintf(file, "\n    }");
+        }
+        std::fprintf(file, "\n  ]\n}\n");
+        bool written = std::fclose(file) == 0;
+        if (!written || std::rename(temp.c_str(), path.c_str()) != 0)
+            std::printf("无法写入汇总文件: %s\n", path.c_str());
+    }
+
+    int Run(GLFWwindow *context, const RenderSettings &settings)
+    {
+        std::vector<BatchJob> jobs;
+        if (!LoadJobs(settings.batchFile, settings, jobs))
+            return -1;
+
+        std::printf("批处理: %s  共 %zu 个作业  汇总: %s\n", settings.batchFile.c_str(), jobs.size(), settings.batchSummary.c_str());
+        auto start = std::chrono::steady_clock::now();
+        std::vector<HeadlessReport> reports;
+        int failed = 0;
+        for (size_t i = 0; i < jobs.size(); ++i)
+        {
+            const BatchJob &job = jobs[i];
+            std::printf("\n=== 作业 %zu/%zu: %s (第 %d 行) ===\n", i + 1, jobs.size(), job.name.c_str(), job.line);
+            std::fflush(stdout);
+            HeadlessReport report = Headless::Run(context, job.settings, job.width, job.height);
+            if (!JobOk(job, report))
+                failed++;
+            reports.push_back(report);
+            // 每个作业结束都刷新汇总，批处理中途被终止时已完成的结果仍然可用
+            WriteSummary(settings.batchSummary, settings.batchFile, jobs, reports,
+                         std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        }
+
+        double total = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::printf("\n批处理完成  作业: %zu  未完成: %d  总耗时: %.2fs  汇总: %s\n", jobs.size(), failed, total, settings.batchSummary.c_str());
+        return failed;
+    }
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <string>
+#include <vector>
+#include "RenderSettings.h"
+
+// 批处理作业：作业文件中的一个 [job] 段
+struct BatchJob
+{
+    std::string name;
+    RenderSettings settings;
+    int width = 1920, height = 1080;
+    int line = 0; // 在作业文件中的起始行，用于报错
+};
+
+// 批处理模式：从作业文件读取一组作业，逐个无头渲染，并把结果写入汇总 JSON。
+//
+// 作业文件为 key = value 行，# 或 ; 开头为注释，前面有空白的 # 或 ; 之后为行尾注释；未知的键报错。第一个 [job] 之前的键作为所有作业的默认值。
+// 除下列作业专用键外，其余键与命令行参数同名（去掉 --），例如 render-load = 20、export = out/a：
+//   name = 作业名
+//   mode = single | multi | sfr
+//   width = 1280 / height = 720
+//   camera = ex ey ez tx ty tz [fov]   （可重复，多个相机关键帧在整段作业上插值）
+//   rotation-axis = x y z / rotation-speed = 度每秒
+// 取值为 true / false 的键对应无参数的开关（例如 upload-demo = true）。
+namespace Batch
+{
+    // 解析作业文件；defaults 为命令行给出的参数，作为每个作业的初值
+    bool LoadJobs(const std::string &path, const RenderSettings &defaults, std::vector<BatchJob> &jobs);
+
+    // 依次运行 settings.batchFile 中的作业，返回失败的作业数（无法读取作业文件时返回 -1）
+    // context 的上下文必须在调用线程中为当前上下文
+    int Run(GLFWwindow *context, const RenderSettings &settings);
+}
@@ -0,0 +1,172 @@
+#include "Benchmark.h"
+#include "WorkerPool.h"
+#include "Framebuffer.h"
+#include "Scene.h"
+#include "Shader.h"
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+namespace Benchmark
+{
+    void RunAfrScaling(GLFWwindow *window, int width, int height, int maxWorkers, double secondsPerStep, int renderLoad)
+    {
+        using clock = std::chrono::steady_clock;
+
+        std::printf("AFR 扩展性测试  渲染器: %s  分辨率: %dx%d  渲染负载: %d  每档时长: %.1fs\n",
+                    (const char *)glGetString(GL_RENDERER), width, height, renderLoad, secondsPerStep);
+        std::printf("%4s %12s %10s %10s\n", "K", "frames/s", "speedup", "efficiency");
+
+        // 静态场景：每个 Worker 重复渲染同一份快照
+        CommandList commands;
+        commands.SetWorkload(renderLoad);
+        SceneState state = SimulateScene(1, 0.5, (float)width / (float)height);
+
+        double baseline = 0.0;
+        for (int k = 1; k <= maxWorkers; ++k)
+        {
+            WorkerPool pool(window, width, height, k);
+            pool.SetPresentMode(PresentMode::Fifo);
+            pool.SubmitCommands(commands);
+            pool.PublishScene(state);
+            pool.Start();
+
+            // 预热：等待每个 Worker 完成初始化并产出首帧
+            auto warmupEnd = clock::now() + std::chrono::milliseconds(500);
+            while (clock::now() < warmupEnd)
+                pool.TryGetReadyTexture();
+
+            // 主线程只按序取帧不做其他工作，吞吐量即 K 个 Worker 的渲染能力
+            unsigned long long presented = 0;
+            auto start = clock::now();
+            auto end = start + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(secondsPerStep));
+            while (clock::now() < end)
+            {
+                if (pool.TryGetReadyTexture())
+                    presented++;
+                else
+                    std::this_thread::yield();
+            }
+            double elapsed = std::chrono::duration<double>(clock::now() - start).count();
+            pool.Stop();
+
+            double fps = presented / elapsed;
+            if (k == 1)
+                baseline = fps;
+            double speedup = baseline > 0.0 ? fps / baseline : 0.0;
+            std::printf("%4d %12.1f %9.2fx %9.0f%%\n", k, fps, speedup, speedup / k * 100.0);
+            std::fflush(stdout);
+        }
+    }
+
+    void RunAntialiasing(int width, int height, double secondsPerStep, int renderLoad)
+    {
+        using clock = std::chrono::steady_clock;
+
+        struct Config
+        {
+            const char *name;
+            int samples; // 多重采样数
+            int scale;   // 超采样时每个方向的倍数
+        };
+        const Config configs[] = {{"off", 0, 1}, {"msaa2", 2, 1}, {"msaa4", 4, 1}, {"msaa8", 8, 1}, {"ssaa4", 0, 2}};
+        // 预热帧不计入结果；每档在时长之外至少再测够 MinFrames 帧，时长很短时也不会有档位没有样本
+        const int WarmupFrames = 10;
+        const int MinFrames = 30;
+
+        std::printf("抗锯齿开销测试  渲染器: %s  分辨率: %dx%d  渲染负载: %d  每档时长: %.1fs\n",
+                    (const char *)glGetString(GL_RENDERER), width, height, renderLoad, secondsPerStep);
+        std::printf("%-8s %8s %10s %10s %10s %10s\n", "mode", "samples", "draw ms", "resolve ms", "relative", "VRAM MB");
+
+        Scene scene;
+        scene.SetWorkload(renderLoad);
+        Shader shader("shaders/scene.vert", "shaders/scene.frag");
+        shader.use();
+        shader.setInt("texture1", 0);
+        shader.setFloat("textureMix", 0.0f);
+        SceneState state = SimulateScene(1, 0.5, (float)width / (float)height);
+        shader.setMat4("view", state.view);
+        shader.setMat4("projection", state.projection);
+        glEnable(GL_DEPTH_TEST);
+
+        GLuint queries[2];
+        glGenQueries(2, queries);
+        double baseline = 0.0;
+        for (const Config &config : configs)
+        {
+            FramebufferDesc desc;
+            desc.width = width * config.scale;
+            desc.height = height * config.scale;
+            desc.samples = config.samples;
+            Framebuffer target(desc);
+            if (config.samples > 0 && target.GetSamples() != config.samples)
+            {
+                std::printf("%-8s 驱动不支持 %d 个采样（上限 %d），跳过\n", config.name, config.samples, target.GetSamples());
+                continue;
+            }
+            // 超采样：大尺寸目标线性缩小到输出尺寸（2x2 像素的中心恰好取四个像素的平均）
+            Framebuffer *output = nullptr;
+            if (config.scale > 1)
+            {
+                FramebufferDesc outputDesc;
+                outputDesc.width = width;
+                outputDesc.height = height;
+                outputDesc.depth = DepthAttachment::None;
+                output = new Framebuffer(outputDesc);
+            }
+
+            // 每帧等待查询结果：测的是单帧的 GPU 耗时而不是流水线吞吐
+            double drawMs = 0.0, resolveMs = 0.0;
+            int frames = 0;
+            auto end = clock::now() + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(secondsPerStep));
+            for (int frame = 0; clock::now() < end || frames < MinFrames; ++frame)
+            {
+                glBeginQuery(GL_TIME_ELAPSED, queries[0]);
+                target.Bind();
+                glClearColor(state.clearColor.r, state.clearColor.g, state.clearColor.b, state.clearColor.a);
+                glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+                for (int i = 0; i < state.objectCount; ++i)
+                {
+                    shader.setMat4("model", state.objects[i].model);
+                    scene.Draw(state.objects[i].mesh);
+                }
+                glEndQuery(GL_TIME_ELAPSED);
+
+                glBeginQuery(GL_TIME_ELAPSED, queries[1]);
+                if (output)
+                {
+                    glBindFramebuffer(GL_READ_FRAMEBUFFER, target.GetId());
+                    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, output->GetId());
+                    glBlitFramebuffer(0, 0, desc.width, desc.height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+                }
+                else
+                {
+                    target.Resolve();
+                }
+                glEndQuery(GL_TIME_ELAPSED);
+                target.Unbind();
+
+                GLuint64 drawNs = 0, resolveNs = 0;
+                glGetQueryObjectui64v(queries[0], GL_QUERY_RESULT, &drawNs);
+                glGetQueryObjectui64v(queries[1], GL_QUERY_RESULT, &resolveNs);
+                if (frame < WarmupFrames)
+                    continue;
+                drawMs += drawNs / 1e6;
+                resolveMs += resolveNs / 1e6;
+                frames++;
+            }
+            size_t bytes = target.GetAllocatedBytes() + (output ? output->GetAllocatedBytes() : 0);
+            delete output;
+
+            drawMs /= frames;
+            resolveMs /= frames;
+            if (config.samples == 0 && config.scale == 1)
+                baseline = drawMs + resolveMs;
+            int samples = config.samples > 0 ? config.samples : config.scale * config.scale;
+            std::printf("%-8s %8d %10.3f %10.3f %9.2fx %10.1f\n", config.name, samples, drawMs, resolveMs,
+                        baseline > 0.0 ? (drawMs + resolveMs) / baseline : 0.0, bytes / (1024.0 * 1024.0));
+            std::fflush(stdout);
+        }
+        glDeleteQueries(2, queries);
+    }
+}
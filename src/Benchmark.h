@@ -0,0 +1,15 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+// 非交互式性能测试，结果输出到标准输出
+namespace Benchmark
+{
+    // AFR 扩展性测试：依次以 K = 1..maxWorkers 个 Worker 渲染，统计按序呈现的吞吐量
+    // window 的上下文必须在调用线程中为当前上下文
+    void RunAfrScaling(GLFWwindow *window, int width, int height, int maxWorkers, double secondsPerStep, int renderLoad);
+    // 抗锯齿开销测试：在调用线程的上下文中依次以无抗锯齿、MSAA 2x/4x/8x 与 4x 超采样渲染同一场景，
+    // 用 GPU 计时查询统计每帧的绘制与解析（超采样为缩小）耗时以及渲染目标的显存
+    void RunAntialiasing(int width, int height, double secondsPerStep, int renderLoad);
+}
@@ -0,0 +1,170 @@
+#include "DamageTracker.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// 光栅化与线性过滤可能越出几何包围盒的像素数
+static const int EdgeMargin = 2;
+
+DamageTracker::DamageTracker(int keyframeInterval, int tileSize)
+    : keyframeInterval(std::max(1, keyframeInterval)), tileSize(std::max(8, tileSize))
+{
+    SetMeshBounds(0, glm::vec3(-0.5f), glm::vec3(0.5f));
+}
+
+void DamageTracker::Record(const SceneState &state)
+{
+    history[state.frame % HistoryLength] = state;
+}
+
+void DamageTracker::SetMeshBounds(int mesh, const glm::vec3 &min, const glm::vec3 &max)
+{
+    if (mesh < 0)
+        return;
+    if ((int)meshBounds.size() <= mesh)
+        meshBounds.resize(mesh + 1);
+    meshBounds[mesh].known = true;
+    meshBounds[mesh].min = min;
+    meshBounds[mesh].max = max;
+}
+
+void DamageTracker::Invalidate(uint64_t sceneFrame)
+{
+    // 渲染端在下一份快照发布之后才会看到变化
+    keyframeUntil = std::max(keyframeUntil, sceneFrame + 1);
+}
+
+const SceneState *DamageTracker::Find(uint64_t sceneFrame) const
+{
+    if (sceneFrame == 0)
+        return nullptr;
+    const SceneState &state = history[sceneFrame % HistoryLength];
+    return state.frame == sceneFrame ? &state : nullptr;
+}
+
+bool DamageTracker::MarkObject(const SceneState &state, const SceneState::Object &object)
+{
+    if (object.mesh < 0 || object.mesh >= (int)meshBounds.size() || !meshBounds[object.mesh].known)
+        return false;
+    const MeshBounds &bounds = meshBounds[object.mesh];
+    glm::mat4 mvp = state.projection * state.view * object.model;
+
+    float minX = 1.0f, minY = 1.0f, maxX = -1.0f, maxY = -1.0f;
+    for (int corner = 0; corner < 8; ++corner)
+    {
+        glm::vec3 p((corner & 1) ? bounds.max.x : bounds.min.x, (corner & 2) ? bounds.max.y : bounds.min.y,
+                    (corner & 4) ? bounds.max.z : bounds.min.z);
+        glm::vec4 clip = mvp * glm::vec4(p, 1.0f);
+        // 包围盒跨过相机平面时投影不再是凸包，保守地按整帧处理
+        if (clip.w <= 1e-4f)
+            return false;
+        minX = std::min(minX, clip.x / clip.w);
+        maxX = std::max(maxX, clip.x / clip.w);
+        minY = std::min(minY, clip.y / clip.w);
+        maxY = std::max(maxY, clip.y / clip.w);
+    }
+    if (maxX < -1.0f || minX > 1.0f || maxY < -1.0f || minY > 1.0f)
+        return true; // 完全在视野外
+
+    int x0 = (int)std::floor((minX * 0.5f + 0.5f) * width) - EdgeMargin;
+    int x1 = (int)std::ceil((maxX * 0.5f + 0.5f) * width) + EdgeMargin;
+    int y0 = (int)std::floor((minY * 0.5f + 0.5f) * height) - EdgeMargin;
+    int y1 = (int)std::ceil((maxY * 0.5f + 0.5f) * height) + EdgeMargin;
+    MarkPixels(x0, y0, x1, y1);
+    return true;
+}
+
+void DamageTracker::MarkPixels(int x0, int y0, int x1, int y1)
+{
+    x0 = std::max(x0, 0);
+    y0 = std::max(y0, 0);
+    x1 = std::min(x1, width);
+    y1 = std::min(y1, height);
+    if (x0 >= x1 || y0 >= y1)
+        return;
+    for (int ty = y0 / tileSize; ty <= (y1 - 1) / tileSize; ++ty)
+        std::memset(&dirty[(size_t)ty * tilesX + x0 / tileSize], 1, (x1 - 1) / tileSize - x0 / tileSize + 1);
+}
+
+void DamageTracker::SetKeyframe()
+{
+    damage.keyframe = true;
+    damage.rects.clear();
+    damage.coverage = 1.0;
+}
+
+const FrameDamage &DamageTracker::Compute(uint64_t sceneFrame, int width, int height)
+{
+    this->width = width;
+    this->height = height;
+    tilesX = (width + tileSize - 1) / tileSize;
+    tilesY = (height + tileSize - 1) / tileSize;
+    dirty.assign((size_t)tilesX * tilesY, 0);
+    damage.keyframe = false;
+    damage.rects.clear();
+
+    const SceneState *current = Find(sceneFrame);
+    const SceneState *previous = Find(lastSceneFrame);
+    bool full = !current || !previous || width != lastWidth || height != lastHeight || sceneFrame <= keyframeUntil ||
+                sinceKeyframe + 1 >= keyframeInterval;
+    // 相机、背景或物体集合变化时整帧都变了
+    full = full || std::memcmp(&current->view, &previous->view, sizeof(glm::mat4)) != 0 ||
+           std::memcmp(&current->projection, &previous->projection, sizeof(glm::mat4)) != 0 ||
+           current->clearColor != previous->clearColor || current->objectCount != previous->objectCount;
+    for (int i = 0; !full && i < current->objectCount; ++i)
+    {
+        const SceneState::Object &a = previous->objects[i];
+        const SceneState::Object &b = current->objects[i];
+        if (a.mesh != b.mesh)
+            full = true;
+        else if (std::memcmp(&a.model, &b.model, sizeof(glm::mat4)) != 0)
+            full = !MarkObject(*previous, a) || !MarkObject(*current, b);
+    }
+    if (!full)
+    {
+        // 每个分块行中连续的脏分块合并为一个矩形
+        long long area = 0;
+        for (int ty = 0; ty < tilesY; ++ty)
+        {
+            const unsigned char *row = &dirty[(size_t)ty * tilesX];
+            for (int tx = 0; tx < tilesX;)
+            {
+                if (!row[tx])
+                {
+                    tx++;
+                    continue;
+                }
+                int start = tx;
+                while (tx < tilesX && row[tx])
+                    tx++;
+                DamageRect r;
+                r.x = start * tileSize;
+                r.y = ty * tileSize;
+                r.w = std::min(tx * tileSize, width) - r.x;
+                r.h = std::min((ty + 1) * tileSize, height) - r.y;
+                damage.rects.push_back(r);
+                area += (long long)r.w * r.h;
+            }
+        }
+        damage.coverage = (double)area / ((double)width * height);
+        // 全部分块都脏时直接按关键帧处理，省去逐块拷贝
+        full = area == (long long)width * height;
+    }
+
+    if (full)
+    {
+        SetKeyframe();
+        sinceKeyframe = 0;
+        keyframes++;
+    }
+    else
+    {
+        sinceKeyframe++;
+        deltaFrames++;
+        coverageSum += damage.coverage;
+    }
+    lastSceneFrame = sceneFrame;
+    lastWidth = width;
+    lastHeight = height;
+    return damage;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+#include "SceneState.h"
+
+// 帧缓冲坐标中的矩形（原点在左下角，与 glReadPixels 一致）
+struct DamageRect
+{
+    int x = 0, y = 0, w = 0, h = 0;
+};
+
+// 一帧相对上一个回读帧的变化区域
+struct FrameDamage
+{
+    bool keyframe = true;          // 整帧：周期性关键帧、相机或尺寸变化、找不到上一帧的快照
+    std::vector<DamageRect> rects; // 非关键帧时的脏分块（同一分块行中相邻的分块合并为一段）
+    double coverage = 1.0;         // 脏区域占整帧的比例
+};
+
+// 脏矩形跟踪：主线程记录最近的场景快照，回读某一帧时，用它与上一个回读帧的快照比较，
+// 把位置发生变化的物体在两份快照中的投影包围盒映射到固定大小的分块网格。
+// 回读的是离屏 FBO，ImGui 不会画进去，因此脏区域只来自场景快照。
+// 画面只由快照决定（着色不依赖时间），因此未被覆盖的分块与上一个回读帧逐像素相同。
+// 只在主线程使用。
+class DamageTracker
+{
+public:
+    static const int HistoryLength = 64;
+
+    // keyframeInterval：每隔多少个回读帧强制一次整帧；tileSize：分块边长（像素）
+    DamageTracker(int keyframeInterval, int tileSize);
+
+    // 记录主线程每帧发布的快照（渲染端落后时仍能找到它实际渲染的那一份）
+    void Record(const SceneState &state);
+    // 网格的局部包围盒；未登记的网格移动时按整帧处理。0 号内置立方体已登记
+    void SetMeshBounds(int mesh, const glm::vec3 &min, const glm::vec3 &max);
+    // 快照之外的画面变化（例如新驻留的上传纹理）：sceneFrame 之后一帧及更早的快照渲染的帧都按整帧处理
+    void Invalidate(uint64_t sceneFrame);
+
+    // 计算由快照 sceneFrame 渲染、尺寸为 width x height 的帧相对上一次 Compute 的帧的变化
+    const FrameDamage &Compute(uint64_t sceneFrame, int width, int height);
+
+    int GetTileSize() const { return tileSize; }
+    unsigned long long GetKeyframes() const { return keyframes; }
+    unsigned long long GetDeltaFrames() const { return deltaFrames; }
+    // 非关键帧的平均脏区域比例
+    double GetAverageCoverage() const { return deltaFrames ? coverageSum / deltaFrames : 0.0; }
+
+private:
+    struct MeshBounds
+    {
+        bool known = false;
+        glm::vec3 min{0.0f}, max{0.0f};
+    };
+
+    const SceneState *Find(uint64_t sceneFrame) const;
+    // 把物体的投影包围盒标记到分块网格；投影跨过近平面或网格未登记时返回 false
+    bool MarkObject(const SceneState &state, const SceneState::Object &object);
+    void MarkPixels(int x0, int y0, int x1, int y1);
+    void SetKeyframe();
+
+    int keyframeInterval;
+    int tileSize;
+    std::vector<MeshBounds> meshBounds;
+    SceneState history[HistoryLength];
+    uint64_t keyframeUntil = 0;
+
+    // 上一次 Compute 的帧
+    uint64_t lastSceneFrame = 0;
+    int lastWidth = 0, lastHeight = 0;
+    int sinceKeyframe = 0;
+
+    int tilesX = 0, tilesY = 0;
+    int width = 0, height = 0;
+    std::vector<unsigned char> dirty;
+    FrameDamage damage;
+
+    unsigned long long keyframes = 0;
+    unsigned long long deltaFrames = 0;
+    double coverageSum = 0.0;
+};
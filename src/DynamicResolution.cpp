@@ -0,0 +1,89 @@
+#include "DynamicResolution.h"
+#include <algorithm>
+#include <cmath>
+
+int DynamicResolution::Update(double frameMs)
+{
+    double budget = budgetMs.load();
+    int current = percent.load();
+    averageMs = averageMs > 0.0 ? averageMs * 0.8 + frameMs * 0.2 : frameMs;
+    sinceChange++;
+    if (ceilingHold > 0)
+        ceilingHold--;
+    if (budget != lastBudget)
+    {
+        lastBudget = budget;
+        ceilingHold = 0;
+        retryFrames = RetryFrames;
+    }
+
+    if (budget <= 0.0)
+    {
+        overFrames = underFrames = cooldown = 0;
+        if (current != MaxPercent)
+            SetPercent(MaxPercent);
+    }
+    else if (cooldown > 0)
+    {
+        cooldown--;
+    }
+    else if (averageMs > budget)
+    {
+        underFrames = 0;
+        if (++overFrames >= DownFrames && current > MinPercent)
+        {
+            // 按估计直接降到能满足预算（留 10% 余量）的档位，负载突增时不必逐档下降
+            double fit = current * std::sqrt(budget * 0.9 / averageMs);
+            int target = (int)std::floor(fit / StepPercent) * StepPercent;
+            // 刚升到的档位撑不住：说明估计偏乐观，下次等待加倍；否则是负载变化，等待恢复为初值
+            bool probeFailed = lastChangeUp && sinceChange < UpFrames * 2;
+            retryFrames = probeFailed ? std::min(retryFrames * 2, (int)MaxRetryFrames) : (int)RetryFrames;
+            ceilingPercent = current;
+            ceilingHold = retryFrames;
+            SetPercent(std::clamp(std::min(target, current - StepPercent), (int)MinPercent, (int)MaxPercent));
+        }
+    }
+    else
+    {
+        overFrames = 0;
+        double ratio = (double)(current + StepPercent) / current;
+        bool blocked = ceilingHold > 0 && current + StepPercent >= ceilingPercent;
+        if (current < MaxPercent && !blocked && averageMs * ratio * ratio < budget * 0.85)
+        {
+            if (++underFrames >= UpFrames)
+                SetPercent(current + StepPercent);
+        }
+        else
+        {
+            underFrames = 0;
+        }
+    }
+
+    current = percent.load();
+    uint64_t index = historyCount.load(std::memory_order_relaxed);
+    history[index % HistoryLength].store((unsigned char)current, std::memory_order_relaxed);
+    historyCount.store(index + 1, std::memory_order_release);
+    return current;
+}
+
+void DynamicResolution::SetPercent(int value)
+{
+    int previous = percent.load();
+    double ratio = (double)value / previous;
+    averageMs *= ratio * ratio;
+    lastChangeUp = value > previous;
+    sinceChange = 0;
+    percent.store(value);
+    overFrames = underFrames = 0;
+    cooldown = CooldownFrames;
+    changes++;
+}
+
+int DynamicResolution::GetHistory(float *values, int capacity) const
+{
+    uint64_t count = historyCount.load(std::memory_order_acquire);
+    int n = (int)std::min<uint64_t>(count, (uint64_t)std::min(capacity, (int)HistoryLength));
+    for (int i = 0; i < n; ++i)
+        values[i] = history[(count - n + i) % HistoryLength].load(std::memory_order_relaxed) / 100.0f;
+    return n;
+}
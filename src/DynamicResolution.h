@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// 动态分辨率：按 GPU 帧耗时相对预算调整内部渲染比例（50%~100%，步长 10%）。
+// 填充耗时近似与像素数成正比，比例 p 下的帧耗时按 (p / 当前比例)^2 估计。
+// 防止振荡：降档要求平滑帧耗时连续超出预算若干帧，升档要求升档后的估计耗时仍低于预算的 85% 且持续更久；
+// 每次换档后有一段冷却期，并把平滑值换算到新比例。
+// 估计不准时（例如有不随分辨率变化的固定开销）升档会再次超预算：降档时记住超预算的档位，
+// 之后一段时间内不再升到该档；刚升档就失败时等待时间加倍，稳定负载下换档次数随时间递减。预算变化时清除记录。
+// SetBudget 可在任意线程调用，Update 只在渲染线程调用；比例与历史可在任意线程读取
+class DynamicResolution
+{
+public:
+    static const int MinPercent = 50;
+    static const int MaxPercent = 100;
+    static const int StepPercent = 10;
+    static const int HistoryLength = 240;
+
+    // 帧耗时预算（毫秒），0 表示关闭（固定 100%）
+    void SetBudget(double ms) { budgetMs.store(ms); }
+    double GetBudget() const { return budgetMs.load(); }
+
+    // 记录一帧的渲染耗时，返回下一帧使用的比例（百分比）
+    int Update(double frameMs);
+    int GetPercent() const { return percent.load(); }
+    float GetScale() const { return percent.load() / 100.0f; }
+    // 按比例缩放尺寸（至少 1 像素）
+    static int Scale(int size, int percent) { return size * percent / 100 > 0 ? size * percent / 100 : 1; }
+
+    // 最近的比例历史，从旧到新写入 values（0~1），返回写入的个数
+    int GetHistory(float *values, int capacity) const;
+    // 换档次数
+    unsigned long long GetChanges() const { return changes.load(); }
+
+private:
+    static const int DownFrames = 8;  // 连续超预算多少帧后降档
+    static const int UpFrames = 45;   // 连续有余量多少帧后升档
+    static const int CooldownFrames = 15;
+    static const int RetryFrames = 120;     // 超预算的档位至少隔多少帧才再尝试
+    static const int MaxRetryFrames = 1920; // 反复失败时等待时间的上限
+
+    void SetPercent(int value);
+
+    std::atomic<double> budgetMs{0.0};
+    std::atomic<int> percent{MaxPercent};
+    std::atomic<unsigned long long> changes{0};
+
+    double averageMs = 0.0;
+    int overFrames = 0;
+    int underFrames = 0;
+    int cooldown = 0;
+
+    double lastBudget = 0.0;
+    int ceilingPercent = MaxPercent + StepPercent; // 最近超预算的档位，等待期内不升到该档及以上
+    int ceilingHold = 0;                           // 剩余等待帧数
+    int retryFrames = RetryFrames;                 // 下一次失败后的等待帧数
+    int sinceChange = 0;                           // 距上次换档的帧数
+    bool lastChangeUp = false;
+
+    std::atomic<unsigned char> history[HistoryLength] = {};
+    std::atomic<uint64_t> historyCount{0};
+};
@@ -0,0 +1,210 @@
+#include "FrameContainer.h"
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <new>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+FrameContainer::FrameContainer(const std::string &path, uint64_t frameCapacity, int maxWidth, int maxHeight)
+    : path(path)
+{
+    std::printf("帧容器仅支持 POSIX 平台，已忽略 %s\n", path.c_str());
+}
+
+FrameContainer::~FrameContainer()
+{
+}
+
+void FrameContainer::Write(const ReadbackFrame &frame)
+{
+}
+
+void FrameContainer::Close()
+{
+}
+
+void FrameContainer::LogSkipped(const char *reason, const ReadbackFrame &frame)
+{
+}
+
+#else
+
+FrameContainer::FrameContainer(const std::string &path, uint64_t frameCapacity, int maxWidth, int maxHeight)
+    : path(path)
+{
+    frameCapacity = frameCapacity < 1 ? 1 : frameCapacity;
+    uint64_t size = FrameFile::FileSize(frameCapacity, maxWidth, maxHeight);
+
+    fd = open(path.c_str(), O_CREAT | O_TRUNC | O_RDWR, 0644);
+    if (fd < 0)
+    {
+        std::perror(("无法创建帧容器 " + path).c_str());
+        return;
+    }
+    // 优先真正分配磁盘空间（之后写入不会因空间不足在映射上触发 SIGBUS），
+    // 文件系统不支持时退回稀疏文件
+    bool allocated = false;
+#ifdef __linux__
+    allocated = fallocate(fd, 0, 0, (off_t)size) == 0;
+#endif
+    if (!allocated && ftruncate(fd, (off_t)size) != 0)
+    {
+        std::perror("无法设置帧容器大小");
+        close(fd);
+        fd = -1;
+        return;
+    }
+    mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED)
+    {
+        std::perror("无法映射帧容器");
+        mapping = nullptr;
+        close(fd);
+        fd = -1;
+        return;
+    }
+    mappingSize = size;
+    // 槽位按写入顺序依次填充
+    madvise(mapping, mappingSize, MADV_SEQUENTIAL);
+
+    header = new (mapping) FrameFile::Header();
+    header->version = FrameFile::Version;
+    header->flags = FrameFile::FlagSorted;
+    header->frameCapacity = frameCapacity;
+    header->slotStride = FrameFile::SlotStride(maxWidth, maxHeight);
+    header->indexOffset = FrameFile::IndexOffset();
+    header->dataOffset = FrameFile::DataOffset(frameCapacity);
+    header->maxWidth = (uint32_t)maxWidth;
+    header->maxHeight = (uint32_t)maxHeight;
+    header->writerPid = (uint32_t)getpid();
+    header->frameCount.store(0, std::memory_order_relaxed);
+    index = (FrameFile::IndexEntry *)((unsigned char *)mapping + header->indexOffset);
+    // magic 最后写入：读者看到 magic 才认为头部有效
+    std::atomic_thread_fence(std::memory_order_release);
+    header->magic = FrameFile::Magic;
+
+    std::printf("帧容器: %s  容量: %llu 帧 x %.1f MB  最大尺寸: %dx%d  %s\n", path.c_str(), (unsigned long long)frameCapacity,
+                header->slotStride / (1024.0 * 1024.0), maxWidth, maxHeight, allocated ? "已预分配" : "稀疏文件");
+}
+
+FrameContainer::~FrameContainer()
+{
+    Close();
+}
+
+void FrameContainer::Write(const ReadbackFrame &frame)
+{
+    if (!header)
+        return;
+    uint64_t count = header->frameCount.load(std::memory_order_relaxed);
+    if (count >= header->frameCapacity)
+    {
+        LogSkipped("容量已满", frame);
+        chained = false;
+        return;
+    }
+    if (frame.width > (int)header->maxWidth || frame.height > (int)header->maxHeight)
+    {
+        LogSkipped("超出槽位尺寸", frame);
+        chained = false;
+        return;
+    }
+
+    uint64_t offset = header->dataOffset + header->slotStride * count;
+    unsigned char *slot = (unsigned char *)mapping + offset;
+    size_t bytes = frame.bytes;
+    uint32_t format = frame.format == ReadbackFormat::I420 ? FrameFile::I420TopDown : FrameFile::Rgba8BottomUp;
+
+    // 上一帧在容器中时，非关键帧只写脏分块；分块载荷不比整帧小时仍写整帧
+    size_t tileBytes = sizeof(FrameFile::TileHeader) + sizeof(FrameFile::TileRect) * frame.damageCount;
+    for (int i = 0; i < frame.damageCount; ++i)
+        tileBytes += (size_t)frame.damage[i].w * frame.damage[i].h * 4;
+    if (chained && !frame.keyframe && format == FrameFile::Rgba8BottomUp && tileBytes < bytes)
+    {
+        FrameFile::TileHeader tiles = {(uint32_t)frame.damageCount, 0};
+        std::memcpy(slot, &tiles, sizeof(tiles));
+        unsigned char *rects = slot + sizeof(tiles);
+        unsigned char *out = rects + sizeof(FrameFile::TileRect) * frame.damageCount;
+        size_t rowBytes = (size_t)frame.width * 4;
+        for (int i = 0; i < frame.damageCount; ++i)
+        {
+            const DamageRect &r = frame.damage[i];
+            FrameFile::TileRect rect = {r.x, r.y, r.w, r.h};
+            std::memcpy(rects + sizeof(rect) * i, &rect, sizeof(rect));
+            for (int y = r.y; y < r.y + r.h; ++y)
+            {
+                std::memcpy(out, frame.pixels + y * rowBytes + (size_t)r.x * 4, (size_t)r.w * 4);
+                out += (size_t)r.w * 4;
+            }
+        }
+        bytes = tileBytes;
+        format = FrameFile::Rgba8Tiles;
+        tileFrames++;
+    }
+    else
+    {
+        std::memcpy(slot, frame.pixels, bytes);
+    }
+    chained = format != FrameFile::I420TopDown;
+
+    if (count > 0 && frame.frameIndex <= lastFrameIndex)
+        header->flags &= ~FrameFile::FlagSorted;
+    lastFrameIndex = frame.frameIndex;
+
+    timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    FrameFile::IndexEntry &entry = index[count];
+    entry.frameIndex = frame.frameIndex;
+    entry.offset = offset;
+    entry.size = bytes;
+    entry.format = format;
+    entry.width = frame.width;
+    entry.height = frame.height;
+    entry.timestamp = now.tv_sec + now.tv_nsec * 1e-9;
+    // 像素与索引项先于计数对读者可见
+    header->frameCount.store(count + 1, std::memory_order_release);
+}
+
+void FrameContainer::Close()
+{
+    if (!header)
+        return;
+    uint64_t count = header->frameCount.load(std::memory_order_relaxed);
+    uint64_t used = header->dataOffset + header->slotStride * count;
+    header->complete = 1;
+    msync(mapping, mappingSize, MS_SYNC);
+    munmap(mapping, mappingSize);
+    mapping = nullptr;
+    header = nullptr;
+    index = nullptr;
+
+    // 归还未用到的预分配空间；索引区保持原容量，读者以 frameCount 为准
+    if (ftruncate(fd, (off_t)used) != 0)
+        std::perror("无法截断帧容器");
+    close(fd);
+    fd = -1;
+    writtenFrames = count;
+    fileBytes = used;
+    std::printf("帧容器结束  %s  写入: %llu 帧（其中分块帧 %llu）  跳过: %llu 帧  文件: %.1f MB\n", path.c_str(), writtenFrames, tileFrames,
+                skippedFrames, fileBytes / (1024.0 * 1024.0));
+}
+
+void FrameContainer::LogSkipped(const char *reason, const ReadbackFrame &frame)
+{
+    skippedFrames++;
+    auto now = std::chrono::steady_clock::now();
+    if (now - lastLog >= std::chrono::seconds(1))
+    {
+        lastLog = now;
+        std::printf("[帧容器] %s，帧 %llu (%dx%d) 未写入（累计 %llu）\n", reason, (unsigned long long)frame.frameIndex, frame.width,
+                    frame.height, skippedFrames);
+    }
+}
+
+#endif
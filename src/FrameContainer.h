@@ -0,0 +1,52 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include "FrameReadback.h"
+#include "FrameFile.h"
+
+// 帧容器：把回读到的帧写进一个预先分配并整体 mmap 的文件（布局见 FrameFile.h）。
+// 每帧只有一次写入映射的 memcpy，没有逐帧的 open/write/close 与新建 inode，
+// 头部索引记录每帧的位置，FrameContainerReader 与 frame_reader 工具可以随机访问任意帧。
+// 写入在主线程（回读回调）中进行；超过最大尺寸或容量用尽的帧不写入。
+// 回读带脏矩形时非关键帧只写入变化的分块（Rgba8Tiles），只有被触碰的页需要回写磁盘。
+class FrameContainer
+{
+public:
+    // frameCapacity 为最多容纳的帧数，文件按容量 x maxWidth x maxHeight 一次性分配
+    FrameContainer(const std::string &path, uint64_t frameCapacity, int maxWidth, int maxHeight);
+    ~FrameContainer();
+
+    bool IsOpen() const { return header != nullptr; }
+    const std::string &GetPath() const { return path; }
+
+    void Write(const ReadbackFrame &frame);
+    // 标记完成并把文件截断到已写入的部分；析构时自动调用
+    void Close();
+
+    unsigned long long GetWrittenFrames() const { return header ? header->frameCount.load(std::memory_order_relaxed) : writtenFrames; }
+    unsigned long long GetSkippedFrames() const { return skippedFrames; }
+    // 以分块形式写入的帧数
+    unsigned long long GetTileFrames() const { return tileFrames; }
+    unsigned long long GetFileBytes() const { return fileBytes; }
+
+private:
+    void LogSkipped(const char *reason, const ReadbackFrame &frame);
+
+    std::string path;
+    int fd = -1;
+    void *mapping = nullptr;
+    size_t mappingSize = 0;
+    FrameFile::Header *header = nullptr;
+    FrameFile::IndexEntry *index = nullptr;
+
+    uint64_t lastFrameIndex = 0;
+    // 上一个交付的帧已写入容器，下一帧可以只写脏分块
+    bool chained = false;
+    unsigned long long tileFrames = 0;
+    unsigned long long writtenFrames = 0;
+    unsigned long long skippedFrames = 0;
+    unsigned long long fileBytes = 0;
+    std::chrono::steady_clock::time_point lastLog;
+};
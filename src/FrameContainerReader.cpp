@@ -0,0 +1,178 @@
+#include "FrameContainerReader.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+FrameContainerReader::~FrameContainerReader()
+{
+    Close();
+}
+
+#ifdef _WIN32
+
+bool FrameContainerReader::Open(const std::string &path)
+{
+    return false;
+}
+
+void FrameContainerReader::Close()
+{
+}
+
+#else
+
+bool FrameContainerReader::Open(const std::string &path)
+{
+    Close();
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(FrameFile::Header))
+    {
+        close(fd);
+        return false;
+    }
+    void *base = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED)
+        return false;
+
+    const FrameFile::Header *h = (const FrameFile::Header *)base;
+    if (h->magic != FrameFile::Magic || h->version != FrameFile::Version ||
+        h->indexOffset + sizeof(FrameFile::IndexEntry) * h->frameCapacity > (uint64_t)st.st_size)
+    {
+        munmap(base, (size_t)st.st_size);
+        return false;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    // 随机访问：不要让内核按顺序预读大量用不到的像素
+    madvise(base, (size_t)st.st_size, MADV_RANDOM);
+    mapping = base;
+    mappingSize = (size_t)st.st_size;
+    header = h;
+    index = (const FrameFile::IndexEntry *)((const unsigned char *)base + h->indexOffset);
+    return true;
+}
+
+void FrameContainerReader::Close()
+{
+    if (mapping)
+        munmap(mapping, mappingSize);
+    mapping = nullptr;
+    mappingSize = 0;
+    header = nullptr;
+    index = nullptr;
+}
+
+#endif
+
+uint64_t FrameContainerReader::GetFrameCount() const
+{
+    if (!header)
+        return 0;
+    // 只计算完全落在映射范围内的帧（写者可能在打开之后继续写入）
+    uint64_t count = std::min(header->frameCount.load(std::memory_order_acquire), header->frameCapacity);
+    if (header->slotStride > 0 && mappingSize > header->dataOffset)
+        count = std::min<uint64_t>(count, (mappingSize - header->dataOffset) / header->slotStride);
+    else
+        count = 0;
+    return count;
+}
+
+bool FrameContainerReader::GetFrame(uint64_t ordinal, ContainerFrame &frame) const
+{
+    if (ordinal >= GetFrameCount())
+        return false;
+    const FrameFile::IndexEntry &entry = index[ordinal];
+    if (entry.offset + entry.size > mappingSize)
+        return false;
+    frame.pixels = (const unsigned char *)mapping + entry.offset;
+    frame.frameIndex = entry.frameIndex;
+    frame.ordinal = ordinal;
+    frame.size = entry.size;
+    frame.format = entry.format;
+    frame.width = entry.width;
+    frame.height = entry.height;
+    frame.timestamp = entry.timestamp;
+    return true;
+}
+
+bool FrameContainerReader::FindFrame(uint64_t frameIndex, ContainerFrame &frame) const
+{
+    uint64_t count = GetFrameCount();
+    if (header && (header->flags & FrameFile::FlagSorted))
+    {
+        const FrameFile::IndexEntry *it = std::lower_bound(index, index + count, frameIndex,
+            [](const FrameFile::IndexEntry &entry, uint64_t value) { return entry.frameIndex < value; });
+        return it != index + count && it->frameIndex == frameIndex && GetFrame(it - index, frame);
+    }
+    for (uint64_t i = 0; i < count; ++i)
+    {
+        if (index[i].frameIndex == frameIndex)
+            return GetFrame(i, frame);
+    }
+    return false;
+}
+
+// 把一帧分块叠加到整帧 pixels 上；载荷越界或尺寸不符时返回 false
+static bool ApplyTiles(const ContainerFrame &frame, std::vector<unsigned char> &pixels, int width, int height)
+{
+    if (frame.width != width || frame.height != height || frame.size < sizeof(FrameFile::TileHeader))
+        return false;
+    FrameFile::TileHeader tiles;
+    std::memcpy(&tiles, frame.pixels, sizeof(tiles));
+    uint64_t offset = sizeof(tiles) + (uint64_t)sizeof(FrameFile::TileRect) * tiles.rectCount;
+    if (offset > frame.size)
+        return false;
+    size_t rowBytes = (size_t)width * 4;
+    for (uint32_t i = 0; i < tiles.rectCount; ++i)
+    {
+        FrameFile::TileRect r;
+        std::memcpy(&r, frame.pixels + sizeof(tiles) + sizeof(r) * i, sizeof(r));
+        if (r.x < 0 || r.y < 0 || r.w < 0 || r.h < 0 || r.x + r.w > width || r.y + r.h > height ||
+            offset + (uint64_t)r.w * r.h * 4 > frame.size)
+            return false;
+        for (int y = r.y; y < r.y + r.h; ++y)
+        {
+            std::memcpy(&pixels[y * rowBytes + (size_t)r.x * 4], frame.pixels + offset, (size_t)r.w * 4);
+            offset += (size_t)r.w * 4;
+        }
+    }
+    return true;
+}
+
+bool FrameContainerReader::Reconstruct(ContainerFrame &frame, std::vector<unsigned char> &pixels) const
+{
+    if (frame.format != FrameFile::Rgba8Tiles)
+        return true;
+
+    // 向前找到最近的整帧
+    ContainerFrame base;
+    uint64_t start = frame.ordinal;
+    do
+    {
+        if (start == 0 || !GetFrame(--start, base))
+            return false;
+    } while (base.format == FrameFile::Rgba8Tiles);
+    if (base.format != FrameFile::Rgba8BottomUp || base.size != (uint64_t)base.width * base.height * 4)
+        return false;
+
+    pixels.assign(base.pixels, base.pixels + base.size);
+    for (uint64_t i = start + 1; i <= frame.ordinal; ++i)
+    {
+        ContainerFrame tiles;
+        if (!GetFrame(i, tiles) || !ApplyTiles(tiles, pixels, base.width, base.height))
+            return false;
+    }
+    frame.pixels = pixels.data();
+    frame.size = pixels.size();
+    frame.format = FrameFile::Rgba8BottomUp;
+    return true;
+}
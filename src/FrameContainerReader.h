@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "FrameFile.h"
+
+// 容器中一帧的只读视图：pixels 直接指向文件映射，不做拷贝
+struct ContainerFrame
+{
+    const unsigned char *pixels = nullptr; // 格式见 format
+    uint64_t frameIndex = 0;
+    uint64_t ordinal = 0; // 写入顺序
+    uint64_t size = 0;
+    uint32_t format = 0;
+    int width = 0, height = 0;
+    double timestamp = 0.0; // 写入时刻（CLOCK_REALTIME 秒）
+};
+
+// 帧容器的读端，不依赖 OpenGL。整个文件只读映射，按需缺页，打开与定位都不读取像素数据。
+// 也可以打开写者仍在写入的容器（只能看到打开时映射范围内已写入的帧）。
+class FrameContainerReader
+{
+public:
+    FrameContainerReader() = default;
+    ~FrameContainerReader();
+    FrameContainerReader(const FrameContainerReader &) = delete;
+    FrameContainerReader &operator=(const FrameContainerReader &) = delete;
+
+    bool Open(const std::string &path);
+    void Close();
+    bool IsOpen() const { return header != nullptr; }
+
+    uint64_t GetFrameCount() const;
+    const FrameFile::Header *GetHeader() const { return header; }
+    bool IsComplete() const { return header && header->complete != 0; }
+
+    // 按写入顺序取第 ordinal 帧
+    bool GetFrame(uint64_t ordinal, ContainerFrame &frame) const;
+    // 按渲染帧序号查找；帧序号递增时二分查找，否则线性查找
+    bool FindFrame(uint64_t frameIndex, ContainerFrame &frame) const;
+    // 还原分块帧（Rgba8Tiles）：从之前最近的整帧开始依次叠加分块，结果写入 pixels，
+    // frame 改为指向 pixels 的 Rgba8BottomUp 视图。整帧直接返回，不做拷贝
+    bool Reconstruct(ContainerFrame &frame, std::vector<unsigned char> &pixels) const;
+
+private:
+    void *mapping = nullptr;
+    size_t mappingSize = 0;
+    const FrameFile::Header *header = nullptr;
+    const FrameFile::IndexEntry *index = nullptr;
+};
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// 帧容器文件的布局（FrameContainer 写、FrameContainerReader 读，两边必须一致）。
+//
+// [Header][IndexEntry x frameCapacity][对齐到页][slot 0 像素][slot 1 像素]...
+// 文件创建时按容量一次性分配并整体 mmap，第 i 个写入的帧放在第 i 个槽位，索引项 i 记录它的
+// 帧序号、偏移、大小、格式与时间戳。读者只需读头部与索引即可定位任意帧，不需要扫描文件。
+// 写者先写像素与索引项，再以 release 语义增加 frameCount，因此正在写入的文件也可以被读取。
+// 正常结束时写者把 complete 置 1，并把文件截断到最后一个已写入的槽位。
+namespace FrameFile
+{
+    const uint32_t Magic = 0x4352464f; // "OFRC"
+    const uint32_t Version = 1;
+    const size_t PageSize = 4096;
+
+    // 槽位中的像素格式
+    enum PixelFormat : uint32_t
+    {
+        Rgba8BottomUp = 1, // RGBA8，行序自底向上（OpenGL 回读约定），紧密排列
+        I420TopDown = 2,   // GPU 端转换的 YUV 4:2:0 平面（Y、U、V 依次紧密排列），行序自顶向下
+        Rgba8Tiles = 3     // 相对上一帧的脏分块（TileHeader + TileRect x rectCount + 各矩形像素），见下
+    };
+
+    // Rgba8Tiles 帧的载荷：矩形按顺序排列，每个矩形的 RGBA8 像素逐行自底向上紧密排列，依次跟在矩形表之后。
+    // 还原一帧需要从它之前最近的整帧（Rgba8BottomUp）开始依次叠加之后的分块帧
+    struct TileHeader
+    {
+        uint32_t rectCount;
+        uint32_t reserved;
+    };
+
+    struct TileRect
+    {
+        int32_t x, y, w, h;
+    };
+
+    // Header::flags
+    const uint32_t FlagSorted = 1; // 帧序号随写入顺序严格递增，可按帧序号二分查找
+
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t flags;
+        uint32_t complete; // 写者正常关闭后为 1
+        uint64_t frameCapacity;
+        uint64_t slotStride; // 每个槽位占用的字节数（页对齐）
+        uint64_t indexOffset;
+        uint64_t dataOffset; // 第 0 个槽位的偏移（页对齐）
+        uint32_t maxWidth, maxHeight;
+        uint32_t writerPid;
+        uint32_t reserved;
+        std::atomic<uint64_t> frameCount; // 已写入的帧数
+    };
+
+    struct IndexEntry
+    {
+        uint64_t frameIndex; // 渲染帧序号
+        uint64_t offset;     // 像素在文件中的偏移
+        uint64_t size;       // 像素字节数
+        uint32_t format;     // PixelFormat
+        int32_t width, height;
+        uint32_t reserved;
+        double timestamp; // 写入时刻（CLOCK_REALTIME 秒）
+    };
+
+    static_assert(sizeof(IndexEntry) == 48, "索引项布局不应随编译器变化");
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "跨进程读取需要无锁的 64 位原子操作");
+
+    inline uint64_t AlignPage(uint64_t bytes) { return (bytes + PageSize - 1) / PageSize * PageSize; }
+    inline uint64_t SlotStride(uint32_t maxWidth, uint32_t maxHeight) { return AlignPage((uint64_t)maxWidth * maxHeight * 4); }
+    inline uint64_t IndexOffset() { return (sizeof(Header) + 63) / 64 * 64; }
+    inline uint64_t DataOffset(uint64_t frameCapacity) { return AlignPage(IndexOffset() + sizeof(IndexEntry) * frameCapacity); }
+    inline uint64_t FileSize(uint64_t frameCapacity, uint32_t maxWidth, uint32_t maxHeight)
+    {
+        return DataOffset(frameCapacity) + SlotStride(maxWidth, maxHeight) * frameCapacity;
+    }
+}
@@ -0,0 +1,104 @@
+#include "FrameGovernor.h"
+#include "FrameQueue.h"
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+const char *PacingModeName(PacingMode mode)
+{
+    switch (mode)
+    {
+    case PacingMode::Unlimited:
+        return "unlimited";
+    case PacingMode::FpsCap:
+        return "cap";
+    case PacingMode::OnDemand:
+        return "ondemand";
+    case PacingMode::Hybrid:
+        return "hybrid";
+    }
+    return "unknown";
+}
+
+bool ParsePacingMode(const char *name, PacingMode &mode)
+{
+    for (PacingMode m : {PacingMode::Unlimited, PacingMode::FpsCap, PacingMode::OnDemand, PacingMode::Hybrid})
+    {
+        if (std::strcmp(name, PacingModeName(m)) == 0)
+        {
+            mode = m;
+            return true;
+        }
+    }
+    return false;
+}
+
+void FrameGovernor::Pace(FrameQueue *queue, const std::function<bool()> &keepWaiting)
+{
+    auto start = clock::now();
+    if (windowStart == clock::time_point())
+        windowStart = start;
+
+    PacingMode current = mode.load();
+    if (current == PacingMode::OnDemand)
+    {
+        // 上一帧还没被取走就不渲染新帧，等待期间完全让出 CPU
+        while (queue && queue->GetOccupancy() > 0 && keepWaiting())
+            queue->WaitForConsumer(std::chrono::milliseconds(2));
+    }
+    else if (current == PacingMode::FpsCap || current == PacingMode::Hybrid)
+    {
+        double fps = std::max(1.0, targetFps.load());
+        auto period = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(1.0 / fps));
+
+        // 落后超过一帧时不追赶，避免突发连续渲染
+        if (nextDeadline == clock::time_point() || start - nextDeadline > period)
+            nextDeadline = start;
+        WaitUntil(nextDeadline, current == PacingMode::Hybrid);
+        nextDeadline += period;
+    }
+
+    AccountIdle(clock::now() - start);
+}
+
+void FrameGovernor::Reset()
+{
+    nextDeadline = clock::time_point();
+    windowStart = clock::time_point();
+    idleInWindow = clock::duration(0);
+}
+
+void FrameGovernor::WaitUntil(clock::time_point deadline, bool hybrid)
+{
+    if (!hybrid)
+    {
+        std::this_thread::sleep_until(deadline);
+        return;
+    }
+
+    // 先 sleep 到截止时间前的余量处，再自旋到截止时间
+    auto margin = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double, std::micro>(spinMarginUs));
+    auto wakeTarget = deadline - margin;
+    if (clock::now() < wakeTarget)
+    {
+        std::this_thread::sleep_until(wakeTarget);
+        // 根据实际超时修正余量：超时则加大余量，过早醒来则缓慢收敛
+        double overshootUs = std::chrono::duration<double, std::micro>(clock::now() - wakeTarget).count();
+        spinMarginUs = std::clamp(spinMarginUs * 0.9 + overshootUs * 1.5 * 0.1, 100.0, 4000.0);
+    }
+    while (clock::now() < deadline)
+        std::this_thread::yield();
+}
+
+void FrameGovernor::AccountIdle(clock::duration waited)
+{
+    idleInWindow += waited;
+    auto now = clock::now();
+    std::chrono::duration<double> window = now - windowStart;
+    if (window.count() >= 1.0)
+    {
+        idleRatio.store(std::chrono::duration<double>(idleInWindow).count() / window.count());
+        idleInWindow = clock::duration(0);
+        windowStart = now;
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+
+class FrameQueue;
+
+// 渲染节奏模式
+enum class PacingMode
+{
+    Unlimited, // 不限速，全速渲染
+    FpsCap,    // 目标帧率上限，使用系统 sleep 等待
+    OnDemand,  // 按需渲染：消费者取走上一帧后才渲染下一帧
+    Hybrid     // 目标帧率上限，先 sleep 再自旋，精确命中截止时间
+};
+
+const char *PacingModeName(PacingMode mode);
+bool ParsePacingMode(const char *name, PacingMode &mode);
+
+// 帧调速器：在 Worker 每帧开始前决定是否/何时渲染下一帧
+// 设置接口可在任意线程调用，Pace() 只在渲染线程调用
+class FrameGovernor
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+    void SetMode(PacingMode mode) { this->mode.store(mode); }
+    PacingMode GetMode() const { return mode.load(); }
+    void SetTargetFps(double fps) { targetFps.store(fps); }
+    double GetTargetFps() const { return targetFps.load(); }
+
+    // 阻塞到下一帧应当开始的时刻；keepWaiting 返回 false 时立即退出（暂停/停止）
+    void Pace(FrameQueue *queue, const std::function<bool()> &keepWaiting);
+    // 重置截止时间与统计窗口（例如从暂停中恢复后）
+    void Reset();
+
+    // 渲染线程用于等待的时间占比（0~1），每秒更新
+    double GetIdleRatio() const { return idleRatio.load(); }
+
+private:
+    void WaitUntil(clock::time_point deadline, bool hybrid);
+    void AccountIdle(clock::duration waited);
+
+    std::atomic<PacingMode> mode{PacingMode::Unlimited};
+    std::atomic<double> targetFps{60.0};
+
+    clock::time_point nextDeadline;
+    // 混合计时器：按观测到的 sleep 超时动态调整自旋余量
+    double spinMarginUs = 1000.0;
+
+    clock::time_point windowStart;
+    clock::duration idleInWindow{0};
+    std::atomic<double> idleRatio{0.0};
+};
@@ -0,0 +1,253 @@
+#include "FrameQueue.h"
+#include <algorithm>
+#include <cstring>
+
+const char *PresentModeName(PresentMode mode)
+{
+    switch (mode)
+    {
+    case PresentMode::Fifo:
+        return "fifo";
+    case PresentMode::Mailbox:
+        return "mailbox";
+    case PresentMode::Discard:
+        return "discard";
+    }
+    return "unknown";
+}
+
+bool ParsePresentMode(const char *name, PresentMode &mode)
+{
+    for (PresentMode m : {PresentMode::Fifo, PresentMode::Mailbox, PresentMode::Discard})
+    {
+        if (std::strcmp(name, PresentModeName(m)) == 0)
+        {
+            mode = m;
+            return true;
+        }
+    }
+    return false;
+}
+
+FrameQueue::FrameQueue(int depth, const FramebufferDesc &desc, PresentMode mode, RenderTargetPool *targets)
+    : depth(std::clamp(depth, MinDepth, MaxDepth)), targets(targets), presentMode(mode)
+{
+    // 消费者采样整张纹理，槽位的分配尺寸必须与帧尺寸一致
+    slots.reset(new Slot[this->depth]);
+    for (int i = 0; i < this->depth; ++i)
+        slots[i].fbo = targets->Acquire(desc);
+}
+
+FrameQueue::~FrameQueue()
+{
+    // 此时两个线程都已停止使用队列，遗留的栅栏全部回收
+    for (int i = 0; i < depth; ++i)
+    {
+        // 目标归还到池中后会被新队列复用：先让 GPU 等待消费者对它的采样结束
+        if (GLsync release = slots[i].releaseFence.exchange(nullptr))
+        {
+            glWaitSync(release, 0, GL_TIMEOUT_IGNORED);
+            glDeleteSync(release);
+        }
+        DeleteFence(slots[i].readyFence);
+        DeleteFence(slots[i].releaseFence);
+        targets->Release(slots[i].fbo);
+    }
+}
+
+void FrameQueue::DeleteFence(std::atomic<GLsync> &fence)
+{
+    GLsync sync = fence.exchange(nullptr);
+    if (sync)
+        glDeleteSync(sync);
+}
+
+int FrameQueue::FindReady(bool newest, uint64_t &tag) const
+{
+    int found = -1;
+    for (int i = 0; i < depth; ++i)
+    {
+        uint64_t t = slots[i].tag.load(std::memory_order_acquire);
+        if (StateOf(t) != Ready)
+            continue;
+        if (found < 0 || (newest ? FrameOf(t) > FrameOf(tag) : FrameOf(t) < FrameOf(tag)))
+        {
+            found = i;
+            tag = t;
+        }
+    }
+    return found;
+}
+
+int FrameQueue::GetOccupancy() const
+{
+    int count = 0;
+    for (int i = 0; i < depth; ++i)
+        if (StateOf(slots[i].tag.load(std::memory_order_relaxed)) == Ready)
+            count++;
+    return count;
+}
+
+int FrameQueue::AcquireRenderSlot()
+{
+    for (int i = 0; i < depth; ++i)
+    {
+        Slot &slot = slots[i];
+        uint64_t tag = slot.tag.load(std::memory_order_acquire);
+        if (StateOf(tag) != Free)
+            continue;
+        if (!slot.tag.compare_exchange_strong(tag, MakeTag(FrameOf(tag), Rendering), std::memory_order_acq_rel))
+            continue;
+
+        // 消费者可能仍在采样该纹理：让 GPU 在写入前等待释放栅栏，CPU 不阻塞
+        GLsync release = slot.releaseFence.exchange(nullptr);
+        if (release)
+        {
+            glWaitSync(release, 0, GL_TIMEOUT_IGNORED);
+            glDeleteSync(release);
+        }
+        return i;
+    }
+
+    // 没有空闲槽位：FIFO 等待消费者，其余模式回收最旧的未消费帧
+    if (presentMode.load() == PresentMode::Fifo)
+        return -1;
+
+    // 至少留下一个就绪帧给消费者：深度为 2 时一个槽位在呈现、另一个就绪，
+    // 若把唯一的就绪帧抢回来重画，消费者几乎永远等不到它的栅栏完成
+    uint64_t tag = 0;
+    int oldest = FindReady(false, tag);
+    while (oldest >= 0 && GetOccupancy() > 1)
+    {
+        if (slots[oldest].tag.compare_exchange_strong(tag, MakeTag(FrameOf(tag), Rendering), std::memory_order_acq_rel))
+        {
+            // 同一上下文内命令按序执行，无需等待旧的就绪栅栏
+            DeleteFence(slots[oldest].readyFence);
+            droppedFrames++;
+            return oldest;
+        }
+        oldest = FindReady(false, tag);
+    }
+    return -1;
+}
+
+int FrameQueue::DiscardReady()
+{
+    int discarded = 0;
+    for (int i = 0; i < depth; ++i)
+    {
+        uint64_t tag = slots[i].tag.load(std::memory_order_acquire);
+        if (StateOf(tag) != Ready)
+            continue;
+        if (RetireReady(i, tag))
+            discarded++;
+    }
+    return discarded;
+}
+
+bool FrameQueue::RetireReady(int slot, uint64_t tag)
+{
+    Slot &s = slots[slot];
+    if (!s.tag.compare_exchange_strong(tag, MakeTag(FrameOf(tag), Retiring), std::memory_order_acq_rel))
+        return false;
+    DeleteFence(s.readyFence);
+    s.tag.store(MakeTag(FrameOf(tag), Free), std::memory_order_release);
+    droppedFrames++;
+    return true;
+}
+
+void FrameQueue::WaitForConsumer(std::chrono::microseconds timeout)
+{
+    std::unique_lock<std::mutex> lock(consumeMutex);
+    consumeCv.wait_for(lock, timeout, [this]() { return presentedFrames.load() != consumeSeen; });
+    consumeSeen = presentedFrames.load();
+}
+
+void FrameQueue::SubmitRenderSlot(int slot, GLsync fence, uint64_t frameIndex, uint64_t sceneFrame)
+{
+    slots[slot].sceneFrame = sceneFrame;
+    slots[slot].readyFence.store(fence);
+    slots[slot].tag.store(MakeTag(frameIndex, Ready), std::memory_order_release);
+}
+
+bool FrameQueue::ClaimReady(int slot, uint64_t tag)
+{
+    // 轮询就绪栅栏（不阻塞）；GPU 尚未完成则退还槽位，继续呈现上一帧
+    GLsync fence = slots[slot].readyFence.load();
+    if (fence)
+    {
+        GLint status = GL_UNSIGNALED;
+        glGetSynciv(fence, GL_SYNC_STATUS, 1, nullptr, &status);
+        if (status != GL_SIGNALED)
+        {
+            slots[slot].tag.store(tag, std::memory_order_release);
+            return false;
+        }
+        DeleteFence(slots[slot].readyFence);
+    }
+    return true;
+}
+
+int FrameQueue::TryAcquirePresentSlot()
+{
+    bool latestWins = presentMode.load() == PresentMode::Mailbox;
+
+    uint64_t tag = 0;
+    int slot = FindReady(latestWins, tag);
+    while (slot >= 0 && !slots[slot].tag.compare_exchange_strong(tag, MakeTag(FrameOf(tag), Presenting), std::memory_order_acq_rel))
+        slot = FindReady(latestWins, tag);
+    if (slot < 0 || !ClaimReady(slot, tag))
+        return -1;
+
+    if (latestWins)
+    {
+        // 最新帧优先：丢弃所有更旧的就绪帧
+        for (int i = 0; i < depth; ++i)
+        {
+            uint64_t old = slots[i].tag.load(std::memory_order_acquire);
+            if (StateOf(old) != Ready || FrameOf(old) > FrameOf(tag))
+                continue;
+            RetireReady(i, old);
+        }
+    }
+
+    SetPresenting(slot);
+    return slot;
+}
+
+int FrameQueue::TryAcquirePresentSlot(uint64_t frameIndex)
+{
+    for (int i = 0; i < depth; ++i)
+    {
+        uint64_t tag = MakeTag(frameIndex, Ready);
+        if (!slots[i].tag.compare_exchange_strong(tag, MakeTag(frameIndex, Presenting), std::memory_order_acq_rel))
+            continue;
+        if (!ClaimReady(i, tag))
+            return -1;
+        SetPresenting(i);
+        return i;
+    }
+    return -1;
+}
+
+void FrameQueue::ReleasePresentSlot()
+{
+    int previous = presenting.exchange(-1);
+    if (previous < 0)
+        return;
+
+    // 先前提交的采样命令之后插入释放栅栏，再归还给生产者
+    Slot &prev = slots[previous];
+    prev.releaseFence.store(glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+    glFlush();
+    uint64_t prevTag = prev.tag.load(std::memory_order_relaxed);
+    prev.tag.store(MakeTag(FrameOf(prevTag), Free), std::memory_order_release);
+}
+
+void FrameQueue::SetPresenting(int slot)
+{
+    ReleasePresentSlot();
+    presenting.store(slot);
+    presentedFrames++;
+    consumeCv.notify_one();
+}
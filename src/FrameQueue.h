@@ -0,0 +1,126 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include "RenderTargetPool.h"
+
+// 呈现模式：决定队列满或有多帧就绪时如何取舍
+enum class PresentMode
+{
+    Fifo,    // 按顺序呈现；队列满时生产者等待
+    Mailbox, // 只呈现最新帧；更旧的就绪帧被丢弃
+    Discard  // 按顺序呈现；队列满时丢弃最旧的未消费帧
+};
+
+const char *PresentModeName(PresentMode mode);
+bool ParsePresentMode(const char *name, PresentMode &mode);
+
+// 类似交换链的 N 深度渲染队列
+// 生产者（Worker 线程）向空闲槽位渲染，消费者（主线程）按呈现模式取出就绪槽位
+// 所有 Framebuffer 从生产者的渲染目标池取得并归还，必须在生产者上下文中进行，纹理通过共享上下文对消费者可见
+//
+// 槽位所有权协议（无锁）：
+//   Free --生产者--> Rendering --提交 + 就绪栅栏--> Ready --消费者--> Presenting
+//   Presenting --下一帧被取出时插入释放栅栏--> Free
+//   Ready --消费者丢弃--> Retiring --删除就绪栅栏--> Free
+// 每个槽位的状态与帧序号打包在同一个原子字中，CAS 即可完成所有权交接且不存在 ABA 问题。
+// 生产者在复用槽位前对释放栅栏调用 glWaitSync（GPU 端等待），消费者只轮询就绪栅栏状态，
+// 两个线程都不会在热路径上调用阻塞的 glClientWaitSync。
+class FrameQueue
+{
+public:
+    static const int MinDepth = 2;
+    static const int MaxDepth = 8;
+
+    // 每个槽位按 desc 从 targets 取得一个渲染目标
+    FrameQueue(int depth, const FramebufferDesc &desc, PresentMode mode, RenderTargetPool *targets);
+    ~FrameQueue();
+
+    // --- 生产者接口 ---
+    // 获取一个可写入的槽位；FIFO 模式下队列已满时返回 -1
+    int AcquireRenderSlot();
+    // 提交渲染完成的槽位，fence 必须已在生产者上下文中 flush
+    // frameIndex 由生产者分配，须单调递增（AFR 模式下按步长跳跃）；sceneFrame 为渲染所用快照的帧号
+    void SubmitRenderSlot(int slot, GLsync fence, uint64_t frameIndex, uint64_t sceneFrame = 0);
+    Framebuffer *GetFramebuffer(int slot) const { return slots[slot].fbo; }
+    // 丢弃所有尚未被消费的就绪帧，返回丢弃数量
+    int DiscardReady();
+    // 等待消费者取走一帧或超时；仅用于生产者空闲时让出 CPU，不参与槽位交接
+    void WaitForConsumer(std::chrono::microseconds timeout);
+
+    // --- 消费者接口 ---
+    // 非阻塞地取出下一帧；无就绪帧或 GPU 尚未完成时返回 -1
+    // 成功时上一次呈现的槽位会附带释放栅栏归还给生产者
+    int TryAcquirePresentSlot();
+    // 只取出指定帧序号的就绪帧（用于多队列按帧序号严格呈现）
+    int TryAcquirePresentSlot(uint64_t frameIndex);
+    // 主动归还当前呈现的槽位（插入释放栅栏），呈现源切换到其他队列时使用
+    void ReleasePresentSlot();
+    unsigned int GetTextureID(int slot) const { return slots[slot].fbo->GetTextureID(); }
+    uint64_t GetFrameIndex(int slot) const { return FrameOf(slots[slot].tag.load()); }
+    // 槽位中的帧由哪一份场景快照渲染（只在消费者持有该槽位时有效）
+    uint64_t GetSceneFrame(int slot) const { return slots[slot].sceneFrame; }
+    int GetPresentSlot() const { return presenting.load(); }
+
+    void SetPresentMode(PresentMode mode) { presentMode.store(mode); }
+    PresentMode GetPresentMode() const { return presentMode.load(); }
+    int GetDepth() const { return depth; }
+
+    // --- 统计 ---
+    int GetOccupancy() const;
+    unsigned long long GetDroppedFrames() const { return droppedFrames.load(); }
+    unsigned long long GetPresentedFrames() const { return presentedFrames.load(); }
+
+private:
+    enum SlotState : uint64_t
+    {
+        Free = 0,
+        Rendering = 1,
+        Ready = 2,
+        Presenting = 3,
+        Retiring = 4 // 消费者丢弃就绪帧时的中间态：栅栏回收完毕才发布为 Free
+    };
+
+    static uint64_t MakeTag(uint64_t frame, SlotState state) { return (frame << 3) | state; }
+    static SlotState StateOf(uint64_t tag) { return (SlotState)(tag & 7); }
+    static uint64_t FrameOf(uint64_t tag) { return tag >> 3; }
+
+    struct Slot
+    {
+        Framebuffer *fbo = nullptr;
+        std::atomic<uint64_t> tag{0};
+        std::atomic<GLsync> readyFence{nullptr};   // 生产者插入，标记渲染完成
+        std::atomic<GLsync> releaseFence{nullptr}; // 消费者插入，标记采样完成
+        uint64_t sceneFrame = 0; // 生产者在发布 Ready 之前写入，随 tag 的 release/acquire 对消费者可见
+    };
+
+    // 查找处于 Ready 状态、帧序号最小（或最大）的槽位，返回其 tag
+    int FindReady(bool newest, uint64_t &tag) const;
+    // 检查已 CAS 到 Presenting 的槽位的就绪栅栏；GPU 未完成时退还为 Ready
+    bool ClaimReady(int slot, uint64_t tag);
+    // 消费者丢弃一个就绪帧：先 CAS 到 Retiring 独占槽位，删除就绪栅栏后再发布为 Free
+    // 槽位一旦发布为 Free 就可能被生产者重新占用，之后不能再碰它的 readyFence
+    bool RetireReady(int slot, uint64_t tag);
+    // 切换当前呈现槽位，并为上一个槽位插入释放栅栏
+    void SetPresenting(int slot);
+    void DeleteFence(std::atomic<GLsync> &fence);
+
+    int depth;
+    std::unique_ptr<Slot[]> slots;
+    RenderTargetPool *targets;
+
+    std::atomic<PresentMode> presentMode;
+    std::atomic<int> presenting{-1};
+    std::atomic<unsigned long long> droppedFrames{0};
+    std::atomic<unsigned long long> presentedFrames{0};
+
+    // 消费通知（生产者空闲等待用）
+    std::mutex consumeMutex;
+    std::condition_variable consumeCv;
+    unsigned long long consumeSeen = 0;
+};
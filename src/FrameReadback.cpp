@@ -0,0 +1,307 @@
+#include "FrameReadback.h"
+#include <algorithm>
+#include <cstring>
+
+FrameReadback::FrameReadback(int depth, Callback callback, YuvMatrix matrix, YuvRange range)
+    : depth(std::clamp(depth, MinDepth, MaxDepth)), callback(std::move(callback))
+{
+    slots.reset(new Slot[this->depth]);
+    for (int i = 0; i < this->depth; ++i)
+        glGenBuffers(1, &slots[i].pbo);
+    // FBO 不在上下文间共享：回读使用本上下文自己的 FBO 挂接共享纹理
+    glGenFramebuffers(1, &readFbo);
+    if (matrix != YuvMatrix::None)
+        converter = new YuvConverter(matrix, range);
+}
+
+FrameReadback::~FrameReadback()
+{
+    for (int i = 0; i < depth; ++i)
+    {
+        if (slots[i].fence)
+            glDeleteSync(slots[i].fence);
+        glDeleteBuffers(1, &slots[i].pbo);
+    }
+    glDeleteFramebuffers(1, &readFbo);
+    delete converter;
+}
+
+bool FrameReadback::BeginFrame(uint64_t frameIndex, int width, int height, uint64_t sceneFrame)
+{
+    // 先交付已完成的帧，尽量腾出槽位
+    Poll();
+    if (inFlight == depth || width <= 0 || height <= 0)
+    {
+        skippedFrames++;
+        return false;
+    }
+
+    Slot &slot = slots[head];
+    size_t bytes = converter ? YuvConverter::FrameBytes(width, height) : (size_t)width * height * 4;
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+    if (slot.capacity != bytes)
+    {
+        // 尺寸变化时重新分配（槽位空闲，没有在途的读取）
+        glBufferData(GL_PIXEL_PACK_BUFFER, bytes, nullptr, GL_STREAM_READ);
+        slot.capacity = bytes;
+    }
+    slot.frameIndex = frameIndex;
+    slot.width = width;
+    slot.height = height;
+    slot.bytes = bytes;
+    slot.transferred = 0;
+    slot.keyframe = true;
+    slot.damage.clear();
+    if (tracker && !converter)
+    {
+        const FrameDamage &damage = tracker->Compute(sceneFrame, width, height);
+        slot.keyframe = damage.keyframe;
+        slot.damage = damage.rects;
+    }
+    slot.issued = clock::now();
+    if (firstIssued == clock::time_point())
+        firstIssued = slot.issued;
+    recording = &slot;
+
+    // YUV 转换：分块先拼进整帧纹理，EndFrame 时统一转换并读出三个平面
+    if (converter)
+    {
+        converter->Prepare(width, height);
+        return true;
+    }
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, readFbo);
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glPixelStorei(GL_PACK_ROW_LENGTH, width);
+    return true;
+}
+
+void FrameReadback::ReadRegion(unsigned int texture, int x, int y, int w, int h)
+{
+    if (!recording)
+        return;
+    if (converter)
+    {
+        converter->CopyRegion(texture, x, y, w, h);
+        return;
+    }
+    glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+    auto read = [this](int rx, int ry, int rw, int rh) {
+        size_t offset = ((size_t)ry * recording->width + rx) * 4;
+        glReadPixels(rx, ry, rw, rh, GL_RGBA, GL_UNSIGNED_BYTE, (void *)offset);
+        recording->transferred += (size_t)rw * rh * 4;
+    };
+    if (recording->keyframe)
+    {
+        read(x, y, w, h);
+        return;
+    }
+    // 非关键帧：只读区域内的脏分块
+    for (const DamageRect &r : recording->damage)
+    {
+        int x0 = std::max(x, r.x), y0 = std::max(y, r.y);
+        int x1 = std::min(x + w, r.x + r.w), y1 = std::min(y + h, r.y + r.h);
+        if (x0 < x1 && y0 < y1)
+            read(x0, y0, x1 - x0, y1 - y0);
+    }
+}
+
+void FrameReadback::EndFrame()
+{
+    if (!recording)
+        return;
+    if (converter)
+    {
+        converter->ConvertAssembled();
+        converter->ReadPlanes(0);
+        recording->transferred = recording->bytes;
+    }
+    else
+    {
+        glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, 0, 0);
+        glPixelStorei(GL_PACK_ROW_LENGTH, 0);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+    }
+    Submit();
+}
+
+void FrameReadback::Submit()
+{
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    recording->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    // 确保栅栏送达 GPU，之后的非阻塞轮询才能看到它完成
+    glFlush();
+    recording = nullptr;
+    head = (head + 1) % depth;
+    inFlight++;
+}
+
+bool FrameReadback::ReadTexture(unsigned int texture, uint64_t frameIndex, uint64_t sceneFrame)
+{
+    int width = 0, height = 0;
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &width);
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &height);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return ReadTexture(texture, width, height, frameIndex, sceneFrame);
+}
+
+bool FrameReadback::ReadTexture(unsigned int texture, int width, int height, uint64_t frameIndex, uint64_t sceneFrame)
+{
+    int textureWidth = 0, textureHeight = 0;
+    if (converter)
+    {
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &textureWidth);
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &textureHeight);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    if (!BeginFrame(frameIndex, width, height, sceneFrame))
+        return false;
+    if (converter && textureWidth == width && textureHeight == height)
+    {
+        // 整帧纹理直接转换，不经过拼装；内容只占纹理一部分时走下面的拼装路径
+        converter->Convert(texture);
+        converter->ReadPlanes(0);
+        recording->transferred = recording->bytes;
+        Submit();
+        return true;
+    }
+    ReadRegion(texture, 0, 0, width, height);
+    EndFrame();
+    return true;
+}
+
+int FrameReadback::Poll()
+{
+    int delivered = 0;
+    while (inFlight > 0)
+    {
+        Slot &slot = slots[tail];
+        GLint status = GL_UNSIGNALED;
+        glGetSynciv(slot.fence, GL_SYNC_STATUS, 1, nullptr, &status);
+        if (status != GL_SIGNALED)
+            break;
+        Deliver(slot);
+        delivered++;
+    }
+    return delivered;
+}
+
+void FrameReadback::Flush()
+{
+    while (inFlight > 0)
+    {
+        Slot &slot = slots[tail];
+        glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+        Deliver(slot);
+    }
+}
+
+void FrameReadback::Deliver(Slot &slot)
+{
+    glDeleteSync(slot.fence);
+    slot.fence = nullptr;
+
+    size_t bytes = slot.bytes;
+    size_t rowBytes = (size_t)slot.width * 4;
+    bool patch = tracker && !converter && !slot.keyframe;
+    // 非关键帧只映射脏分块覆盖的行
+    size_t mapBegin = 0, mapEnd = bytes;
+    if (patch)
+    {
+        mapBegin = bytes;
+        mapEnd = 0;
+        for (const DamageRect &r : slot.damage)
+        {
+            mapBegin = std::min(mapBegin, r.y * rowBytes);
+            mapEnd = std::max(mapEnd, (r.y + r.h) * rowBytes);
+        }
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+    const unsigned char *data = nullptr;
+    if (mapEnd > mapBegin)
+        data = (const unsigned char *)glMapBufferRange(GL_PIXEL_PACK_BUFFER, mapBegin, mapEnd - mapBegin, GL_MAP_READ_BIT);
+    auto now = clock::now();
+    double latency = std::chrono::duration<double, std::milli>(now - slot.issued).count();
+
+    const unsigned char *pixels = data;
+    if (tracker && !converter)
+    {
+        // 关键帧整帧替换画布，非关键帧把脏分块拷贝到画布的相同位置
+        if (!patch && data)
+            canvas.assign(data, data + bytes);
+        else if (patch && !data && !slot.damage.empty())
+            canvas.clear(); // 映射失败：画布不再可信，直到下一个关键帧
+        else if (patch && canvas.size() == bytes)
+        {
+            for (const DamageRect &r : slot.damage)
+            {
+                for (int y = r.y; y < r.y + r.h; ++y)
+                {
+                    size_t offset = y * rowBytes + (size_t)r.x * 4;
+                    std::memcpy(&canvas[offset], data + (offset - mapBegin), (size_t)r.w * 4);
+                }
+            }
+        }
+        pixels = canvas.size() == bytes ? canvas.data() : nullptr;
+    }
+    if (pixels && callback)
+    {
+        ReadbackFrame frame;
+        frame.frameIndex = slot.frameIndex;
+        frame.width = slot.width;
+        frame.height = slot.height;
+        frame.format = GetFormat();
+        if (converter)
+        {
+            frame.matrix = converter->GetMatrix();
+            frame.range = converter->GetRange();
+        }
+        frame.pixels = pixels;
+        frame.bytes = bytes;
+        frame.latencyMs = latency;
+        frame.keyframe = slot.keyframe;
+        frame.damage = slot.damage.data();
+        frame.damageCount = (int)slot.damage.size();
+        callback(frame);
+    }
+    if (data)
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    tail = (tail + 1) % depth;
+    inFlight--;
+    deliveredFrames++;
+    totalLatencyMs += latency;
+    totalBytes += slot.transferred;
+    lastDelivered = now;
+
+    windowFrames++;
+    windowLatencyMs += latency;
+    windowBytes += slot.transferred;
+    if (windowStart == clock::time_point())
+        windowStart = slot.issued;
+    std::chrono::duration<double> elapsed = now - windowStart;
+    if (elapsed.count() >= 1.0)
+    {
+        latencyMs = windowLatencyMs / windowFrames;
+        throughputMBps = windowBytes / (1024.0 * 1024.0) / elapsed.count();
+        windowFrames = 0;
+        windowLatencyMs = 0.0;
+        windowBytes = 0;
+        windowStart = now;
+    }
+}
+
+double FrameReadback::GetAverageLatencyMs() const
+{
+    return deliveredFrames ? totalLatencyMs / deliveredFrames : 0.0;
+}
+
+double FrameReadback::GetSustainedMBps() const
+{
+    double seconds = std::chrono::duration<double>(lastDelivered - firstIssued).count();
+    return seconds > 0.0 ? totalBytes / (1024.0 * 1024.0) / seconds : 0.0;
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "DamageTracker.h"
+#include "YuvConverter.h"
+
+// 回读像素的布局
+enum class ReadbackFormat
+{
+    Rgba8, // RGBA8，行序自底向上（OpenGL 约定），紧密排列
+    I420   // GPU 端转换的 YUV 4:2:0 平面（Y、U、V 依次紧密排列），行序自顶向下
+};
+
+// 一帧回读完成的像素，仅在回调期间有效
+struct ReadbackFrame
+{
+    uint64_t frameIndex = 0;
+    int width = 0, height = 0;
+    ReadbackFormat format = ReadbackFormat::Rgba8;
+    YuvMatrix matrix = YuvMatrix::None; // I420 帧的转换矩阵与量化范围
+    YuvRange range = YuvRange::Full;
+    const unsigned char *pixels = nullptr; // 布局见 format
+    size_t bytes = 0;
+    double latencyMs = 0.0; // 发起回读到交给回调的耗时
+    // 脏矩形跟踪：非关键帧只有 damage 中的矩形相对上一个交付的帧发生变化（pixels 仍是完整的一帧）
+    bool keyframe = true;
+    const DamageRect *damage = nullptr;
+    int damageCount = 0;
+};
+
+// 异步像素回读：N 个 PBO 组成的环，每个槽位一个栅栏。
+// 发起回读只向 GPU 提交 glReadPixels 到 PBO 并插入栅栏，不等待；Poll() 非阻塞检查最旧的槽位，
+// 完成后映射交给 CPU 回调。环满时本帧放弃回读（计入 skipped），调用线程永远不会被阻塞。
+// matrix 不为 None 时，回读前先在 GPU 上转换为 I420（见 YuvConverter），PBO 只搬运约 37.5% 的字节。
+// 设置 DamageTracker 后（仅 RGBA），非关键帧只回读脏分块，交付前拼到 CPU 端保留的上一帧上，回调看到的仍是完整帧。
+// 必须在同一个上下文线程中构造、使用与销毁。
+class FrameReadback
+{
+public:
+    static const int MinDepth = 2;
+    static const int MaxDepth = 8;
+    using Callback = std::function<void(const ReadbackFrame &)>;
+
+    FrameReadback(int depth, Callback callback, YuvMatrix matrix = YuvMatrix::None, YuvRange range = YuvRange::Full);
+    ~FrameReadback();
+
+    // 脏矩形跟踪（不持有），YUV 转换时不使用
+    void SetDamageTracker(DamageTracker *tracker) { this->tracker = tracker; }
+
+    // 分区域回读一帧（例如 SFR 的各个分块）：BeginFrame 返回 false 表示环已满，本帧不回读
+    // sceneFrame 为这一帧所用场景快照的帧号，用于计算脏矩形（0 表示未知，按整帧回读）
+    bool BeginFrame(uint64_t frameIndex, int width, int height, uint64_t sceneFrame = 0);
+    // 把 texture 中 (x, y, w, h) 区域读到本帧的相同位置
+    void ReadRegion(unsigned int texture, int x, int y, int w, int h);
+    void EndFrame();
+    // 回读整张纹理（尺寸从纹理查询）
+    bool ReadTexture(unsigned int texture, uint64_t frameIndex, uint64_t sceneFrame = 0);
+    // 只回读纹理左下角 width x height 的内容（按尺寸分档分配的渲染目标）
+    bool ReadTexture(unsigned int texture, int width, int height, uint64_t frameIndex, uint64_t sceneFrame = 0);
+
+    // 非阻塞：按提交顺序把已完成的帧交给回调，返回交付的帧数
+    int Poll();
+    // 阻塞等待所有在途帧完成并交付（停止前调用）
+    void Flush();
+
+    int GetDepth() const { return depth; }
+    ReadbackFormat GetFormat() const { return converter ? ReadbackFormat::I420 : ReadbackFormat::Rgba8; }
+    int GetInFlight() const { return inFlight; }
+    unsigned long long GetDeliveredFrames() const { return deliveredFrames; }
+    unsigned long long GetSkippedFrames() const { return skippedFrames; }
+    // 最近一秒的平均回读延迟与吞吐量（吞吐按实际回读的字节计，只读脏分块时随之下降）
+    double GetLatencyMs() const { return latencyMs; }
+    double GetThroughputMBps() const { return throughputMBps; }
+    // 自创建以来的平均延迟与持续吞吐量
+    double GetAverageLatencyMs() const;
+    double GetSustainedMBps() const;
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    struct Slot
+    {
+        unsigned int pbo = 0;
+        size_t capacity = 0;
+        GLsync fence = nullptr;
+        uint64_t frameIndex = 0;
+        int width = 0, height = 0;
+        size_t bytes = 0;
+        size_t transferred = 0; // 实际回读的字节数（只读脏分块时小于 bytes）
+        bool keyframe = true;
+        std::vector<DamageRect> damage;
+        clock::time_point issued;
+    };
+
+    // 结束当前帧：插入栅栏并推进环
+    void Submit();
+    void Deliver(Slot &slot);
+
+    int depth;
+    Callback callback;
+    std::unique_ptr<Slot[]> slots;
+    int head = 0; // 下一个写入的槽位
+    int tail = 0; // 最旧的在途槽位
+    int inFlight = 0;
+    Slot *recording = nullptr;
+    unsigned int readFbo = 0;
+    YuvConverter *converter = nullptr;
+    DamageTracker *tracker = nullptr;
+    // 上一个交付的完整帧，脏分块拼在它上面
+    std::vector<unsigned char> canvas;
+
+    unsigned long long deliveredFrames = 0;
+    unsigned long long skippedFrames = 0;
+    double totalLatencyMs = 0.0;
+    unsigned long long totalBytes = 0;
+    clock::time_point firstIssued;
+    clock::time_point lastDelivered;
+
+    // 每秒统计窗口
+    clock::time_point windowStart;
+    int windowFrames = 0;
+    double windowLatencyMs = 0.0;
+    unsigned long long windowBytes = 0;
+    double latencyMs = 0.0;
+    double throughputMBps = 0.0;
+};
@@ -0,0 +1,129 @@
+#include "FrameServer.h"
+#include <cstdio>
+#include <cstring>
+#include <new>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+FrameServer::FrameServer(const std::string &name, int slotCount, int maxWidth, int maxHeight)
+    : name(name)
+{
+    std::printf("共享内存帧服务仅支持 POSIX 平台，已忽略 %s\n", name.c_str());
+}
+
+FrameServer::~FrameServer()
+{
+}
+
+void FrameServer::Publish(const ReadbackFrame &frame)
+{
+}
+
+#else
+
+FrameServer::FrameServer(const std::string &name, int slotCount, int maxWidth, int maxHeight)
+    : name(name)
+{
+    slotCount = slotCount < 2 ? 2 : slotCount;
+    mappingSize = FrameShm::MappingSize(slotCount, maxWidth, maxHeight);
+
+    // 同名的旧环（例如上次异常退出留下的）直接替换；已映射旧环的读者需要重新打开
+    shm_unlink(name.c_str());
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0)
+    {
+        std::perror(("无法创建共享内存 " + name).c_str());
+        return;
+    }
+    if (ftruncate(fd, (off_t)mappingSize) != 0)
+    {
+        std::perror("无法设置共享内存大小");
+        close(fd);
+        shm_unlink(name.c_str());
+        return;
+    }
+    mapping = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED)
+    {
+        std::perror("无法映射共享内存");
+        mapping = nullptr;
+        shm_unlink(name.c_str());
+        return;
+    }
+
+    // ftruncate 得到的内存已清零：所有槽位 sequence 为 0（偶数、空）
+    header = new (mapping) FrameShm::Header();
+    header->slotCount = (uint32_t)slotCount;
+    header->maxWidth = (uint32_t)maxWidth;
+    header->maxHeight = (uint32_t)maxHeight;
+    header->writerPid = (uint32_t)getpid();
+    header->slotStride = FrameShm::SlotStride(maxWidth, maxHeight);
+    header->published.store(0, std::memory_order_relaxed);
+    for (int i = 0; i < slotCount; ++i)
+        new (FrameShm::GetSlot(mapping, header, i)) FrameShm::Slot();
+    header->version = FrameShm::Version;
+    // magic 最后写入：读者看到 magic 才认为头部有效
+    std::atomic_thread_fence(std::memory_order_release);
+    header->magic = FrameShm::Magic;
+
+    std::printf("共享内存帧服务: %s  槽位: %d x %.1f MB  最大尺寸: %dx%d\n", name.c_str(), slotCount,
+                header->slotStride / (1024.0 * 1024.0), maxWidth, maxHeight);
+}
+
+FrameServer::~FrameServer()
+{
+    if (!mapping)
+        return;
+    // 已映射的读者仍可读完手上的帧；名字删除后新读者无法再打开
+    munmap(mapping, mappingSize);
+    shm_unlink(name.c_str());
+    std::printf("共享内存帧服务结束  发布: %llu 帧  超出尺寸: %llu 帧\n", publishedFrames, oversizedFrames);
+}
+
+void FrameServer::Publish(const ReadbackFrame &frame)
+{
+    if (!header)
+        return;
+    if (frame.width > (int)header->maxWidth || frame.height > (int)header->maxHeight)
+    {
+        oversizedFrames++;
+        auto now = std::chrono::steady_clock::now();
+        if (now - lastLog >= std::chrono::seconds(1))
+        {
+            lastLog = now;
+            std::printf("[共享内存] 帧尺寸 %dx%d 超出槽位容量 %ux%u，未发布（累计 %llu）\n", frame.width, frame.height,
+                        header->maxWidth, header->maxHeight, oversizedFrames);
+        }
+        return;
+    }
+
+    uint64_t generation = header->published.load(std::memory_order_relaxed) + 1;
+    FrameShm::Slot *slot = FrameShm::GetSlot(mapping, header, generation - 1);
+
+    // seqlock 写端：sequence 变为奇数后再改内容，写完变回偶数
+    uint64_t sequence = slot->sequence.load(std::memory_order_relaxed);
+    slot->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    slot->frameIndex = frame.frameIndex;
+    slot->generation = generation;
+    slot->width = frame.width;
+    slot->height = frame.height;
+    slot->timestamp = now.tv_sec + now.tv_nsec * 1e-9;
+    std::memcpy(FrameShm::GetPixels(slot), frame.pixels, (size_t)frame.width * frame.height * 4);
+
+    slot->sequence.store(sequence + 2, std::memory_order_release);
+    header->published.store(generation, std::memory_order_release);
+    publishedFrames++;
+}
+
+#endif
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include "FrameReadback.h"
+#include "FrameShm.h"
+
+// 共享内存帧服务：把回读到的帧发布到 POSIX 共享内存中的槽位环（布局见 FrameShm.h），
+// 任意数量的本地进程通过 FrameShmReader 映射后直接读取，不经过套接字也不额外拷贝。
+// 发布只在主线程（回读回调）中进行一次 memcpy，从不等待读者，也就不会影响 Worker。
+class FrameServer
+{
+public:
+    // name 为 POSIX 共享内存名（如 "/offscreen"）；超过 maxWidth x maxHeight 的帧不发布
+    FrameServer(const std::string &name, int slotCount, int maxWidth, int maxHeight);
+    ~FrameServer();
+
+    bool IsOpen() const { return header != nullptr; }
+    const std::string &GetName() const { return name; }
+
+    void Publish(const ReadbackFrame &frame);
+
+    unsigned long long GetPublishedFrames() const { return publishedFrames; }
+    unsigned long long GetOversizedFrames() const { return oversizedFrames; }
+
+private:
+    std::string name;
+    void *mapping = nullptr;
+    size_t mappingSize = 0;
+    FrameShm::Header *header = nullptr;
+
+    unsigned long long publishedFrames = 0;
+    unsigned long long oversizedFrames = 0;
+    std::chrono::steady_clock::time_point lastLog;
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// 共享内存帧环的布局（FrameServer 写、FrameShmReader 读，两边必须一致）。
+//
+// [FrameShmHeader][slot 0: FrameShmSlot + 像素][slot 1]...
+// 每个槽位用 seqlock 保护：写者写入前把 sequence 加一（变为奇数），写完再加一（变回偶数）；
+// 读者在读像素前后各读一次 sequence，两次相同且为偶数才说明期间没有被覆盖。
+// 写者从不等待读者，读得慢的读者只会读到被覆盖（torn）的帧并丢弃。
+namespace FrameShm
+{
+    const uint32_t Magic = 0x4d485346; // "FSHM"
+    const uint32_t Version = 1;
+    const size_t Alignment = 64;
+
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t slotCount;
+        uint32_t maxWidth, maxHeight;
+        uint32_t writerPid;
+        uint64_t slotStride; // 每个槽位（头 + 像素）占用的字节数
+        // 已发布的帧数；最新的帧位于槽位 (published - 1) % slotCount
+        std::atomic<uint64_t> published;
+    };
+
+    struct alignas(64) Slot
+    {
+        std::atomic<uint64_t> sequence; // 奇数表示正在写入
+        uint64_t frameIndex;
+        uint64_t generation; // 第几个发布的帧（从 1 开始），与 Header::published 对应
+        int32_t width, height;
+        double timestamp; // 发布时刻（CLOCK_MONOTONIC 秒）
+        // RGBA8，行序自底向上（OpenGL 约定），紧密排列；像素紧跟在槽位头之后
+    };
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "跨进程 seqlock 需要无锁的 64 位原子操作");
+
+    inline size_t HeaderSize() { return (sizeof(Header) + Alignment - 1) / Alignment * Alignment; }
+    inline size_t SlotStride(uint32_t maxWidth, uint32_t maxHeight)
+    {
+        size_t bytes = sizeof(Slot) + (size_t)maxWidth * maxHeight * 4;
+        return (bytes + Alignment - 1) / Alignment * Alignment;
+    }
+    inline size_t MappingSize(uint32_t slotCount, uint32_t maxWidth, uint32_t maxHeight)
+    {
+        return HeaderSize() + SlotStride(maxWidth, maxHeight) * slotCount;
+    }
+    inline Slot *GetSlot(void *base, const Header *header, uint64_t index)
+    {
+        return (Slot *)((unsigned char *)base + HeaderSize() + header->slotStride * (index % header->slotCount));
+    }
+    inline unsigned char *GetPixels(Slot *slot) { return (unsigned char *)(slot + 1); }
+}
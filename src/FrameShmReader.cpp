@@ -0,0 +1,153 @@
+#include "FrameShmReader.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+FrameShmReader::~FrameShmReader()
+{
+    Close();
+}
+
+#ifdef _WIN32
+
+bool FrameShmReader::Open(const std::string &name)
+{
+    std::fprintf(stderr, "共享内存帧环仅支持 POSIX 平台\n");
+    return false;
+}
+
+void FrameShmReader::Close()
+{
+}
+
+bool FrameShmReader::IsWriterAlive() const
+{
+    return false;
+}
+
+double FrameShmReader::Now()
+{
+    return 0.0;
+}
+
+#else
+
+bool FrameShmReader::Open(const std::string &name)
+{
+    Close();
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0)
+        return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(FrameShm::Header))
+    {
+        close(fd);
+        return false;
+    }
+    void *base = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED)
+        return false;
+
+    // 写端最后写入 magic，看到 magic 后其余头部字段都已有效
+    const FrameShm::Header *h = (const FrameShm::Header *)base;
+    bool valid = h->magic == FrameShm::Magic;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    valid = valid && h->version == FrameShm::Version &&
+            FrameShm::MappingSize(h->slotCount, h->maxWidth, h->maxHeight) <= (size_t)info.st_size;
+    if (!valid)
+    {
+        munmap(base, info.st_size);
+        return false;
+    }
+    mapping = base;
+    mappingSize = info.st_size;
+    header = h;
+    return true;
+}
+
+void FrameShmReader::Close()
+{
+    if (mapping)
+        munmap(mapping, mappingSize);
+    mapping = nullptr;
+    mappingSize = 0;
+    header = nullptr;
+}
+
+bool FrameShmReader::IsWriterAlive() const
+{
+    return header && (kill((pid_t)header->writerPid, 0) == 0 || errno == EPERM);
+}
+
+double FrameShmReader::Now()
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+#endif
+
+uint64_t FrameShmReader::GetPublished() const
+{
+    return header ? header->published.load(std::memory_order_acquire) : 0;
+}
+
+bool FrameShmReader::AcquireLatest(FrameView &view, uint64_t after) const
+{
+    uint64_t published = GetPublished();
+    if (published == 0 || published <= after)
+        return false;
+
+    // seqlock 读端：先读 sequence，偶数才说明槽位内容完整
+    FrameShm::Slot *slot = FrameShm::GetSlot(mapping, header, published - 1);
+    uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+    if (sequence & 1)
+        return false;
+
+    view.slot = slot;
+    view.sequence = sequence;
+    view.frameIndex = slot->frameIndex;
+    view.generation = slot->generation;
+    view.width = slot->width;
+    view.height = slot->height;
+    view.timestamp = slot->timestamp;
+    view.pixels = FrameShm::GetPixels(slot);
+    // 元数据本身也可能在读取时被覆盖
+    return view.generation > after && Validate(view);
+}
+
+bool FrameShmReader::Validate(const FrameView &view) const
+{
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return view.slot && view.slot->sequence.load(std::memory_order_relaxed) == view.sequence;
+}
+
+bool FrameShmReader::CopyLatest(std::vector<unsigned char> &pixels, FrameView &view, uint64_t after) const
+{
+    // 环深度足够时重试极少发生；持续失败说明读者比写者慢一个完整的环
+    for (int attempt = 0; attempt < 4; ++attempt)
+    {
+        if (!AcquireLatest(view, after))
+            return false;
+        pixels.resize((size_t)view.width * view.height * 4);
+        std::memcpy(pixels.data(), view.pixels, pixels.size());
+        if (Validate(view))
+        {
+            view.pixels = pixels.data();
+            view.slot = nullptr;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "FrameShm.h"
+
+// 槽位中一帧的只读视图：pixels 直接指向共享内存，不做拷贝
+struct FrameView
+{
+    const unsigned char *pixels = nullptr; // RGBA8，行序自底向上
+    uint64_t frameIndex = 0;
+    uint64_t generation = 0; // 第几个发布的帧，可用来计算漏掉的帧数
+    int width = 0, height = 0;
+    double timestamp = 0.0; // 发布时刻（CLOCK_MONOTONIC 秒）
+
+    const FrameShm::Slot *slot = nullptr;
+    uint64_t sequence = 0;
+};
+
+// 共享内存帧环的读端，可在任意进程中使用，不依赖 OpenGL。
+// 读者之间、读者与写者之间没有任何同步：读者只读映射，写者覆盖槽位时读者通过 seqlock 发现。
+class FrameShmReader
+{
+public:
+    FrameShmReader() = default;
+    ~FrameShmReader();
+    FrameShmReader(const FrameShmReader &) = delete;
+    FrameShmReader &operator=(const FrameShmReader &) = delete;
+
+    bool Open(const std::string &name);
+    void Close();
+    bool IsOpen() const { return header != nullptr; }
+
+    int GetSlotCount() const { return header ? (int)header->slotCount : 0; }
+    uint64_t GetPublished() const;
+    // 写端进程是否仍在运行
+    bool IsWriterAlive() const;
+
+    // 零拷贝：取得比 after 更新的最新帧；没有新帧或槽位正在写入时返回 false。
+    // 使用完像素后必须调用 Validate，返回 false 说明读取期间该槽位已被覆盖，读到的数据无效。
+    bool AcquireLatest(FrameView &view, uint64_t after = 0) const;
+    bool Validate(const FrameView &view) const;
+
+    // 便捷接口：把比 after 更新的最新帧复制到 pixels，被覆盖时自动重试
+    bool CopyLatest(std::vector<unsigned char> &pixels, FrameView &view, uint64_t after = 0) const;
+
+    // 当前进程 CLOCK_MONOTONIC 时间（秒），用于和 FrameView::timestamp 计算延迟
+    static double Now();
+
+private:
+    void *mapping = nullptr;
+    size_t mappingSize = 0;
+    const FrameShm::Header *header = nullptr;
+};
@@ -1,45 +1,273 @@
 ﻿#include "Framebuffer.h"
+#include "TransientHeap.h"
+#include <cstring>
 
-Framebuffer::Framebuffer(int width, int height) : width(width), height(height)
+// 内部格式与 glTexImage2D 的像素格式/类型（不上传数据，类型只需与格式兼容）
+struct ColorFormatInfo
 {
-    glGenFramebuffers(1, &fbo);
-    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    ColorFormat format;
+    const char *name;
+    GLenum internalFormat, pixelFormat, type;
+    int bytes;
+};
+
+static const ColorFormatInfo ColorFormats[] = {
+    {ColorFormat::R8, "r8", GL_R8, GL_RED, GL_UNSIGNED_BYTE, 1},
+    {ColorFormat::Rgba8, "rgba8", GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE, 4},
+    {ColorFormat::Rgb10A2, "rgb10a2", GL_RGB10_A2, GL_RGBA, GL_UNSIGNED_INT_2_10_10_10_REV, 4},
+    {ColorFormat::R11fG11fB10f, "r11g11b10f", GL_R11F_G11F_B10F, GL_RGB, GL_FLOAT, 4},
+    {ColorFormat::Rgba16f, "rgba16f", GL_RGBA16F, GL_RGBA, GL_FLOAT, 8},
+};
+
+static const ColorFormatInfo &InfoOf(ColorFormat format)
+{
+    for (const ColorFormatInfo &info : ColorFormats)
+        if (info.format == format)
+            return info;
+    return ColorFormats[1];
+}
+
+const char *ColorFormatName(ColorFormat format)
+{
+    return InfoOf(format).name;
+}
+
+bool ParseColorFormat(const char *name, ColorFormat &format)
+{
+    for (const ColorFormatInfo &info : ColorFormats)
+    {
+        if (std::strcmp(name, info.name) == 0)
+        {
+            format = info.format;
+            return true;
+        }
+    }
+    return false;
+}
 
-    // 创建颜色附件纹理
-    glGenTextures(1, &textureColorBuffer);
-    glBindTexture(GL_TEXTURE_2D, textureColorBuffer);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, textureColorBuffer, 0);
+int ColorFormatBytes(ColorFormat format)
+{
+    return InfoOf(format).bytes;
+}
 
-    // 创建深度/模板渲染缓冲对象
-    glGenRenderbuffers(1, &rbo);
-    glBindRenderbuffer(GL_RENDERBUFFER, rbo);
-    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
-    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, rbo);
+bool FramebufferDesc::SameFormat(const FramebufferDesc &other) const
+{
+    if (colorCount != other.colorCount || depth != other.depth || samples != other.samples)
+        return false;
+    for (int i = 0; i < colorCount; ++i)
+        if (colors[i] != other.colors[i])
+            return false;
+    return true;
+}
+
+size_t FramebufferDesc::GetBytes() const
+{
+    // 多重采样时每个采样各占一份，颜色另有单采样的解析纹理
+    size_t sampleCount = samples > 0 ? samples : 1;
+    size_t colorBytes = 0;
+    for (int i = 0; i < colorCount; ++i)
+        colorBytes += ColorFormatBytes(colors[i]);
+    size_t pixelBytes = (colorBytes + (depth == DepthAttachment::None ? 0 : 4)) * sampleCount;
+    if (samples > 0)
+        pixelBytes += colorBytes;
+    return (size_t)width * height * pixelBytes;
+}
+
+Framebuffer::Framebuffer(const FramebufferDesc &desc, TransientHeap *heap)
+    : desc(desc), viewWidth(desc.width), viewHeight(desc.height), heap(heap)
+{
+    Create();
+}
+
+Framebuffer::Framebuffer(int width, int height) : viewWidth(width), viewHeight(height)
+{
+    desc.width = width;
+    desc.height = height;
+    Create();
+}
+
+void Framebuffer::Create()
+{
+    if (desc.colorCount < 0 || desc.colorCount > FramebufferDesc::MaxColorAttachments)
+        desc.colorCount = 1;
+    if (desc.samples > 0)
+    {
+        GLint maxSamples = 0;
+        glGetIntegerv(GL_MAX_SAMPLES, &maxSamples);
+        samples = desc.samples < maxSamples ? desc.samples : maxSamples;
+        if (samples < 2)
+            samples = 0;
+    }
+
+    // 创建颜色附件纹理；多重采样时它们挂在解析 FBO 上，渲染 FBO 使用同格式的多重采样渲染缓冲
+    if (samples > 0)
+    {
+        glGenFramebuffers(1, &resolveFbo);
+        glBindFramebuffer(GL_FRAMEBUFFER, resolveFbo);
+    }
+    else
+    {
+        glGenFramebuffers(1, &fbo);
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    }
+    GLenum drawBuffers[FramebufferDesc::MaxColorAttachments];
+    for (int i = 0; i < desc.colorCount; ++i)
+    {
+        const ColorFormatInfo &info = InfoOf(desc.colors[i]);
+        glGenTextures(1, &colorTextures[i]);
+        glBindTexture(GL_TEXTURE_2D, colorTextures[i]);
+        glTexImage2D(GL_TEXTURE_2D, 0, info.internalFormat, desc.width, desc.height, 0, info.pixelFormat, info.type, NULL);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + i, GL_TEXTURE_2D, colorTextures[i], 0);
+        drawBuffers[i] = GL_COLOR_ATTACHMENT0 + i;
+        ownedBytes += (size_t)desc.width * desc.height * info.bytes;
+    }
+    if (samples > 0)
+    {
+        glGenFramebuffers(1, &fbo);
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        for (int i = 0; i < desc.colorCount; ++i)
+        {
+            const ColorFormatInfo &info = InfoOf(desc.colors[i]);
+            AttachRenderbuffer(GL_COLOR_ATTACHMENT0 + i, info.internalFormat, info.bytes, colorRenderbuffers[i]);
+        }
+    }
+    if (desc.colorCount > 0)
+    {
+        glDrawBuffers(desc.colorCount, drawBuffers);
+    }
+    else
+    {
+        glDrawBuffer(GL_NONE);
+        glReadBuffer(GL_NONE);
+    }
+
+    if (desc.depth == DepthAttachment::Texture && samples == 0)
+    {
+        // 可采样的深度/模板纹理：采样得到深度值，不做比较
+        glGenTextures(1, &depthTexture);
+        glBindTexture(GL_TEXTURE_2D, depthTexture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH24_STENCIL8, desc.width, desc.height, 0, GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8, NULL);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_NONE);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, depthTexture, 0);
+        ownedBytes += (size_t)desc.width * desc.height * 4;
+    }
+    else if (desc.depth != DepthAttachment::None)
+    {
+        // 创建深度/模板渲染缓冲对象
+        AttachRenderbuffer(GL_DEPTH_STENCIL_ATTACHMENT, GL_DEPTH24_STENCIL8, 4, rbo);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
 
     if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
         std::cout << "错误::帧缓冲区:: 帧缓冲区不完整！" << std::endl;
+    // 瞬态附件只在创建时用于检查完整性，之后每次 Bind 重新取得
+    ReleaseTransients();
 
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
+void Framebuffer::AttachRenderbuffer(GLenum point, GLenum internalFormat, int bytesPerPixel, unsigned int &owned)
+{
+    if (heap)
+    {
+        TransientAttachment &transient = transients[transientCount++];
+        transient.point = point;
+        transient.handle = heap->Register(internalFormat, samples, desc.width, desc.height, bytesPerPixel);
+        transient.attached = heap->Acquire(transient.handle);
+        transientsHeld = true;
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, point, GL_RENDERBUFFER, transient.attached);
+        return;
+    }
+    glGenRenderbuffers(1, &owned);
+    glBindRenderbuffer(GL_RENDERBUFFER, owned);
+    glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples, internalFormat, desc.width, desc.height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, point, GL_RENDERBUFFER, owned);
+    ownedBytes += (size_t)desc.width * desc.height * bytesPerPixel * (samples > 0 ? samples : 1);
+}
+
+void Framebuffer::AcquireTransients()
+{
+    // 调用时本目标的 FBO 已绑定；堆换了承载的块时重新挂接
+    if (transientsHeld)
+        return;
+    for (int i = 0; i < transientCount; ++i)
+    {
+        unsigned int renderbuffer = heap->Acquire(transients[i].handle);
+        if (renderbuffer != transients[i].attached)
+        {
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, transients[i].point, GL_RENDERBUFFER, renderbuffer);
+            transients[i].attached = renderbuffer;
+        }
+    }
+    transientsHeld = true;
+}
+
+void Framebuffer::ReleaseTransients()
+{
+    if (!transientsHeld)
+        return;
+    for (int i = 0; i < transientCount; ++i)
+        heap->Release(transients[i].handle);
+    transientsHeld = false;
+}
+
 Framebuffer::~Framebuffer()
 {
     glDeleteFramebuffers(1, &fbo);
-    glDeleteTextures(1, &textureColorBuffer);
-    glDeleteRenderbuffers(1, &rbo);
+    glDeleteTextures(desc.colorCount, colorTextures);
+    if (resolveFbo)
+    {
+        glDeleteFramebuffers(1, &resolveFbo);
+        glDeleteRenderbuffers(desc.colorCount, colorRenderbuffers);
+    }
+    if (depthTexture)
+        glDeleteTextures(1, &depthTexture);
+    if (rbo)
+        glDeleteRenderbuffers(1, &rbo);
+    for (int i = 0; i < transientCount; ++i)
+        heap->Unregister(transients[i].handle);
+}
+
+void Framebuffer::SetSize(int width, int height)
+{
+    viewWidth = width < desc.width ? width : desc.width;
+    viewHeight = height < desc.height ? height : desc.height;
 }
 
 void Framebuffer::Bind()
 {
     glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-    glViewport(0, 0, width, height);
+    AcquireTransients();
+    glViewport(0, 0, viewWidth, viewHeight);
+}
+
+void Framebuffer::Resolve()
+{
+    if (samples == 0)
+        return;
+    GLint previousDraw = 0, previousRead = 0;
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previousDraw);
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previousRead);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, resolveFbo);
+    for (int i = 0; i < desc.colorCount; ++i)
+    {
+        glReadBuffer(GL_COLOR_ATTACHMENT0 + i);
+        glDrawBuffer(GL_COLOR_ATTACHMENT0 + i);
+        glBlitFramebuffer(0, 0, viewWidth, viewHeight, 0, 0, viewWidth, viewHeight, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    }
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, previousRead);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, previousDraw);
 }
 
 void Framebuffer::Unbind()
 {
+    ReleaseTransients();
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
     // 通常我们在主循环或渲染器中重置视口，但确保解绑
 }
@@ -1,20 +1,116 @@
 #pragma once
 
 #include <glad/glad.h>
+#include <cstddef>
 #include <iostream>
 
+class TransientHeap;
+
+// 颜色附件格式：按用途选最便宜的一种（三通道 8 位格式在多数驱动上走慢路径，已不提供）
+enum class ColorFormat
+{
+    R8,           // 单通道（YUV 平面等）
+    Rgba8,        // 默认
+    Rgb10A2,      // 10 位颜色，同样 4 字节
+    R11fG11fB10f, // 无符号浮点 HDR，4 字节、无 alpha
+    Rgba16f       // 半精度浮点，8 字节
+};
+
+const char *ColorFormatName(ColorFormat format);
+bool ParseColorFormat(const char *name, ColorFormat &format);
+// 每像素字节数
+int ColorFormatBytes(ColorFormat format);
+
+// 深度附件
+enum class DepthAttachment
+{
+    None,         // 无深度（后处理 pass）
+    Renderbuffer, // 深度/模板渲染缓冲，不可采样
+    Texture       // 深度/模板纹理，之后的 pass 可以采样深度
+};
+
+// 帧缓冲描述：尺寸、颜色附件列表与深度附件
+struct FramebufferDesc
+{
+    static const int MaxColorAttachments = 4;
+
+    int width = 0, height = 0;
+    int colorCount = 1;
+    ColorFormat colors[MaxColorAttachments] = {ColorFormat::Rgba8, ColorFormat::Rgba8, ColorFormat::Rgba8, ColorFormat::Rgba8};
+    DepthAttachment depth = DepthAttachment::Renderbuffer;
+    // 多重采样数（2/4/8），0 表示不使用。多重采样时颜色与深度都是多重采样渲染缓冲，
+    // 另有同格式的单采样纹理接收 Resolve 的结果；深度不可采样（Texture 按 Renderbuffer 处理）
+    int samples = 0;
+
+    // 除尺寸外的全部字段相同（渲染目标池按此判断能否复用）
+    bool SameFormat(const FramebufferDesc &other) const;
+    // 全部附件占用的显存估计
+    size_t GetBytes() const;
+};
+
 class Framebuffer {
 public:
+    // heap 非空时，深度/模板渲染缓冲与多重采样颜色渲染缓冲从堆中取得，与同一上下文中生命期不重叠的目标共享；
+    // 这些附件只在 Bind() 到 Unbind() 之间有效，此时目标必须经 Bind/Unbind 使用（不能直接绑定 GetId()）
+    explicit Framebuffer(const FramebufferDesc &desc, TransientHeap *heap = nullptr);
+    // 一个 RGBA8 颜色附件 + 深度/模板渲染缓冲
     Framebuffer(int width, int height);
     ~Framebuffer();
 
+    // 绑定渲染用的 FBO（多重采样时为多重采样 FBO）并设置视口；瞬态附件的生命期从这里开始
     void Bind();
+    // 解绑；瞬态附件的生命期到此结束，内容不再保留
     void Unbind();
-    unsigned int GetTextureID() const { return textureColorBuffer; }
+    // 多重采样时把每个颜色附件的使用区域解析到对应纹理（每个附件一次 blit，受 scissor 限制），否则什么都不做。
+    // 采样颜色纹理之前、Unbind() 之前调用
+    void Resolve();
+    unsigned int GetId() const { return fbo; }
+    // 颜色纹理（多重采样时为解析目标）
+    unsigned int GetTextureID(int attachment = 0) const { return colorTextures[attachment]; }
+    // 深度纹理（深度附件不是纹理时为 0）
+    unsigned int GetDepthTextureID() const { return depthTexture; }
+    const FramebufferDesc &GetDesc() const { return desc; }
+
+    // 使用中的尺寸：Bind 时的视口。从渲染目标池按尺寸分档取得时可能小于分配尺寸，内容位于纹理左下角
+    int GetWidth() const { return viewWidth; }
+    int GetHeight() const { return viewHeight; }
+    void SetSize(int width, int height);
+    int GetAllocatedWidth() const { return desc.width; }
+    int GetAllocatedHeight() const { return desc.height; }
+    // 本目标独占的显存（不含从瞬态堆共享的附件）
+    size_t GetAllocatedBytes() const { return ownedBytes; }
+    // 实际采样数（受 GL_MAX_SAMPLES 限制，可能小于描述中的值）
+    int GetSamples() const { return samples; }
 
 private:
-    unsigned int fbo;
-    unsigned int textureColorBuffer;
-    unsigned int rbo;
-    int width, height;
+    // 瞬态附件：挂接点与堆句柄，attached 为当前挂在 FBO 上的渲染缓冲
+    struct TransientAttachment
+    {
+        GLenum point;
+        int handle;
+        unsigned int attached;
+    };
+
+    void Create();
+    // 创建并挂接一个渲染缓冲附件（有堆时从堆中取得）
+    void AttachRenderbuffer(GLenum point, GLenum internalFormat, int bytesPerPixel, unsigned int &owned);
+    void AcquireTransients();
+    void ReleaseTransients();
+
+    FramebufferDesc desc;
+    unsigned int fbo = 0;
+    unsigned int colorTextures[FramebufferDesc::MaxColorAttachments] = {0, 0, 0, 0};
+    unsigned int depthTexture = 0;
+    unsigned int rbo = 0;
+    // 多重采样：颜色渲染缓冲与解析用 FBO
+    unsigned int colorRenderbuffers[FramebufferDesc::MaxColorAttachments] = {0, 0, 0, 0};
+    unsigned int resolveFbo = 0;
+    int samples = 0;
+    int viewWidth, viewHeight;
+    size_t ownedBytes = 0;
+
+    TransientHeap *heap = nullptr;
+    TransientAttachment transients[FramebufferDesc::MaxColorAttachments + 1];
+    int transientCount = 0;
+    bool transientsHeld = false;
 };
@@ -0,0 +1,47 @@
+#include "GpuTimer.h"
+
+GpuTimer::GpuTimer()
+{
+    glGenQueries(Depth, queries);
+}
+
+GpuTimer::~GpuTimer()
+{
+    glDeleteQueries(Depth, queries);
+}
+
+void GpuTimer::Begin()
+{
+    Collect();
+    active = !pending[next];
+    if (active)
+        glBeginQuery(GL_TIME_ELAPSED, queries[next]);
+}
+
+void GpuTimer::End()
+{
+    if (!active)
+        return;
+    glEndQuery(GL_TIME_ELAPSED);
+    pending[next] = true;
+    next = (next + 1) % Depth;
+    active = false;
+}
+
+void GpuTimer::Collect()
+{
+    for (int i = 0; i < Depth; ++i)
+    {
+        if (!pending[i])
+            continue;
+        GLint available = 0;
+        glGetQueryObjectiv(queries[i], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+            continue;
+        GLuint64 ns = 0;
+        glGetQueryObjectui64v(queries[i], GL_QUERY_RESULT, &ns);
+        pending[i] = false;
+        double ms = ns / 1e6;
+        averageMs = averageMs > 0.0 ? averageMs * 0.9 + ms * 0.1 : ms;
+    }
+}
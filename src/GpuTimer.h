@@ -0,0 +1,30 @@
+#pragma once
+
+#include <glad/glad.h>
+
+// GPU 耗时测量：GL_TIME_ELAPSED 查询组成的小环，结果在可用时才读取，不阻塞 CPU（通常落后几帧）。
+// 同一上下文中同时只能有一个计时区间，Begin/End 不可嵌套。只在创建它的上下文中使用。
+class GpuTimer
+{
+public:
+    static const int Depth = 4;
+
+    GpuTimer();
+    ~GpuTimer();
+
+    // 环中的查询都还未出结果时本次不计时
+    void Begin();
+    void End();
+    // 平滑后的每次耗时（毫秒），尚无结果时为 0
+    double GetMs() const { return averageMs; }
+
+private:
+    // 读取已出结果的查询
+    void Collect();
+
+    unsigned int queries[Depth];
+    bool pending[Depth] = {};
+    int next = 0;
+    bool active = false;
+    double averageMs = 0.0;
+};
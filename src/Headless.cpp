@@ -0,0 +1,405 @@
+#include "Headless.h"
+#include "FrameReadback.h"
+#include "DamageTracker.h"
+#include "ImageExporter.h"
+#include "FrameServer.h"
+#include "FrameContainer.h"
+#include "Renderer.h"
+#include "SceneState.h"
+#include "StreamSink.h"
+#include "UploadThread.h"
+#include "WorkerPool.h"
+#include "RenderTargetPool.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+namespace
+{
+    // 固定小数位数的数值（可指定最小宽度），用于 std::cout 输出而不改变流的格式状态
+    std::string Fixed(double value, int precision, int width = 0)
+    {
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(precision) << std::setw(width) << value;
+        return out.str();
+    }
+
+    double ToMB(double bytes) { return bytes / (1024.0 * 1024.0); }
+}
+
+namespace Headless
+{
+    GLFWwindow *CreateContext(int width, int height, const std::string &api)
+    {
+        const int apis[2] = {
+            api == "osmesa" ? GLFW_OSMESA_CONTEXT_API : GLFW_EGL_CONTEXT_API,
+            api == "osmesa" ? GLFW_EGL_CONTEXT_API : GLFW_OSMESA_CONTEXT_API};
+
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        for (int contextApi : apis)
+        {
+            // 创建接口提示会保留给之后 Worker 等创建的共享上下文
+            glfwWindowHint(GLFW_CONTEXT_CREATION_API, contextApi);
+            GLFWwindow *window = glfwCreateWindow(width, height, "offscreen", NULL, NULL);
+            const char *name = contextApi == GLFW_EGL_CONTEXT_API ? "EGL" : "OSMesa";
+            if (window)
+            {
+                std::cout << "无头上下文: GLFW null 平台 + " << name << std::endl;
+                return window;
+            }
+            const char *description = nullptr;
+            glfwGetError(&description);
+            std::cout << "无法通过 " << name << " 创建无头上下文: " << (description ? description : "未知错误") << std::endl;
+        }
+        return nullptr;
+    }
+
+    HeadlessReport Run(GLFWwindow *context, const RenderSettings &settings, int width, int height, FrameSource *source)
+    {
+        using clock = std::chrono::steady_clock;
+        HeadlessReport report;
+
+        std::cout << "无头运行  渲染器: " << (const char *)glGetString(GL_RENDERER) << "  模式: " << RenderModeName(settings.renderMode)
+                  << "  分辨率: " << width << "x" << height << "  MSAA: " << settings.msaaSamples
+                  << "  时长: " << Fixed(settings.durationSeconds, 1) << "s  帧数上限: " << settings.frameLimit << std::endl;
+
+        RenderTargetPool::ResetPeaks();
+        UploadThread *uploader = new UploadThread(context);
+        uploader->Start();
+        int orbitMesh = -1;
+        if (settings.uploadDemo)
+        {
+            int mesh = uploader->UploadMesh(Scene::BuildTorus(512, 256));
+            uploader->UploadTexture(2048, 2048, Scene::BuildChecker(2048, 16));
+            if (mesh >= 0)
+                orbitMesh = mesh + 1;
+        }
+
+        // 回读需要固定的输出尺寸，开启时动态分辨率固定为 100%；分块模式不支持
+        double resolutionBudget = settings.readbackDepth > 0 ? 0.0 : settings.resolutionBudgetMs;
+
+        // 只创建当前模式需要的渲染端，不保留热待命
+        Renderer *renderer = nullptr;
+        WorkerPool *pool = nullptr;
+        SplitFrameRenderer *split = nullptr;
+        if (settings.renderMode == RenderMode::Single)
+        {
+            renderer = new Renderer(width, height);
+            renderer->SetUploadThread(uploader);
+            renderer->SetColorFormat(settings.colorFormat);
+            renderer->SetSamples(settings.msaaSamples);
+            renderer->SetResolutionBudget(resolutionBudget);
+            renderer->Init();
+            renderer->SetSceneWorkload(settings.renderLoad);
+        }
+        else if (settings.renderMode == RenderMode::Multi)
+        {
+            pool = new WorkerPool(context, width, height, settings.workerCount);
+            pool->SetQueueDepth(settings.queueDepth);
+            pool->SetColorFormat(settings.colorFormat);
+            pool->SetSamples(settings.msaaSamples);
+            pool->SetResolutionBudget(resolutionBudget);
+            pool->SetPresentMode(settings.presentMode);
+            pool->SetPacing(settings.pacingMode, settings.targetFps);
+            pool->SetUploadThread(uploader);
+            CommandList commands;
+            commands.SetWorkload(settings.renderLoad);
+            pool->SubmitCommands(commands);
+            pool->Start();
+        }
+        else
+        {
+            split = new SplitFrameRenderer(context, width, height);
+            split->Configure(settings.sfrThreads, settings.sfrTiles);
+            split->SetBalance(settings.tileBalance);
+            split->SetColorFormat(settings.colorFormat);
+            split->SetSamples(settings.msaaSamples);
+            split->SetUploadThread(uploader);
+            split->SetSceneWorkload(settings.renderLoad);
+            split->Start();
+        }
+
+        SceneRecorder *recorder = settings.recordPath.empty() ? nullptr : new SceneRecorder(settings.recordPath.c_str());
+        ScenePlayer *player = settings.replayPath.empty() ? nullptr : new ScenePlayer(settings.replayPath.c_str());
+
+        // 异步回读：每个取到的新帧都发起一次；开启帧流输出或图像导出时回调把像素交给它们的线程
+        StreamSink *sink = nullptr;
+        if (!settings.sinkPath.empty())
+            sink = new StreamSink(settings.sinkPath, settings.sinkFormat, settings.sinkPolicy, settings.sinkFps, settings.sinkQueue);
+        ImageExporter *exporter = nullptr;
+        if (!settings.exportDir.empty())
+        {
+            exporter = new ImageExporter(settings.exportDir, settings.exportFormat, settings.exportThreads, settings.exportEvery, settings.exportInFlight);
+            // 帧序号来自外部时，文件编号与全局帧序号一致，多个进程的输出可以放进同一目录
+            exporter->SetNameByFrameIndex(source != nullptr);
+        }
+        FrameServer *frameServer = nullptr;
+        if (!settings.shmName.empty())
+            frameServer = new FrameServer(settings.shmName, settings.shmSlots, width, height);
+        FrameContainer *container = nullptr;
+        if (!settings.containerPath.empty())
+            container = new FrameContainer(settings.containerPath, ContainerCapacity(settings), width, height);
+        FrameReadback::Callback callback = nullptr;
+        if (sink || exporter || frameServer || container)
+        {
+            callback = [sink, exporter, frameServer, container](const ReadbackFrame &frame) {
+                // 共享内存发布与帧容器写入都只是一次 memcpy，放在可能阻塞的输出之前
+                if (frameServer)
+                    frameServer->Publish(frame);
+                if (container)
+                    container->Write(frame);
+                if (sink)
+                    sink->Push(frame);
+                if (exporter)
+                    exporter->Push(frame);
+            };
+        }
+        FrameReadback *readback = settings.readbackDepth > 0 ? new FrameReadback(settings.readbackDepth, callback, settings.yuvMatrix, settings.yuvRange) : nullptr;
+        DamageTracker *damage = readback && settings.damageKeyframe > 0 ? new DamageTracker(settings.damageKeyframe, settings.damageTile) : nullptr;
+        if (readback)
+            readback->SetDamageTracker(damage);
+        int residentCount = 0;
+
+        // 单线程模式没有 SwapBuffers 节流：最多允许两帧在 GPU 上排队
+        GLsync inFlight[2] = {nullptr, nullptr};
+
+        auto start = clock::now();
+        auto end = start + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(settings.durationSeconds));
+        auto lastReport = start;
+        unsigned long long reportFrames = 0;
+        uint64_t simFrame = 0;
+        float aspect = (float)width / (float)height;
+
+        while (source || (clock::now() < end && (settings.frameLimit <= 0 || (long long)report.presentedFrames < settings.frameLimit)))
+        {
+            // 外部帧来源：渲染分配到的帧序号，没有更多帧时结束
+            uint64_t sourceFrame = 0;
+            if (source && !source->NextFrame(sourceFrame))
+                break;
+
+            SimulateLogicLoad(settings.cpuLoad);
+
+            SceneState state;
+            if (!player || !player->Next(state))
+            {
+                if (settings.script.active || source)
+                {
+                    // 按输出帧序号推进场景时间，结果与渲染速度无关
+                    uint64_t outputFrame = source ? sourceFrame : report.presentedFrames;
+                    double time = outputFrame / (double)settings.targetFps;
+                    double progress = settings.frameLimit > 1 ? outputFrame / (double)(settings.frameLimit - 1) : 0.0;
+                    state = SimulateScene(simFrame + 1, time, aspect, orbitMesh);
+                    if (settings.script.active)
+                        settings.script.Apply(state, progress, time, aspect);
+                }
+                else
+                {
+                    state = SimulateScene(simFrame + 1, std::chrono::duration<double>(clock::now() - start).count(), aspect, orbitMesh);
+                }
+            }
+            state.frame = ++simFrame;
+            if (recorder)
+                recorder->Write(state);
+            if (damage)
+            {
+                damage->Record(state);
+                if (orbitMesh >= 0)
+                {
+                    glm::vec3 extent(Scene::TorusMajor + Scene::TorusMinor, Scene::TorusMinor, Scene::TorusMajor + Scene::TorusMinor);
+                    damage->SetMeshBounds(orbitMesh, -extent, extent);
+                }
+                // 新驻留的网格或纹理改变画面但不改变快照
+                int resident = uploader->CountResident();
+                if (resident != residentCount)
+                    damage->Invalidate(simFrame);
+                residentCount = resident;
+            }
+
+            bool presented = false;
+            if (renderer)
+            {
+                int index = (int)(simFrame & 1);
+                if (inFlight[index])
+                {
+                    glClientWaitSync(inFlight[index], GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+                    glDeleteSync(inFlight[index]);
+                }
+                renderer->RenderOffscreen(state);
+                if (readback)
+                    readback->ReadTexture(renderer->GetTextureID(), renderer->GetTextureWidth(), renderer->GetTextureHeight(),
+                                          source ? sourceFrame : simFrame, simFrame);
+                inFlight[index] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+                glFlush();
+                presented = true;
+            }
+            else if (pool)
+            {
+                pool->PublishScene(state);
+                unsigned int tex = pool->TryGetReadyTexture();
+                presented = tex != 0;
+                if (presented && readback)
+                    readback->ReadTexture(tex, report.presentedFrames + 1, pool->GetSceneFrame());
+            }
+            else
+            {
+                split->PublishScene(state);
+                presented = split->TryAcquireFrame();
+                if (presented && readback)
+                    split->Readback(readback);
+            }
+            if (readback)
+                readback->Poll();
+
+            if (presented)
+            {
+                report.presentedFrames++;
+                reportFrames++;
+            }
+            else
+            {
+                // 没有新帧时短暂让出 CPU，代替交互模式下的 SwapBuffers 等待
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }
+
+            auto now = clock::now();
+            std::chrono::duration<double> elapsed = now - lastReport;
+            if (elapsed.count() >= 1.0)
+            {
+                // Worker 与分块线程的帧率按各自的一秒窗口统计，第一个窗口结束前为 0，此时不输出渲染帧率
+                double renderFps = pool ? pool->GetFPS() : split ? split->GetFPS() : reportFrames / elapsed.count();
+                std::cout << "[" << Fixed(std::chrono::duration<double>(now - start).count(), 1, 6) << "s] 呈现: "
+                          << Fixed(reportFrames / elapsed.count(), 1, 7) << " 帧/s";
+                if (renderFps > 0.0)
+                    std::cout << "  渲染: " << Fixed(renderFps, 1, 7) << " 帧/s";
+                std::cout << "  已上传: " << Fixed(ToMB(uploader->GetUploadedBytes()), 1) << " MB";
+                if (readback)
+                    std::cout << "  回读: " << Fixed(readback->GetLatencyMs(), 2) << " ms  " << Fixed(readback->GetThroughputMBps(), 1) << " MB/s";
+                if (exporter)
+                    std::cout << "  导出: " << exporter->GetWrittenFrames() << " 帧  在途: " << exporter->GetInFlight();
+                std::cout << std::endl;
+                reportFrames = 0;
+                lastReport = now;
+            }
+        }
+
+        report.seconds = std::chrono::duration<double>(clock::now() - start).count();
+        report.presentFps = report.seconds > 0.0 ? report.presentedFrames / report.seconds : 0.0;
+        report.renderedFrames = pool ? pool->GetRenderedFrames() : report.presentedFrames;
+        report.droppedFrames = pool ? pool->GetDroppedFrames() : 0;
+        if (renderer)
+        {
+            report.gpuSceneMs = renderer->GetSceneGpuMs();
+            report.gpuResolveMs = renderer->GetResolveGpuMs();
+        }
+        RenderTargetStats targetStats = RenderTargetPool::GetTotalStats();
+        report.peakUnaliasedBytes = targetStats.peakUnaliasedBytes;
+        report.peakBytes = targetStats.peakBytes;
+        if (renderer || pool)
+        {
+            const DynamicResolution &resolution = renderer ? renderer->GetResolution() : pool->GetResolution();
+            report.resolutionPercent = resolution.GetPercent();
+            report.resolutionChanges = resolution.GetChanges();
+        }
+
+        if (readback)
+        {
+            // 在释放渲染端之前取回所有在途的帧
+            readback->Flush();
+            report.readbackFrames = readback->GetDeliveredFrames();
+            report.readbackSkipped = readback->GetSkippedFrames();
+            report.readbackLatencyMs = readback->GetAverageLatencyMs();
+            report.readbackMBps = readback->GetSustainedMBps();
+            delete readback;
+        }
+        if (damage)
+        {
+            report.damageKeyframes = damage->GetKeyframes();
+            report.damageDeltaFrames = damage->GetDeltaFrames();
+            report.damageCoverage = damage->GetAverageCoverage();
+            delete damage;
+        }
+        if (sink)
+        {
+            sink->Close();
+            report.sinkWrittenFrames = sink->GetWrittenFrames();
+            report.sinkDroppedFrames = sink->GetDroppedFrames();
+            report.sinkBlockedFrames = sink->GetBlockedFrames();
+            report.sinkBlockedMs = sink->GetBlockedMs();
+            delete sink;
+        }
+        if (exporter)
+        {
+            exporter->Close();
+            report.exportedFrames = exporter->GetWrittenFrames();
+            report.exportFps = exporter->GetFramesPerSecond();
+            report.exportPerCoreMBps = exporter->GetPerCoreMBps();
+            report.exportBlockedMs = exporter->GetBlockedMs();
+            delete exporter;
+        }
+        if (frameServer)
+        {
+            report.shmFrames = frameServer->GetPublishedFrames();
+            delete frameServer;
+        }
+        if (container)
+        {
+            container->Close();
+            report.containerFrames = container->GetWrittenFrames();
+            delete container;
+        }
+        for (GLsync fence : inFlight)
+        {
+            if (fence)
+                glDeleteSync(fence);
+        }
+        delete recorder;
+        delete player;
+        if (pool)
+            pool->Stop();
+        delete pool;
+        if (split)
+            split->Stop();
+        delete split;
+        delete renderer;
+        uploader->Stop();
+        delete uploader;
+
+        // 日志走 std::cout：帧流写到 stdout 时 main 已调用 StreamSink::ReserveStdout，这些输出会改写到 stderr
+        std::cout << "汇总  时长: " << Fixed(report.seconds, 2) << "s  呈现: " << report.presentedFrames << " 帧 ("
+                  << Fixed(report.presentFps, 1) << " 帧/s)  渲染: " << report.renderedFrames << " 帧  未呈现: "
+                  << report.droppedFrames << " 帧" << std::endl;
+        if (settings.renderMode == RenderMode::Single)
+            std::cout << "GPU  离屏绘制: " << Fixed(report.gpuSceneMs, 3) << " ms/帧  多重采样解析: " << Fixed(report.gpuResolveMs, 3)
+                      << " ms/帧" << std::endl;
+        double vramSaved = report.peakUnaliasedBytes ? 100.0 * (1.0 - (double)report.peakBytes / report.peakUnaliasedBytes) : 0.0;
+        std::cout << "显存峰值  渲染目标: " << Fixed(ToMB(report.peakBytes), 1) << " MB  瞬态附件不共享时: "
+                  << Fixed(ToMB(report.peakUnaliasedBytes), 1) << " MB  节省: " << Fixed(vramSaved, 1) << "%" << std::endl;
+        if (resolutionBudget > 0.0 && settings.renderMode != RenderMode::Split)
+            std::cout << "动态分辨率  预算: " << Fixed(resolutionBudget, 1) << " ms  结束时比例: " << report.resolutionPercent
+                      << "%  换档: " << report.resolutionChanges << " 次" << std::endl;
+        if (settings.readbackDepth > 0)
+            std::cout << "回读  深度: " << settings.readbackDepth << "  格式: " << (settings.yuvMatrix == YuvMatrix::None ? "rgba" : "i420")
+                      << "  完成: " << report.readbackFrames << " 帧  环满跳过: " << report.readbackSkipped << " 帧  平均延迟: "
+                      << Fixed(report.readbackLatencyMs, 2) << " ms  持续吞吐: " << Fixed(report.readbackMBps, 1) << " MB/s" << std::endl;
+        if (settings.damageKeyframe > 0 && settings.readbackDepth > 0)
+            std::cout << "脏矩形  关键帧间隔: " << settings.damageKeyframe << "  分块: " << settings.damageTile << " px  关键帧: "
+                      << report.damageKeyframes << "  增量帧: " << report.damageDeltaFrames << "  平均脏区域: "
+                      << Fixed(report.damageCoverage * 100.0, 1) << "%" << std::endl;
+        if (!settings.sinkPath.empty())
+            std::cout << "帧流  格式: " << SinkFormatName(settings.sinkFormat) << "  策略: " << SinkPolicyName(settings.sinkPolicy)
+                      << "  写出: " << report.sinkWrittenFrames << " 帧  丢弃: " << report.sinkDroppedFrames << " 帧  阻塞: "
+                      << report.sinkBlockedFrames << " 次 (" << Fixed(report.sinkBlockedMs, 1) << " ms)" << std::endl;
+        if (!settings.shmName.empty())
+            std::cout << "共享内存  名称: " << settings.shmName << "  槽位: " << settings.shmSlots << "  发布: " << report.shmFrames
+                      << " 帧" << std::endl;
+        if (!settings.containerPath.empty())
+            std::cout << "帧容器  文件: " << settings.containerPath << "  写入: " << report.containerFrames << " 帧" << std::endl;
+        if (!settings.exportDir.empty())
+            std::cout << "导出  格式: " << ImageFormatName(settings.exportFormat) << "  线程: " << settings.exportThreads << "  写出: "
+                      << report.exportedFrames << " 帧 (" << Fixed(report.exportFps, 1) << " 帧/s)  单核编码: "
+                      << Fixed(report.exportPerCoreMBps, 1) << " MB/s  阻塞: " << Fixed(report.exportBlockedMs, 1) << " ms" << std::endl;
+        return report;
+    }
+}
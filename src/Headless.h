@@ -0,0 +1,72 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <cstdint>
+#include <string>
+#include "RenderSettings.h"
+
+// 一次无头运行的统计结果
+struct HeadlessReport
+{
+    double seconds = 0.0;
+    unsigned long long presentedFrames = 0; // 主线程取到的新帧数
+    unsigned long long renderedFrames = 0;  // 渲染端完成的帧数（单线程模式与呈现帧数相同）
+    unsigned long long droppedFrames = 0;   // 渲染完成但未被取走的帧数
+    double presentFps = 0.0;
+    // 单线程模式离屏阶段的 GPU 耗时（毫秒，其他模式为 0）
+    double gpuSceneMs = 0.0;
+    double gpuResolveMs = 0.0;
+    // 渲染目标的显存峰值：瞬态附件各自分配时与共享后
+    size_t peakUnaliasedBytes = 0;
+    size_t peakBytes = 0;
+    // 动态分辨率结束时的比例（百分比）与换档次数
+    int resolutionPercent = 100;
+    unsigned long long resolutionChanges = 0;
+    // PBO 回读（未开启时为 0）
+    unsigned long long readbackFrames = 0;
+    unsigned long long readbackSkipped = 0;
+    double readbackLatencyMs = 0.0;
+    double readbackMBps = 0.0;
+    // 脏矩形回读（未开启时为 0）
+    unsigned long long damageKeyframes = 0;
+    unsigned long long damageDeltaFrames = 0;
+    double damageCoverage = 0.0; // 增量帧的平均脏区域比例
+    // 帧流输出（未开启时为 0）
+    unsigned long long sinkWrittenFrames = 0;
+    unsigned long long sinkDroppedFrames = 0;
+    unsigned long long sinkBlockedFrames = 0;
+    double sinkBlockedMs = 0.0;
+    // 图像序列导出（未开启时为 0）
+    unsigned long long exportedFrames = 0;
+    double exportFps = 0.0;
+    double exportPerCoreMBps = 0.0;
+    double exportBlockedMs = 0.0;
+    // 共享内存帧服务发布的帧数
+    unsigned long long shmFrames = 0;
+    // 写入帧容器的帧数
+    unsigned long long containerFrames = 0;
+};
+
+// 外部帧序号来源（例如渲染农场的协调进程分配的帧区间）。
+// 提供时 Run 不再按时长/帧数结束，而是逐帧向来源索取要渲染的帧序号，来源返回 false 时结束；
+// 场景时间按帧序号以 targetFps 的固定步长计算，同一帧无论由哪个进程渲染结果都相同。只用于单线程模式。
+class FrameSource
+{
+public:
+    virtual ~FrameSource() = default;
+    virtual bool NextFrame(uint64_t &frame) = 0;
+};
+
+// 无头模式：没有显示服务器时，通过 GLFW null 平台 + EGL surfaceless / OSMesa 创建上下文，
+// 不创建 ImGui，所有渲染只写入 FBO
+namespace Headless
+{
+    // 创建只有上下文、没有窗口的 GLFW 对象；优先使用 api 指定的接口，失败时尝试另一个
+    // 调用前必须以 GLFW_PLATFORM_NULL 初始化 GLFW
+    GLFWwindow *CreateContext(int width, int height, const std::string &api);
+
+    // 按 settings 运行到时长或帧数上限，每秒输出一行统计，结束时输出汇总
+    // context 的上下文必须在调用线程中为当前上下文
+    HeadlessReport Run(GLFWwindow *context, const RenderSettings &settings, int width, int height, FrameSource *source = nullptr);
+}
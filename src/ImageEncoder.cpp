@@ -0,0 +1,428 @@
+#include "ImageEncoder.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+const char *ImageFormatName(ImageFormat format)
+{
+    switch (format)
+    {
+    case ImageFormat::Png:
+        return "png";
+    case ImageFormat::Qoi:
+        return "qoi";
+    }
+    return "unknown";
+}
+
+bool ParseImageFormat(const char *name, ImageFormat &format)
+{
+    for (ImageFormat f : {ImageFormat::Png, ImageFormat::Qoi})
+    {
+        if (std::strcmp(name, ImageFormatName(f)) == 0)
+        {
+            format = f;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char *ImageFormatExtension(ImageFormat format)
+{
+    return format == ImageFormat::Png ? ".png" : ".qoi";
+}
+
+static void PutU32BE(std::vector<unsigned char> &out, uint32_t value)
+{
+    out.push_back((unsigned char)(value >> 24));
+    out.push_back((unsigned char)(value >> 16));
+    out.push_back((unsigned char)(value >> 8));
+    out.push_back((unsigned char)value);
+}
+
+// ---------------------------------------------------------------------------
+// deflate（RFC 1951）：单个固定 Huffman 块 + 哈希链 LZ77
+// ---------------------------------------------------------------------------
+
+namespace
+{
+    class BitWriter
+    {
+    public:
+        explicit BitWriter(std::vector<unsigned char> &out) : out(out) {}
+
+        // 按 LSB 优先写入 count 位
+        void Put(uint32_t value, int count)
+        {
+            bits |= (uint64_t)value << used;
+            used += count;
+            while (used >= 8)
+            {
+                out.push_back((unsigned char)bits);
+                bits >>= 8;
+                used -= 8;
+            }
+        }
+
+        // Huffman 码按 MSB 优先存储，写入前需要位反转
+        void PutCode(uint32_t code, int length)
+        {
+            uint32_t reversed = 0;
+            for (int i = 0; i < length; ++i)
+                reversed |= ((code >> i) & 1u) << (length - 1 - i);
+            Put(reversed, length);
+        }
+
+        void Finish()
+        {
+            if (used > 0)
+                out.push_back((unsigned char)bits);
+            bits = 0;
+            used = 0;
+        }
+
+    private:
+        std::vector<unsigned char> &out;
+        uint64_t bits = 0;
+        int used = 0;
+    };
+
+    const int LengthBase[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+    const int LengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+    const int DistanceBase[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                                  257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+    const int DistanceExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                   7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+    const int WindowSize = 32768;
+    const int HashBits = 15;
+    const int MaxMatch = 258;
+    const int MaxChain = 16;       // 每个位置最多比较的候选数，控制编码速度
+    const int MaxInsertLength = 16; // 更长的匹配只登记起点（大片纯色区域不逐字节进哈希表）
+
+    void PutLiteral(BitWriter &writer, int symbol)
+    {
+        if (symbol < 144)
+            writer.PutCode(0x30 + symbol, 8);
+        else if (symbol < 256)
+            writer.PutCode(0x190 + symbol - 144, 9);
+        else if (symbol < 280)
+            writer.PutCode(symbol - 256, 7);
+        else
+            writer.PutCode(0xc0 + symbol - 280, 8);
+    }
+
+    void PutMatch(BitWriter &writer, int length, int distance)
+    {
+        int l = 28;
+        while (LengthBase[l] > length)
+            --l;
+        PutLiteral(writer, 257 + l);
+        writer.Put(length - LengthBase[l], LengthExtra[l]);
+
+        int d = 29;
+        while (DistanceBase[d] > distance)
+            --d;
+        writer.PutCode(d, 5);
+        writer.Put(distance - DistanceBase[d], DistanceExtra[d]);
+    }
+
+    inline uint32_t Hash3(const unsigned char *p)
+    {
+        uint32_t v = (uint32_t)p[0] << 16 | (uint32_t)p[1] << 8 | p[2];
+        return (v * 2654435761u) >> (32 - HashBits);
+    }
+
+    void Deflate(const unsigned char *data, size_t size, std::vector<unsigned char> &out)
+    {
+        BitWriter writer(out);
+        writer.Put(1, 1); // BFINAL
+        writer.Put(1, 2); // BTYPE = 01，固定 Huffman
+
+        std::vector<int> head(1 << HashBits, -1);
+        std::vector<int> prev(WindowSize, -1);
+        auto insert = [&](size_t pos) {
+            uint32_t h = Hash3(data + pos);
+            prev[pos & (WindowSize - 1)] = head[h];
+            head[h] = (int)pos;
+        };
+
+        size_t pos = 0;
+        while (pos < size)
+        {
+            int bestLength = 0, bestDistance = 0;
+            if (pos + 3 <= size)
+            {
+                int maxLength = (int)std::min<size_t>(MaxMatch, size - pos);
+                int candidate = head[Hash3(data + pos)];
+                for (int chain = 0; chain < MaxChain && candidate >= 0; ++chain)
+                {
+                    int distance = (int)(pos - candidate);
+                    if (distance > WindowSize)
+                        break;
+                    const unsigned char *a = data + candidate;
+                    const unsigned char *b = data + pos;
+                    if (a[bestLength] == b[bestLength])
+                    {
+                        int length = 0;
+                        while (length < maxLength && a[length] == b[length])
+                            ++length;
+                        if (length > bestLength)
+                        {
+                            bestLength = length;
+                            bestDistance = distance;
+                            if (length == maxLength)
+                                break;
+                        }
+                    }
+                    int next = prev[candidate & (WindowSize - 1)];
+                    if (next >= candidate)
+                        break; // 该槽位已被更新的位置覆盖
+                    candidate = next;
+                }
+            }
+
+            if (bestLength >= 3)
+            {
+                PutMatch(writer, bestLength, bestDistance);
+                size_t end = pos + bestLength;
+                if (bestLength > MaxInsertLength)
+                {
+                    insert(pos);
+                    pos = end;
+                }
+                for (; pos < end; ++pos)
+                {
+                    if (pos + 3 <= size)
+                        insert(pos);
+                }
+            }
+            else
+            {
+                PutLiteral(writer, data[pos]);
+                if (pos + 3 <= size)
+                    insert(pos);
+                ++pos;
+            }
+        }
+        PutLiteral(writer, 256); // 块结束
+        writer.Finish();
+    }
+
+    uint32_t Adler32(const unsigned char *data, size_t size)
+    {
+        uint32_t a = 1, b = 0;
+        while (size > 0)
+        {
+            // 5552 是保证 b 不溢出的最大分段长度
+            size_t block = std::min<size_t>(size, 5552);
+            for (size_t i = 0; i < block; ++i)
+            {
+                a += data[i];
+                b += a;
+            }
+            a %= 65521;
+            b %= 65521;
+            data += block;
+            size -= block;
+        }
+        return b << 16 | a;
+    }
+
+    uint32_t Crc32(const unsigned char *data, size_t size)
+    {
+        static const struct Table
+        {
+            uint32_t entries[256];
+            Table()
+            {
+                for (uint32_t n = 0; n < 256; ++n)
+                {
+                    uint32_t c = n;
+                    for (int k = 0; k < 8; ++k)
+                        c = c & 1 ? 0xedb88320u ^ (c >> 1) : c >> 1;
+                    entries[n] = c;
+                }
+            }
+        } table;
+
+        uint32_t crc = 0xffffffffu;
+        for (size_t i = 0; i < size; ++i)
+            crc = table.entries[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+        return crc ^ 0xffffffffu;
+    }
+
+    void PutChunk(std::vector<unsigned char> &out, const char *type, const unsigned char *data, size_t size)
+    {
+        PutU32BE(out, (uint32_t)size);
+        size_t start = out.size();
+        out.insert(out.end(), type, type + 4);
+        if (size > 0)
+            out.insert(out.end(), data, data + size);
+        PutU32BE(out, Crc32(out.data() + start, out.size() - start));
+    }
+
+    inline int Paeth(int a, int b, int c)
+    {
+        int p = a + b - c;
+        int pa = std::abs(p - a), pb = std::abs(p - b), pc = std::abs(p - c);
+        if (pa <= pb && pa <= pc)
+            return a;
+        return pb <= pc ? b : c;
+    }
+
+    void EncodePng(const unsigned char *rgba, int width, int height, std::vector<unsigned char> &out)
+    {
+        size_t rowBytes = (size_t)width * 4;
+
+        // 行过滤：每行在 None/Sub/Up/Paeth 中选绝对值和最小的一种
+        std::vector<unsigned char> filtered(height * (rowBytes + 1));
+        std::vector<unsigned char> candidates[4];
+        for (auto &c : candidates)
+            c.resize(rowBytes);
+        std::vector<unsigned char> zeroRow(rowBytes, 0);
+
+        for (int y = 0; y < height; ++y)
+        {
+            const unsigned char *row = rgba + (size_t)(height - 1 - y) * rowBytes;
+            const unsigned char *up = y > 0 ? rgba + (size_t)(height - y) * rowBytes : zeroRow.data();
+            uint64_t costs[4] = {0, 0, 0, 0};
+            for (size_t i = 0; i < rowBytes; ++i)
+            {
+                int left = i >= 4 ? row[i - 4] : 0;
+                int upLeft = i >= 4 ? up[i - 4] : 0;
+                unsigned char values[4] = {
+                    row[i],
+                    (unsigned char)(row[i] - left),
+                    (unsigned char)(row[i] - up[i]),
+                    (unsigned char)(row[i] - Paeth(left, up[i], upLeft))};
+                for (int f = 0; f < 4; ++f)
+                {
+                    candidates[f][i] = values[f];
+                    costs[f] += std::abs((int)(signed char)values[f]);
+                }
+            }
+            static const unsigned char filterTypes[4] = {0, 1, 2, 4}; // None, Sub, Up, Paeth
+            int best = (int)(std::min_element(costs, costs + 4) - costs);
+            unsigned char *dst = filtered.data() + y * (rowBytes + 1);
+            dst[0] = filterTypes[best];
+            std::memcpy(dst + 1, candidates[best].data(), rowBytes);
+        }
+
+        std::vector<unsigned char> zlib;
+        zlib.reserve(filtered.size() / 2);
+        zlib.push_back(0x78); // CM = 8（deflate），32K 窗口
+        zlib.push_back(0x01);
+        Deflate(filtered.data(), filtered.size(), zlib);
+        PutU32BE(zlib, Adler32(filtered.data(), filtered.size()));
+
+        static const unsigned char signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+        out.assign(signature, signature + 8);
+
+        std::vector<unsigned char> header;
+        PutU32BE(header, (uint32_t)width);
+        PutU32BE(header, (uint32_t)height);
+        header.push_back(8); // 位深
+        header.push_back(6); // RGBA
+        header.push_back(0); // 压缩方法
+        header.push_back(0); // 过滤方法
+        header.push_back(0); // 不隔行
+        PutChunk(out, "IHDR", header.data(), header.size());
+        PutChunk(out, "IDAT", zlib.data(), zlib.size());
+        PutChunk(out, "IEND", nullptr, 0);
+    }
+
+    // ---------------------------------------------------------------------------
+    // QOI（https://qoiformat.org/qoi-specification.pdf）
+    // ---------------------------------------------------------------------------
+
+    void EncodeQoi(const unsigned char *rgba, int width, int height, std::vector<unsigned char> &out)
+    {
+        out.clear();
+        out.reserve((size_t)width * height * 2);
+        out.insert(out.end(), {'q', 'o', 'i', 'f'});
+        PutU32BE(out, (uint32_t)width);
+        PutU32BE(out, (uint32_t)height);
+        out.push_back(4); // RGBA
+        out.push_back(0); // sRGB + 线性 alpha
+
+        unsigned char index[64][4] = {};
+        unsigned char prev[4] = {0, 0, 0, 255};
+        int run = 0;
+        size_t rowBytes = (size_t)width * 4;
+        size_t last = (size_t)width * height - 1, n = 0;
+
+        for (int y = 0; y < height; ++y)
+        {
+            const unsigned char *row = rgba + (size_t)(height - 1 - y) * rowBytes;
+            for (int x = 0; x < width; ++x, ++n)
+            {
+                const unsigned char *px = row + x * 4;
+                if (std::memcmp(px, prev, 4) == 0)
+                {
+                    run++;
+                    if (run == 62 || n == last)
+                    {
+                        out.push_back((unsigned char)(0xc0 | (run - 1)));
+                        run = 0;
+                    }
+                    continue;
+                }
+                if (run > 0)
+                {
+                    out.push_back((unsigned char)(0xc0 | (run - 1)));
+                    run = 0;
+                }
+
+                int slot = (px[0] * 3 + px[1] * 5 + px[2] * 7 + px[3] * 11) % 64;
+                if (std::memcmp(index[slot], px, 4) == 0)
+                {
+                    out.push_back((unsigned char)slot);
+                }
+                else
+                {
+                    std::memcpy(index[slot], px, 4);
+                    if (px[3] == prev[3])
+                    {
+                        signed char vr = (signed char)(px[0] - prev[0]);
+                        signed char vg = (signed char)(px[1] - prev[1]);
+                        signed char vb = (signed char)(px[2] - prev[2]);
+                        signed char vgr = (signed char)(vr - vg);
+                        signed char vgb = (signed char)(vb - vg);
+                        if (vr > -3 && vr < 2 && vg > -3 && vg < 2 && vb > -3 && vb < 2)
+                        {
+                            out.push_back((unsigned char)(0x40 | (vr + 2) << 4 | (vg + 2) << 2 | (vb + 2)));
+                        }
+                        else if (vgr > -9 && vgr < 8 && vg > -33 && vg < 32 && vgb > -9 && vgb < 8)
+                        {
+                            out.push_back((unsigned char)(0x80 | (vg + 32)));
+                            out.push_back((unsigned char)((vgr + 8) << 4 | (vgb + 8)));
+                        }
+                        else
+                        {
+                            out.insert(out.end(), {0xfe, px[0], px[1], px[2]});
+                        }
+                    }
+                    else
+                    {
+                        out.insert(out.end(), {0xff, px[0], px[1], px[2], px[3]});
+                    }
+                }
+                std::memcpy(prev, px, 4);
+            }
+        }
+        out.insert(out.end(), {0, 0, 0, 0, 0, 0, 0, 1});
+    }
+}
+
+void EncodeImage(ImageFormat format, const unsigned char *rgba, int width, int height, std::vector<unsigned char> &out)
+{
+    if (format == ImageFormat::Png)
+        EncodePng(rgba, width, height, out);
+    else
+        EncodeQoi(rgba, width, height, out);
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <vector>
+
+// 图像序列格式
+enum class ImageFormat
+{
+    Png, // 自适应行过滤 + 固定 Huffman deflate，无外部依赖
+    Qoi  // Quite OK Image，编码速度远高于 PNG，压缩率略低
+};
+
+const char *ImageFormatName(ImageFormat format);
+bool ParseImageFormat(const char *name, ImageFormat &format);
+// 文件扩展名（含点）
+const char *ImageFormatExtension(ImageFormat format);
+
+// 把 RGBA8 像素编码为完整的图像文件内容，写入 out（覆盖原内容）。
+// rgba 的行序自底向上（OpenGL 回读约定），编码时翻转为自顶向下。
+// 只读参数、不使用全局状态，可在多个线程中并行调用。
+void EncodeImage(ImageFormat format, const unsigned char *rgba, int width, int height, std::vector<unsigned char> &out);
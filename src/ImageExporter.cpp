@@ -0,0 +1,248 @@
+#include "ImageExporter.h"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+
+ImageExporter::ImageExporter(const std::string &directory, ImageFormat format, int threadCount, int every, int maxInFlight)
+    : directory(directory), format(format), every(std::max(1, every)), maxInFlight(std::max(1, maxInFlight))
+{
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if (error)
+    {
+        std::fprintf(stderr, "无法创建导出目录 %s: %s\n", directory.c_str(), error.message().c_str());
+        return;
+    }
+    open = true;
+
+    threadCount = std::max(1, threadCount);
+    stats.resize(threadCount);
+    for (int i = 0; i < threadCount; ++i)
+        threads.emplace_back(&ImageExporter::EncoderMain, this, i);
+    std::printf("图像序列导出: %s  格式: %s  编码线程: %d  间隔: 每 %d 帧  在途上限: %d 帧\n",
+                directory.c_str(), ImageFormatName(format), threadCount, this->every, this->maxInFlight);
+}
+
+ImageExporter::~ImageExporter()
+{
+    Close();
+}
+
+void ImageExporter::Push(const ReadbackFrame &frame)
+{
+    if (!open)
+        return;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    if (closing)
+        return;
+    // 按全局帧序号命名时间隔也按帧序号计算，各进程挑出的帧互不重叠也不遗漏
+    uint64_t pick = nameByFrameIndex ? frame.frameIndex : pushedFrames;
+    pushedFrames++;
+    changedSinceExport |= frame.keyframe || frame.damageCount > 0 || frame.format != ReadbackFormat::Rgba8;
+    if (pick % every != 0)
+        return;
+    bool repeat = !changedSinceExport && frame.width == lastWidth && frame.height == lastHeight;
+    changedSinceExport = false;
+    lastWidth = frame.width;
+    lastHeight = frame.height;
+    if (nextSequence == 0)
+        firstPush = clock::now();
+
+    // 在途帧达到上限：阻塞生产者，内存占用不会随编码落后而增长
+    if (inFlight >= maxInFlight)
+    {
+        auto start = clock::now();
+        slotFree.wait(lock, [this]() { return inFlight < maxInFlight; });
+        blockedMs += std::chrono::duration<double, std::milli>(clock::now() - start).count();
+    }
+
+    Job job;
+    job.sequence = nextSequence++;
+    job.frameIndex = frame.frameIndex;
+    inFlight++;
+    job.width = frame.width;
+    job.height = frame.height;
+    job.repeat = repeat;
+    if (repeat)
+    {
+        jobs.push_back(std::move(job));
+        lock.unlock();
+        jobReady.notify_one();
+        return;
+    }
+    if (!freeBuffers.empty())
+    {
+        job.pixels = std::move(freeBuffers.back());
+        freeBuffers.pop_back();
+    }
+    lock.unlock();
+
+    // 拷贝在锁外进行，编码线程不会被一帧的 memcpy 阻塞
+    size_t bytes = (size_t)frame.width * frame.height * 4;
+    job.pixels.assign(frame.pixels, frame.pixels + bytes);
+
+    lock.lock();
+    jobs.push_back(std::move(job));
+    lock.unlock();
+    jobReady.notify_one();
+}
+
+void ImageExporter::Close()
+{
+    if (!open)
+        return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        closing = true;
+    }
+    jobReady.notify_all();
+    for (std::thread &thread : threads)
+        thread.join();
+    threads.clear();
+    open = false;
+
+    std::printf("导出结束  写出: %llu 帧  压缩比: %.1f%%  平均: %.1f 帧/s  阻塞: %.1f ms\n",
+                writtenFrames, GetCompressionRatio() * 100.0, GetFramesPerSecond(), blockedMs);
+    if (repeatedFrames > 0)
+        std::printf("  画面未变化、复用上一帧编码: %llu 帧\n", repeatedFrames);
+    for (size_t i = 0; i < stats.size(); ++i)
+    {
+        const ThreadStats &s = stats[i];
+        double mbps = s.busySeconds > 0.0 ? s.inputBytes / (1024.0 * 1024.0) / s.busySeconds : 0.0;
+        double msPerFrame = s.frames > 0 ? s.busySeconds * 1000.0 / s.frames : 0.0;
+        std::printf("  编码线程 %zu: %llu 帧  %.1f ms/帧  %.1f MB/s\n", i, s.frames, msPerFrame, mbps);
+    }
+    std::fflush(stdout);
+}
+
+void ImageExporter::EncoderMain(int index)
+{
+    std::vector<unsigned char> output;
+    while (true)
+    {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            jobReady.wait(lock, [this]() { return closing || !jobs.empty(); });
+            // 关闭时先编完队列中剩余的帧
+            if (jobs.empty())
+                break;
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+
+        auto start = clock::now();
+        if (!job.repeat)
+            EncodeImage(format, job.pixels.data(), job.width, job.height, output);
+        double seconds = std::chrono::duration<double>(clock::now() - start).count();
+
+        std::unique_lock<std::mutex> lock(mutex);
+        if (job.repeat)
+        {
+            repeatedFrames++;
+        }
+        else
+        {
+            ThreadStats &s = stats[index];
+            s.frames++;
+            s.busySeconds += seconds;
+            s.inputBytes += job.pixels.size();
+            inputBytes += job.pixels.size();
+            freeBuffers.push_back(std::move(job.pixels));
+        }
+        encoded[job.sequence] = {nameByFrameIndex ? job.frameIndex : job.sequence, std::move(output)};
+        output = std::vector<unsigned char>();
+
+        // 乱序完成、按序写盘：同一时刻只有一个线程负责写，其余线程继续编码
+        if (writing)
+            continue;
+        writing = true;
+        while (!encoded.empty() && encoded.begin()->first == nextWrite)
+        {
+            uint64_t number = encoded.begin()->second.first;
+            std::vector<unsigned char> data = std::move(encoded.begin()->second.second);
+            encoded.erase(encoded.begin());
+            lock.unlock();
+            if (!data.empty())
+                lastOutput = std::move(data);
+            WriteFile(number, lastOutput);
+            lock.lock();
+            outputBytes += lastOutput.size();
+            writtenFrames++;
+            nextWrite++;
+            inFlight--;
+            lastWrite = clock::now();
+            slotFree.notify_one();
+        }
+        writing = false;
+    }
+}
+
+bool ImageExporter::WriteFile(uint64_t number, const std::vector<unsigned char> &data)
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "frame_%06llu%s", (unsigned long long)number, ImageFormatExtension(format));
+    std::string path = (std::filesystem::path(directory) / name).string();
+
+    FILE *file = std::fopen(path.c_str(), "wb");
+    bool ok = file && std::fwrite(data.data(), 1, data.size(), file) == data.size();
+    if (file)
+        ok = std::fclose(file) == 0 && ok;
+    if (!ok)
+        std::fprintf(stderr, "写入 %s 失败\n", path.c_str());
+    return ok;
+}
+
+int ImageExporter::GetInFlight() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return inFlight;
+}
+
+unsigned long long ImageExporter::GetWrittenFrames() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return writtenFrames;
+}
+
+unsigned long long ImageExporter::GetRepeatedFrames() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return repeatedFrames;
+}
+
+double ImageExporter::GetBlockedMs() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return blockedMs;
+}
+
+double ImageExporter::GetFramesPerSecond() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    double seconds = std::chrono::duration<double>(lastWrite - firstPush).count();
+    return writtenFrames > 1 && seconds > 0.0 ? writtenFrames / seconds : 0.0;
+}
+
+double ImageExporter::GetPerCoreMBps() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    double busy = 0.0;
+    for (const ThreadStats &s : stats)
+        busy += s.busySeconds;
+    return busy > 0.0 ? inputBytes / (1024.0 * 1024.0) / busy : 0.0;
+}
+
+double ImageExporter::GetCompressionRatio() const
+{
+    // outputBytes 只统计已写盘的帧，对应的输入按帧平均估算
+    std::lock_guard<std::mutex> lock(mutex);
+    unsigned long long encodedFrames = 0;
+    for (const ThreadStats &s : stats)
+        encodedFrames += s.frames;
+    if (writtenFrames == 0 || encodedFrames == 0)
+        return 0.0;
+    double inputPerFrame = (double)inputBytes / encodedFrames;
+    return outputBytes / (inputPerFrame * writtenFrames);
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "FrameReadback.h"
+#include "ImageEncoder.h"
+
+// 图像序列导出：把回读到的帧（每 N 帧取一帧）编码为编号连续的 PNG / QOI 文件。
+// 编码在线程池中乱序并行进行，完成的帧按序号顺序写盘；
+// 在途帧（已入队、编码中、等待写盘）数量有上限，达到上限时 Push 阻塞生产者，不丢帧。
+// 回读带脏矩形时，自上一个导出帧以来画面没有任何变化的帧不再拷贝与编码，直接重复写出上一帧的编码结果。
+class ImageExporter
+{
+public:
+    // directory 不存在时自动创建；文件名为 frame_000000.png 起的连续编号
+    ImageExporter(const std::string &directory, ImageFormat format, int threads, int every, int maxInFlight);
+    ~ImageExporter();
+
+    bool IsOpen() const { return open; }
+    // 以回读帧的 frameIndex 而不是导出顺序命名文件（多个进程分段导出同一序列时使用）
+    void SetNameByFrameIndex(bool enabled) { nameByFrameIndex = enabled; }
+
+    // 主线程（回读回调）：按间隔挑选并入队一帧
+    void Push(const ReadbackFrame &frame);
+    // 等待所有在途帧写完并停止线程池，输出每个编码线程的统计
+    void Close();
+
+    int GetThreadCount() const { return (int)threads.size(); }
+    int GetInFlight() const;
+    unsigned long long GetWrittenFrames() const;
+    // 画面未变化、复用上一帧编码结果的帧数
+    unsigned long long GetRepeatedFrames() const;
+    // 等待在途帧上限的累计时间
+    double GetBlockedMs() const;
+    // 全部编码线程的平均吞吐与按编码忙碌时间计算的单核吞吐（以输入的 RGBA 字节计）
+    double GetFramesPerSecond() const;
+    double GetPerCoreMBps() const;
+    // 输出文件总大小相对原始 RGBA 的比例
+    double GetCompressionRatio() const;
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    struct Job
+    {
+        uint64_t sequence = 0;
+        uint64_t frameIndex = 0;
+        int width = 0, height = 0;
+        bool repeat = false; // 与上一个导出帧相同，不编码
+        std::vector<unsigned char> pixels;
+    };
+
+    // 每个编码线程的统计（受 mutex 保护）
+    struct ThreadStats
+    {
+        unsigned long long frames = 0;
+        double busySeconds = 0.0;
+        unsigned long long inputBytes = 0;
+    };
+
+    void EncoderMain(int index);
+    bool WriteFile(uint64_t number, const std::vector<unsigned char> &data);
+
+    std::string directory;
+    ImageFormat format;
+    int every;
+    int maxInFlight;
+    bool open = false;
+    bool nameByFrameIndex = false;
+
+    std::vector<std::thread> threads;
+    std::vector<ThreadStats> stats;
+    mutable std::mutex mutex;
+    std::condition_variable jobReady;
+    std::condition_variable slotFree;
+    std::deque<Job> jobs; // 待编码，按序号先进先出
+    // 编码完成、等待按序写盘：序号 -> (文件编号, 编码结果)；编码结果为空表示重复上一帧
+    std::map<uint64_t, std::pair<uint64_t, std::vector<unsigned char>>> encoded;
+    std::vector<std::vector<unsigned char>> freeBuffers;
+    bool writing = false; // 是否已有线程在按序写盘
+    std::vector<unsigned char> lastOutput; // 最近写盘的编码结果（只由当前写盘的线程访问）
+    // 自上一个导出帧以来收到的帧是否有变化（含按间隔跳过的帧）
+    bool changedSinceExport = true;
+    int lastWidth = 0, lastHeight = 0;
+    bool closing = false;
+    int inFlight = 0;
+
+    unsigned long long pushedFrames = 0; // 收到的帧（含按间隔跳过的）
+    uint64_t nextSequence = 0;           // 下一个入队帧的输出编号
+    uint64_t nextWrite = 0;              // 下一个要写盘的输出编号
+    unsigned long long writtenFrames = 0;
+    unsigned long long repeatedFrames = 0;
+    unsigned long long inputBytes = 0;
+    unsigned long long outputBytes = 0;
+    double blockedMs = 0.0;
+    clock::time_point firstPush;
+    clock::time_point lastWrite;
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// 主线程录制、渲染线程执行的离散命令（不可丢失、按顺序执行）
+// 连续变化的场景状态（相机、物体变换、清屏颜色）不走命令流，而是通过 SceneState 三缓冲快照传递
+enum class RenderCommandType
+{
+    SetWorkload, // value: 模拟渲染负载
+    Resize       // width / height: 新的渲染目标尺寸
+};
+
+struct RenderCommand
+{
+    RenderCommandType type;
+    int value = 0;
+    int width = 0;
+    int height = 0;
+};
+
+// 主线程的命令录制器：参数变化先写入本地列表，再整体提交
+class CommandList
+{
+public:
+    void SetWorkload(int load)
+    {
+        RenderCommand cmd{RenderCommandType::SetWorkload};
+        cmd.value = load;
+        commands.push_back(cmd);
+    }
+
+    void Resize(int width, int height)
+    {
+        RenderCommand cmd{RenderCommandType::Resize};
+        cmd.width = width;
+        cmd.height = height;
+        commands.push_back(cmd);
+    }
+
+    const RenderCommand *Data() const { return commands.data(); }
+    size_t Size() const { return commands.size(); }
+    bool Empty() const { return commands.empty(); }
+    void Clear() { commands.clear(); }
+
+private:
+    std::vector<RenderCommand> commands;
+};
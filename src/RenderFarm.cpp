@@ -0,0 +1,667 @@
+#include "RenderFarm.h"
+#include "Headless.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <string>
+#include <vector>
+#ifndef _WIN32
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <spawn.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char **environ;
+#endif
+
+#ifdef _WIN32
+
+namespace Farm
+{
+    int RunCoordinator(const RenderSettings &settings, int argc, char **argv)
+    {
+        std::printf("渲染农场仅支持 POSIX 平台\n");
+        return 1;
+    }
+
+    int RunWorker(GLFWwindow *context, const RenderSettings &settings, int width, int height)
+    {
+        std::printf("渲染农场仅支持 POSIX 平台\n");
+        return 1;
+    }
+}
+
+#else
+
+namespace
+{
+    using clock = std::chrono::steady_clock;
+
+    // 地址格式：unix:路径、tcp:主机:端口，或直接写路径（视为 Unix 域套接字）
+    struct FarmAddress
+    {
+        bool tcp = false;
+        std::string path;
+        std::string host, port;
+    };
+
+    bool ParseAddress(const std::string &text, FarmAddress &address)
+    {
+        if (text.compare(0, 4, "tcp:") == 0)
+        {
+            size_t colon = text.rfind(':');
+            if (colon <= 3)
+                return false;
+            address.tcp = true;
+            address.host = text.substr(4, colon - 4);
+            address.port = text.substr(colon + 1);
+            return !address.port.empty();
+        }
+        address.path = text.compare(0, 5, "unix:") == 0 ? text.substr(5) : text;
+        return !address.path.empty() && address.path.size() < sizeof(sockaddr_un::sun_path);
+    }
+
+    int OpenSocket(const FarmAddress &address, bool listening)
+    {
+        if (!address.tcp)
+        {
+            int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+            if (fd < 0)
+                return -1;
+            sockaddr_un addr = {};
+            addr.sun_family = AF_UNIX;
+            std::strncpy(addr.sun_path, address.path.c_str(), sizeof(addr.sun_path) - 1);
+            if (listening)
+                unlink(address.path.c_str());
+            int rc = listening ? bind(fd, (sockaddr *)&addr, sizeof(addr)) : connect(fd, (sockaddr *)&addr, sizeof(addr));
+            if (rc != 0 || (listening && listen(fd, 64) != 0))
+            {
+                close(fd);
+                return -1;
+            }
+            return fd;
+        }
+
+        addrinfo hints = {};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_flags = listening ? AI_PASSIVE : 0;
+        addrinfo *result = nullptr;
+        if (getaddrinfo(address.host.empty() ? nullptr : address.host.c_str(), address.port.c_str(), &hints, &result) != 0)
+            return -1;
+        int fd = -1;
+        for (addrinfo *ai = result; ai && fd < 0; ai = ai->ai_next)
+        {
+            fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+            if (fd < 0)
+                continue;
+            int one = 1;
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+            int rc = listening ? bind(fd, ai->ai_addr, ai->ai_addrlen) : connect(fd, ai->ai_addr, ai->ai_addrlen);
+            if (rc != 0 || (listening && listen(fd, 64) != 0))
+            {
+                close(fd);
+                fd = -1;
+            }
+        }
+        freeaddrinfo(result);
+        return fd;
+    }
+
+    // 按行收发的连接；读取只在 poll 报告可读后进行，不会阻塞在半行上
+    class LineConnection
+    {
+    public:
+        explicit LineConnection(int fd) : fd(fd) {}
+
+        int GetFd() const { return fd; }
+
+        void Close()
+        {
+            if (fd >= 0)
+                close(fd);
+            fd = -1;
+        }
+
+        bool Send(const std::string &line)
+        {
+            std::string data = line + "\n";
+            size_t sent = 0;
+            while (sent < data.size())
+            {
+                ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+                if (n < 0 && errno == EINTR)
+                    continue;
+                if (n <= 0)
+                    return false;
+                sent += n;
+            }
+            return true;
+        }
+
+        // 读取一次可用数据并取出完整的行；对端关闭或出错时返回 false
+        bool Receive(std::vector<std::string> &lines)
+        {
+            char chunk[4096];
+            ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+            if (n < 0 && errno == EINTR)
+                return true;
+            if (n <= 0)
+                return false;
+            buffer.append(chunk, n);
+            size_t newline;
+            while ((newline = buffer.find('\n')) != std::string::npos)
+            {
+                lines.push_back(buffer.substr(0, newline));
+                buffer.erase(0, newline + 1);
+            }
+            return true;
+        }
+
+        // 等待可读，timeoutMs < 0 表示一直等待；超时返回 0，可读返回 1，出错返回 -1
+        int WaitReadable(int timeoutMs) const
+        {
+            pollfd p = {fd, POLLIN, 0};
+            int rc = poll(&p, 1, timeoutMs);
+            if (rc < 0)
+                return errno == EINTR ? 0 : -1;
+            return rc;
+        }
+
+    private:
+        int fd;
+        std::string buffer;
+    };
+
+    // 协调进程眼中的一个渲染进程
+    struct Peer
+    {
+        LineConnection connection{-1};
+        int pid = 0;
+        bool ready = false;      // 已收到 HELLO
+        bool busy = false;       // 持有未完成的区间
+        bool shrinking = false;  // 已发送 SHRINK，等待 SHRUNK
+        uint64_t first = 0, end = 0, next = 0;
+        double rate = 0.0; // 帧/秒（指数滑动平均）
+        uint64_t rateFrame = 0;
+        clock::time_point rateTime;
+        unsigned long long frames = 0;
+        double busySeconds = 0.0;
+        int ranges = 0;
+        int donated = 0; // 被切走的次数
+    };
+
+    class Coordinator
+    {
+    public:
+        Coordinator(uint64_t totalFrames, uint64_t chunk) : totalFrames(totalFrames)
+        {
+            for (uint64_t first = 0; first < totalFrames; first += chunk)
+                pending.push_back({first, std::min(totalFrames, first + chunk)});
+        }
+
+        ~Coordinator()
+        {
+            for (Peer *peer : peers)
+            {
+                peer->connection.Close();
+                delete peer;
+            }
+        }
+
+        bool IsComplete() const { return completedFrames >= totalFrames; }
+        uint64_t GetCompletedFrames() const { return completedFrames; }
+        const std::vector<Peer *> &GetPeers() const { return peers; }
+
+        void AddPeer(int fd)
+        {
+            Peer *peer = new Peer();
+            peer->connection = LineConnection(fd);
+            peers.push_back(peer);
+        }
+
+        // 处理所有可读的连接；返回当前仍连接的渲染进程数
+        int Poll(int listenFd, int timeoutMs)
+        {
+            std::vector<pollfd> fds;
+            fds.push_back({listenFd, POLLIN, 0});
+            for (Peer *peer : peers)
+                fds.push_back({peer->connection.GetFd(), POLLIN, 0});
+            if (poll(fds.data(), fds.size(), timeoutMs) > 0)
+            {
+                if (fds[0].revents & POLLIN)
+                {
+                    int fd = accept(listenFd, nullptr, nullptr);
+                    if (fd >= 0)
+                        AddPeer(fd);
+                }
+                for (size_t i = 1; i < fds.size(); ++i)
+                {
+                    if (!(fds[i].revents & (POLLIN | POLLHUP | POLLERR)))
+                        continue;
+                    Peer *peer = peers[i - 1];
+                    std::vector<std::string> lines;
+                    bool alive = peer->connection.Receive(lines);
+                    for (const std::string &line : lines)
+                        Handle(peer, line);
+                    if (!alive)
+                        Disconnect(peer);
+                }
+            }
+            peers.erase(std::remove_if(peers.begin(), peers.end(), [](Peer *peer) {
+                            if (peer->connection.GetFd() >= 0)
+                                return false;
+                            delete peer;
+                            return true;
+                        }),
+                        peers.end());
+            return (int)peers.size();
+        }
+
+        void QuitAll()
+        {
+            for (Peer *peer : peers)
+                peer->connection.Send("QUIT");
+        }
+
+    private:
+        void Handle(Peer *peer, const std::string &line)
+        {
+            char command[16] = {};
+            unsigned long long a = 0, b = 0;
+            double seconds = 0.0;
+            int fields = std::sscanf(line.c_str(), "%15s %llu %llu %lf", command, &a, &b, &seconds);
+            if (fields < 1)
+                return;
+
+            if (std::strcmp(command, "HELLO") == 0)
+            {
+                peer->pid = (int)a;
+                peer->ready = true;
+                Assign(peer);
+            }
+            else if (std::strcmp(command, "PROGRESS") == 0 && peer->busy)
+            {
+                auto now = clock::now();
+                double elapsed = std::chrono::duration<double>(now - peer->rateTime).count();
+                if (a > peer->rateFrame && elapsed > 0.0)
+                {
+                    double rate = (a - peer->rateFrame) / elapsed;
+                    peer->rate = peer->rate > 0.0 ? peer->rate * 0.7 + rate * 0.3 : rate;
+                }
+                peer->next = std::max<uint64_t>(peer->next, a);
+                peer->rateFrame = a;
+                peer->rateTime = now;
+            }
+            else if (std::strcmp(command, "SHRUNK") == 0)
+            {
+                // SHRINK 依据的进度可能已过时：应答必须属于当前区间，且切分点落在尚未渲染的部分
+                if (!peer->busy || a != peer->first)
+                    return;
+                peer->shrinking = false;
+                if (fields >= 3 && b >= peer->next && b < peer->end)
+                {
+                    // 切下来的尾部优先分配，交给正在等待的空闲进程
+                    pending.push_front({b, peer->end});
+                    peer->end = b;
+                    peer->donated++;
+                    for (Peer *other : peers)
+                    {
+                        if (other->ready && !other->busy && !pending.empty())
+                            Assign(other);
+                    }
+                }
+            }
+            else if (std::strcmp(command, "DONE") == 0 && fields >= 4)
+            {
+                completedFrames += b - a;
+                peer->frames += b - a;
+                peer->busySeconds += seconds;
+                peer->busy = false;
+                // 未应答的 SHRINK 作废；迟到的 SHRUNK 不带 end 或区间不匹配，会被忽略
+                peer->shrinking = false;
+                Assign(peer);
+            }
+        }
+
+        void Assign(Peer *peer)
+        {
+            if (!pending.empty())
+            {
+                auto range = pending.front();
+                pending.pop_front();
+                peer->busy = true;
+                peer->first = peer->next = peer->rateFrame = range.first;
+                peer->end = range.second;
+                peer->rateTime = clock::now();
+                peer->ranges++;
+                peer->connection.Send("RANGE " + std::to_string(range.first) + " " + std::to_string(range.second));
+                return;
+            }
+            Rebalance(peer);
+        }
+
+        // 没有待分配的区间时，从预计最晚完成的进程那里切走一部分剩余帧
+        void Rebalance(Peer *idle)
+        {
+            Peer *victim = nullptr;
+            double latest = 0.0;
+            for (Peer *peer : peers)
+            {
+                if (!peer->busy || peer->shrinking || peer == idle)
+                    continue;
+                uint64_t remaining = peer->end - std::min(peer->end, peer->next);
+                double finish = remaining / std::max(peer->rate, 0.1);
+                if (remaining >= 4 && finish > latest)
+                {
+                    latest = finish;
+                    victim = peer;
+                }
+            }
+            if (!victim)
+                return;
+
+            // 按两者的速度切分，使双方大致同时完成；速度未知时对半分
+            uint64_t remaining = victim->end - victim->next;
+            double share = victim->rate > 0.0 && idle->rate > 0.0 ? victim->rate / (victim->rate + idle->rate) : 0.5;
+            uint64_t keep = std::clamp<uint64_t>((uint64_t)(remaining * share), 1, remaining - 1);
+            victim->shrinking = true;
+            victim->connection.Send("SHRINK " + std::to_string(victim->first) + " " + std::to_string(victim->next + keep));
+        }
+
+        void Disconnect(Peer *peer)
+        {
+            // 没有报告完成的区间整个重新排队；重复渲染的帧会覆盖同名输出
+            if (peer->busy && peer->first < peer->end)
+            {
+                std::printf("渲染进程 %d 断开，区间 [%llu, %llu) 重新排队\n", peer->pid, (unsigned long long)peer->first,
+                            (unsigned long long)peer->end);
+                pending.push_front({peer->first, peer->end});
+            }
+            peer->connection.Close();
+            for (Peer *other : peers)
+            {
+                if (other != peer && other->connection.GetFd() >= 0 && other->ready && !other->busy && !pending.empty())
+                    Assign(other);
+            }
+        }
+
+        uint64_t totalFrames;
+        uint64_t completedFrames = 0;
+        std::deque<std::pair<uint64_t, uint64_t>> pending;
+        std::vector<Peer *> peers;
+    };
+
+    // 渲染进程一侧：按协调进程分配的区间逐帧提供帧序号
+    class FarmWorkerSource : public FrameSource
+    {
+    public:
+        explicit FarmWorkerSource(LineConnection &connection) : connection(connection) {}
+
+        bool NextFrame(uint64_t &frame) override
+        {
+            // 非阻塞地处理 SHRINK，并定期报告进度
+            while (connection.WaitReadable(0) > 0)
+            {
+                if (!ReadCommands())
+                    return false;
+            }
+            auto now = clock::now();
+            if (hasRange && now - lastProgress >= std::chrono::milliseconds(200))
+            {
+                connection.Send("PROGRESS " + std::to_string(next));
+                lastProgress = now;
+            }
+
+            while (!hasRange || next >= end)
+            {
+                if (hasRange)
+                {
+                    double seconds = std::chrono::duration<double>(clock::now() - rangeStart).count();
+                    char line[96];
+                    std::snprintf(line, sizeof(line), "DONE %llu %llu %.4f", (unsigned long long)first, (unsigned long long)end, seconds);
+                    connection.Send(line);
+                    framesRendered += end - first;
+                    hasRange = false;
+                }
+                if (quit || connection.WaitReadable(-1) < 0 || !ReadCommands())
+                    return false;
+                if (quit)
+                    return false;
+            }
+            frame = next++;
+            return true;
+        }
+
+        unsigned long long GetFramesRendered() const { return framesRendered; }
+
+    private:
+        bool ReadCommands()
+        {
+            std::vector<std::string> lines;
+            if (!connection.Receive(lines))
+                return false;
+            for (const std::string &line : lines)
+            {
+                unsigned long long a = 0, b = 0;
+                if (std::sscanf(line.c_str(), "RANGE %llu %llu", &a, &b) == 2)
+                {
+                    hasRange = true;
+                    first = next = a;
+                    end = b;
+                    rangeStart = lastProgress = clock::now();
+                }
+                else if (std::sscanf(line.c_str(), "SHRINK %llu %llu", &a, &b) == 2)
+                {
+                    // 只响应当前持有的区间；区间已完成时应答不带 end，协调进程不会重新排队任何帧
+                    if (!hasRange || first != a)
+                    {
+                        connection.Send("SHRUNK " + std::to_string(a));
+                        continue;
+                    }
+                    // 已经渲染过的帧不能再交出去
+                    end = std::max<uint64_t>(next, std::min<uint64_t>(end, b));
+                    connection.Send("SHRUNK " + std::to_string(first) + " " + std::to_string(end));
+                }
+                else if (line == "QUIT")
+                {
+                    quit = true;
+                }
+            }
+            return true;
+        }
+
+        LineConnection &connection;
+        bool hasRange = false;
+        bool quit = false;
+        uint64_t first = 0, next = 0, end = 0;
+        clock::time_point rangeStart, lastProgress;
+        unsigned long long framesRendered = 0;
+    };
+
+    // 渲染进程的命令行：去掉协调进程专用的参数，再加上 --farm-worker 地址
+    std::vector<std::string> WorkerArguments(int argc, char **argv, const std::string &address)
+    {
+        std::vector<std::string> args = {argv[0]};
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            if ((arg == "--farm" || arg == "--farm-listen" || arg == "--farm-chunk") && i + 1 < argc)
+            {
+                ++i;
+                continue;
+            }
+            args.push_back(arg);
+        }
+        args.push_back("--farm-worker");
+        args.push_back(address);
+        return args;
+    }
+}
+
+namespace Farm
+{
+    int RunCoordinator(const RenderSettings &settings, int argc, char **argv)
+    {
+        if (settings.frameLimit <= 0)
+        {
+            std::printf("渲染农场需要用 --frames 指定总帧数\n");
+            return 1;
+        }
+
+        std::string addressText = settings.farmListen.empty()
+            ? "unix:/tmp/offscreen-farm-" + std::to_string(getpid()) + ".sock"
+            : settings.farmListen;
+        FarmAddress address;
+        if (!ParseAddress(addressText, address))
+        {
+            std::printf("无效的农场地址: %s (格式 unix:路径 或 tcp:主机:端口)\n", addressText.c_str());
+            return 1;
+        }
+        int listenFd = OpenSocket(address, true);
+        if (listenFd < 0)
+        {
+            std::perror(("无法监听 " + addressText).c_str());
+            return 1;
+        }
+        signal(SIGPIPE, SIG_IGN);
+
+        uint64_t total = (uint64_t)settings.frameLimit;
+        int processes = settings.farmProcesses;
+        // 默认每个进程约分到 8 块，尾部再通过切分均衡
+        uint64_t chunk = settings.farmChunk > 0 ? settings.farmChunk : std::max<uint64_t>(1, total / (std::max(processes, 1) * 8));
+        std::printf("渲染农场  地址: %s  渲染进程: %d  总帧数: %llu  分块: %llu 帧\n", addressText.c_str(), processes,
+                    (unsigned long long)total, (unsigned long long)chunk);
+
+        // 渲染进程的日志写到 /dev/null，协调进程统一汇报进度
+        std::vector<pid_t> children;
+        std::vector<std::string> args = WorkerArguments(argc, argv, addressText);
+        std::vector<char *> childArgv;
+        for (std::string &arg : args)
+            childArgv.push_back(&arg[0]);
+        childArgv.push_back(nullptr);
+        posix_spawn_file_actions_t actions;
+        posix_spawn_file_actions_init(&actions);
+        posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+        for (int i = 0; i < processes; ++i)
+        {
+            pid_t pid = 0;
+            if (posix_spawn(&pid, "/proc/self/exe", &actions, nullptr, childArgv.data(), environ) != 0 &&
+                posix_spawnp(&pid, argv[0], &actions, nullptr, childArgv.data(), environ) != 0)
+            {
+                std::perror("无法启动渲染进程");
+                continue;
+            }
+            children.push_back(pid);
+        }
+        posix_spawn_file_actions_destroy(&actions);
+
+        Coordinator coordinator(total, chunk);
+        auto start = clock::now();
+        auto lastReport = start;
+        uint64_t lastCompleted = 0;
+        bool everConnected = false;
+        while (!coordinator.IsComplete())
+        {
+            int connected = coordinator.Poll(listenFd, 100);
+            everConnected |= connected > 0;
+
+            // 本地渲染进程全部退出且没有远程进程连接时无法再继续
+            int alive = 0;
+            for (pid_t &pid : children)
+            {
+                if (pid > 0 && waitpid(pid, nullptr, WNOHANG) == pid)
+                    pid = 0;
+                alive += pid > 0;
+            }
+            if (connected == 0 && alive == 0 && (everConnected || processes > 0))
+            {
+                std::printf("所有渲染进程都已退出，剩余 %llu 帧未完成\n", (unsigned long long)(total - coordinator.GetCompletedFrames()));
+                break;
+            }
+
+            auto now = clock::now();
+            double elapsed = std::chrono::duration<double>(now - lastReport).count();
+            if (elapsed >= 1.0)
+            {
+                uint64_t completed = coordinator.GetCompletedFrames();
+                std::printf("[%6.1fs] 完成: %llu/%llu  %.1f 帧/s  进程:",
+                            std::chrono::duration<double>(now - start).count(), (unsigned long long)completed,
+                            (unsigned long long)total, (completed - lastCompleted) / elapsed);
+                for (Peer *peer : coordinator.GetPeers())
+                    std::printf(" %d(%.0f)", peer->pid, peer->rate);
+                std::printf("\n");
+                std::fflush(stdout);
+                lastCompleted = completed;
+                lastReport = now;
+            }
+        }
+        double seconds = std::chrono::duration<double>(clock::now() - start).count();
+
+        // 汇总在发送 QUIT 之前读取，之后连接会陆续关闭
+        std::printf("%8s %8s %6s %6s %10s\n", "pid", "frames", "ranges", "split", "frames/s");
+        for (Peer *peer : coordinator.GetPeers())
+            std::printf("%8d %8llu %6d %6d %10.1f\n", peer->pid, peer->frames, peer->ranges, peer->donated,
+                        peer->busySeconds > 0.0 ? peer->frames / peer->busySeconds : 0.0);
+        coordinator.QuitAll();
+
+        // 等待渲染进程写完输出后退出
+        for (pid_t pid : children)
+        {
+            if (pid > 0)
+                waitpid(pid, nullptr, 0);
+        }
+        close(listenFd);
+        if (!address.tcp)
+            unlink(address.path.c_str());
+
+        bool complete = coordinator.IsComplete();
+        std::printf("渲染农场结束  完成: %llu/%llu 帧  耗时: %.2fs  %.1f 帧/s\n", (unsigned long long)coordinator.GetCompletedFrames(),
+                    (unsigned long long)total, seconds, seconds > 0.0 ? coordinator.GetCompletedFrames() / seconds : 0.0);
+        return complete ? 0 : 1;
+    }
+
+    int RunWorker(GLFWwindow *context, const RenderSettings &settings, int width, int height)
+    {
+        FarmAddress address;
+        if (!ParseAddress(settings.farmWorker, address))
+        {
+            std::fprintf(stderr, "无效的农场地址: %s\n", settings.farmWorker.c_str());
+            return 1;
+        }
+        signal(SIGPIPE, SIG_IGN);
+        int fd = OpenSocket(address, false);
+        if (fd < 0)
+        {
+            std::perror(("无法连接协调进程 " + settings.farmWorker).c_str());
+            return 1;
+        }
+
+        // 每个进程只有一个上下文，并行度来自进程数；帧流与共享内存输出无法在多个进程间共享
+        RenderSettings s = settings;
+        s.renderMode = RenderMode::Single;
+        if (!s.sinkPath.empty() || !s.shmName.empty() || !s.containerPath.empty())
+            std::fprintf(stderr, "渲染进程忽略 --sink / --shm / --container，请使用 --export 收集输出\n");
+        s.sinkPath.clear();
+        s.shmName.clear();
+        s.containerPath.clear();
+        s.recordPath.clear();
+
+        LineConnection connection(fd);
+        connection.Send("HELLO " + std::to_string(getpid()));
+        FarmWorkerSource source(connection);
+        Headless::Run(context, s, width, height, &source);
+        connection.Close();
+        return 0;
+    }
+}
+
+#endif
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include "RenderSettings.h"
+
+// 多进程本地渲染农场：一个协调进程 + N 个渲染进程，每个渲染进程都是带独立 GL 上下文的无头单线程渲染器。
+// 协调进程把 [0, frames) 切成小块按需分发，区间用尽后从预计最晚完成的进程那里切走一半剩余帧交给空闲进程；
+// 渲染进程断开时，其未完成的区间重新排队。
+//
+// 协议为文本行（以 '\n' 结尾），Unix 域套接字与 TCP 完全相同，其他机器可以用
+// --farm-worker tcp:主机:端口 手动加入：
+//   渲染进程 -> 协调进程
+//     HELLO <pid>                     连接后第一条
+//     PROGRESS <next>                 当前区间中下一帧的序号（约每 200ms）
+//     SHRUNK <first> [<end>]          对 SHRINK 的应答：区间 first 实际保留到 end（不含）；
+//                                     不带 end 表示该区间已不在本进程（已完成），没有可交出的帧
+//     DONE <first> <end> <seconds>    区间渲染完成
+//   协调进程 -> 渲染进程
+//     RANGE <first> <end>             分配区间 [first, end)
+//     SHRINK <first> <end>            请求区间 first 只渲染到 end（不含），剩余部分将交给其他进程
+//     QUIT                            没有更多工作
+namespace Farm
+{
+    // 协调进程（不创建 GL 上下文）：启动 settings.farmProcesses 个渲染进程，它们使用与本进程相同的命令行参数。
+    // 所有帧完成且渲染进程退出后返回 0。
+    int RunCoordinator(const RenderSettings &settings, int argc, char **argv);
+
+    // 渲染进程：连接 settings.farmWorker，按分配的区间渲染直到收到 QUIT
+    // context 的上下文必须在调用线程中为当前上下文
+    int RunWorker(GLFWwindow *context, const RenderSettings &settings, int width, int height);
+}
@@ -0,0 +1,204 @@
+#include "RenderSettings.h"
+#include "WorkerPool.h"
+#include "FrameReadback.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+const char *RenderModeName(RenderMode mode)
+{
+    switch (mode)
+    {
+    case RenderMode::Single:
+        return "single";
+    case RenderMode::Multi:
+        return "multi";
+    case RenderMode::Split:
+        return "sfr";
+    }
+    return "unknown";
+}
+
+void ParseRenderArgs(int argc, char **argv, RenderSettings &settings, std::vector<std::string> *unknown)
+{
+    RenderSettings &s = settings;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--single") s.renderMode = RenderMode::Single;
+        else if (arg == "--multi") s.renderMode = RenderMode::Multi;
+        else if (arg == "--sfr") s.renderMode = RenderMode::Split;
+        else if (arg == "--sfr-threads" && i + 1 < argc) s.sfrThreads = std::clamp(std::atoi(argv[++i]), 1, SplitFrameRenderer::MaxThreads);
+        else if (arg == "--sfr-tiles" && i + 1 < argc) s.sfrTiles = std::clamp(std::atoi(argv[++i]), 1, SplitFrameRenderer::MaxTiles);
+        else if (arg == "--sfr-balance" && i + 1 < argc)
+        {
+            if (!ParseTileBalance(argv[++i], s.tileBalance))
+                std::cout << "未知的分块分配策略: " << argv[i] << " (可选 static/dynamic)" << std::endl;
+        }
+        else if (arg == "--queue-depth" && i + 1 < argc) s.queueDepth = std::atoi(argv[++i]);
+        else if (arg == "--present-mode" && i + 1 < argc)
+        {
+            if (!ParsePresentMode(argv[++i], s.presentMode))
+                std::cout << "未知的呈现模式: " << argv[i] << " (可选 fifo/mailbox/discard)" << std::endl;
+        }
+        else if (arg == "--pacing" && i + 1 < argc)
+        {
+            if (!ParsePacingMode(argv[++i], s.pacingMode))
+                std::cout << "未知的调速模式: " << argv[i] << " (可选 unlimited/cap/ondemand/hybrid)" << std::endl;
+        }
+        else if (arg == "--fps-cap" && i + 1 < argc) s.targetFps = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--workers" && i + 1 < argc) s.workerCount = std::clamp(std::atoi(argv[++i]), 1, WorkerPool::MaxWorkers);
+        else if (arg == "--cpu-load" && i + 1 < argc) s.cpuLoad = std::max(0, std::atoi(argv[++i]));
+        else if (arg == "--render-load" && i + 1 < argc) s.renderLoad = std::max(0, std::atoi(argv[++i]));
+        else if (arg == "--afr-scaling")
+        {
+            s.afrScalingSeconds = 2.0;
+            if (i + 1 < argc && argv[i + 1][0] != '-') s.afrScalingSeconds = std::atof(argv[++i]);
+        }
+        else if (arg == "--aa-bench")
+        {
+            s.aaBenchSeconds = 2.0;
+            if (i + 1 < argc && argv[i + 1][0] != '-') s.aaBenchSeconds = std::atof(argv[++i]);
+        }
+        else if (arg == "--msaa" && i + 1 < argc)
+        {
+            s.msaaSamples = std::atoi(argv[++i]);
+            if (s.msaaSamples != 0 && s.msaaSamples != 2 && s.msaaSamples != 4 && s.msaaSamples != 8)
+            {
+                std::cout << "不支持的多重采样数: " << argv[i] << " (可选 0/2/4/8)" << std::endl;
+                s.msaaSamples = 0;
+            }
+        }
+        else if (arg == "--dynamic-res")
+        {
+            s.resolutionBudgetMs = 1000.0 / 60.0;
+            if (i + 1 < argc && argv[i + 1][0] != '-') s.resolutionBudgetMs = std::max(1.0, std::atof(argv[++i]));
+        }
+        else if (arg == "--upscale" && i + 1 < argc)
+        {
+            if (!ParseUpscaleFilter(argv[++i], s.upscaleFilter))
+                std::cout << "未知的放大方式: " << argv[i] << " (可选 bilinear/sharpen)" << std::endl;
+        }
+        else if (arg == "--record-snapshots" && i + 1 < argc) s.recordPath = argv[++i];
+        else if (arg == "--replay-snapshots" && i + 1 < argc) s.replayPath = argv[++i];
+        else if (arg == "--upload-demo") s.uploadDemo = true;
+        else if (arg == "--color-format" && i + 1 < argc)
+        {
+            if (!ParseColorFormat(argv[++i], s.colorFormat) || s.colorFormat == ColorFormat::R8)
+            {
+                std::cout << "未知的颜色格式: " << argv[i] << " (可选 rgba8/rgb10a2/r11g11b10f/rgba16f)" << std::endl;
+                s.colorFormat = ColorFormat::Rgba8;
+            }
+        }
+        else if (arg == "--readback")
+        {
+            s.readbackDepth = 3;
+            if (i + 1 < argc && argv[i + 1][0] != '-') s.readbackDepth = std::atoi(argv[++i]);
+            s.readbackDepth = std::clamp(s.readbackDepth, FrameReadback::MinDepth, FrameReadback::MaxDepth);
+        }
+        else if (arg == "--yuv" && i + 1 < argc)
+        {
+            if (!ParseYuvMatrix(argv[++i], s.yuvMatrix))
+                std::cout << "未知的 YUV 矩阵: " << argv[i] << " (可选 none/bt601/bt709)" << std::endl;
+        }
+        else if (arg == "--yuv-range" && i + 1 < argc)
+        {
+            if (!ParseYuvRange(argv[++i], s.yuvRange))
+                std::cout << "未知的 YUV 量化范围: " << argv[i] << " (可选 full/limited)" << std::endl;
+        }
+        else if (arg == "--damage")
+        {
+            s.damageKeyframe = 60;
+            if (i + 1 < argc && argv[i + 1][0] != '-') s.damageKeyframe = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (arg == "--damage-tile" && i + 1 < argc) s.damageTile = std::clamp(std::atoi(argv[++i]), 8, 512);
+        else if (arg == "--sink" && i + 1 < argc) s.sinkPath = argv[++i];
+        else if (arg == "--sink-format" && i + 1 < argc)
+        {
+            if (!ParseSinkFormat(argv[++i], s.sinkFormat))
+                std::cout << "未知的输出格式: " << argv[i] << " (可选 raw/y4m)" << std::endl;
+        }
+        else if (arg == "--sink-policy" && i + 1 < argc)
+        {
+            if (!ParseSinkPolicy(argv[++i], s.sinkPolicy))
+                std::cout << "未知的背压策略: " << argv[i] << " (可选 block/drop)" << std::endl;
+        }
+        else if (arg == "--sink-fps" && i + 1 < argc) s.sinkFps = std::max(1.0, std::atof(argv[++i]));
+        else if (arg == "--sink-queue" && i + 1 < argc) s.sinkQueue = std::clamp(std::atoi(argv[++i]), 1, 64);
+        else if (arg == "--export" && i + 1 < argc) s.exportDir = argv[++i];
+        else if (arg == "--export-format" && i + 1 < argc)
+        {
+            if (!ParseImageFormat(argv[++i], s.exportFormat))
+                std::cout << "未知的图像格式: " << argv[i] << " (可选 png/qoi)" << std::endl;
+        }
+        else if (arg == "--export-every" && i + 1 < argc) s.exportEvery = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--export-threads" && i + 1 < argc) s.exportThreads = std::clamp(std::atoi(argv[++i]), 1, 64);
+        else if (arg == "--export-queue" && i + 1 < argc) s.exportInFlight = std::clamp(std::atoi(argv[++i]), 1, 256);
+        else if (arg == "--shm" && i + 1 < argc)
+        {
+            s.shmName = argv[++i];
+            if (s.shmName[0] != '/')
+                s.shmName = "/" + s.shmName;
+        }
+        else if (arg == "--shm-slots" && i + 1 < argc) s.shmSlots = std::clamp(std::atoi(argv[++i]), 2, 16);
+        else if (arg == "--container" && i + 1 < argc) s.containerPath = argv[++i];
+        else if (arg == "--container-frames" && i + 1 < argc) s.containerFrames = std::max(1LL, std::atoll(argv[++i]));
+        else if (arg == "--batch" && i + 1 < argc) s.batchFile = argv[++i];
+        else if (arg == "--batch-summary" && i + 1 < argc) s.batchSummary = argv[++i];
+        else if (arg == "--farm" && i + 1 < argc) s.farmProcesses = std::clamp(std::atoi(argv[++i]), 0, 256);
+        else if (arg == "--farm-listen" && i + 1 < argc) s.farmListen = argv[++i];
+        else if (arg == "--farm-worker" && i + 1 < argc) s.farmWorker = argv[++i];
+        else if (arg == "--farm-chunk" && i + 1 < argc) s.farmChunk = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--headless") s.headless = true;
+        else if (arg == "--context-api" && i + 1 < argc)
+        {
+            s.contextApi = argv[++i];
+            if (s.contextApi != "egl" && s.contextApi != "osmesa")
+            {
+                std::cout << "未知的上下文接口: " << s.contextApi << " (可选 egl/osmesa)" << std::endl;
+                s.contextApi = "egl";
+            }
+        }
+        else if (arg == "--duration" && i + 1 < argc) s.durationSeconds = std::max(0.1, std::atof(argv[++i]));
+        else if (arg == "--frames" && i + 1 < argc) s.frameLimit = std::max(0LL, std::atoll(argv[++i]));
+        else if (unknown && arg.compare(0, 2, "--") == 0) unknown->push_back(arg.substr(2));
+    }
+    s.queueDepth = std::clamp(s.queueDepth, FrameQueue::MinDepth, FrameQueue::MaxDepth);
+    // 批处理与渲染农场的渲染进程总是无头运行
+    if (!s.batchFile.empty() || !s.farmWorker.empty())
+        s.headless = true;
+
+    if (!s.sinkPath.empty())
+    {
+        // 帧流输出由回读回调驱动
+        if (s.readbackDepth == 0)
+            s.readbackDepth = 3;
+        if (s.sinkFps <= 0.0)
+            s.sinkFps = s.pacingMode == PacingMode::FpsCap || s.pacingMode == PacingMode::Hybrid ? s.targetFps : 60.0;
+    }
+    if ((!s.shmName.empty() || !s.containerPath.empty() || s.damageKeyframe > 0) && s.readbackDepth == 0)
+        s.readbackDepth = 3;
+    if (!s.exportDir.empty())
+    {
+        if (s.readbackDepth == 0)
+            s.readbackDepth = 3;
+        // 留一个核给主线程与渲染线程
+        if (s.exportThreads == 0)
+            s.exportThreads = std::max(1, (int)std::thread::hardware_concurrency() - 1);
+        if (s.exportInFlight == 0)
+            s.exportInFlight = s.exportThreads * 2;
+    }
+    if (s.yuvMatrix != YuvMatrix::None && (!s.exportDir.empty() || !s.shmName.empty()))
+    {
+        std::cout << "图像导出与共享内存帧服务需要 RGBA 回读，忽略 --yuv" << std::endl;
+        s.yuvMatrix = YuvMatrix::None;
+    }
+}
+
+long long ContainerCapacity(const RenderSettings &settings)
+{
+    if (settings.containerFrames > 0)
+        return settings.containerFrames;
+    return settings.frameLimit > 0 ? settings.frameLimit : 600;
+}
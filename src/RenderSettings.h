@@ -0,0 +1,103 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "FrameQueue.h"
+#include "FrameGovernor.h"
+#include "SplitFrameRenderer.h"
+#include "StreamSink.h"
+#include "ImageEncoder.h"
+#include "YuvConverter.h"
+#include "Framebuffer.h"
+#include "ScreenRenderer.h"
+#include "SceneState.h"
+
+// 渲染架构
+enum class RenderMode
+{
+    Single, // 单线程：主线程串行完成逻辑与渲染
+    Multi,  // 多线程：Worker（AFR 时为多个）整帧渲染，主线程上屏
+    Split   // 分块多线程：一帧切分为多块并行渲染，主线程合成
+};
+
+const char *RenderModeName(RenderMode mode);
+
+// 命令行可配置的全部运行参数（交互模式与无头模式共用）
+struct RenderSettings
+{
+    RenderMode renderMode = RenderMode::Single;
+    int cpuLoad = 0;
+    int renderLoad = 0;
+    int queueDepth = 3;
+    PresentMode presentMode = PresentMode::Mailbox;
+    PacingMode pacingMode = PacingMode::Unlimited;
+    int targetFps = 60;
+    int workerCount = 1;
+    double afrScalingSeconds = 0.0;
+    double aaBenchSeconds = 0.0; // 抗锯齿开销测试每档时长，0 表示不运行
+    int sfrThreads = 4;
+    int sfrTiles = 8;
+    TileBalance tileBalance = TileBalance::Dynamic;
+    std::string recordPath;
+    std::string replayPath;
+    bool uploadDemo = false;
+    ColorFormat colorFormat = ColorFormat::Rgba8; // 场景渲染目标的颜色格式
+    int msaaSamples = 0;                          // 场景渲染目标的多重采样数（0/2/4/8）
+    // 动态分辨率（单线程与多线程模式）：按帧耗时预算在 50%~100% 间调整内部渲染比例，回读开启时固定 100%
+    double resolutionBudgetMs = 0.0; // 0 表示关闭
+    UpscaleFilter upscaleFilter = UpscaleFilter::Bilinear;
+    int readbackDepth = 0; // PBO 回读环深度，0 表示不回读
+    // 回读前在 GPU 上转换为 I420（帧流输出与帧容器直接使用；图像导出与共享内存需要 RGBA，开启时忽略）
+    YuvMatrix yuvMatrix = YuvMatrix::None;
+    YuvRange yuvRange = YuvRange::Full;
+    // 脏矩形回读：非关键帧只传输变化的分块（I420 回读始终传输整帧）
+    int damageKeyframe = 0; // 关键帧间隔（回读帧），0 表示不跟踪
+    int damageTile = 64;    // 分块边长（像素）
+
+    // 帧流输出（依赖回读，开启时回读深度至少为默认值）
+    std::string sinkPath; // "-" 表示 stdout，空表示不输出
+    SinkFormat sinkFormat = SinkFormat::Y4m;
+    SinkPolicy sinkPolicy = SinkPolicy::Block;
+    double sinkFps = 0.0; // 写入 Y4M 头的帧率，0 表示按调速目标（不限速时为 60）
+    int sinkQueue = 4;    // 写出队列容量（帧）
+
+    // 图像序列导出（同样依赖回读）
+    std::string exportDir; // 空表示不导出
+    ImageFormat exportFormat = ImageFormat::Png;
+    int exportEvery = 1;    // 每 N 帧导出一帧
+    int exportThreads = 0;  // 编码线程数，0 表示 CPU 核数减一
+    int exportInFlight = 0; // 在途帧上限，0 表示编码线程数的两倍
+
+    // 共享内存帧服务（同样依赖回读）
+    std::string shmName; // POSIX 共享内存名，如 /offscreen；空表示不发布
+    int shmSlots = 4;
+
+    // 帧容器：回读到的帧写入预分配并 mmap 的单个文件，带索引可随机访问（同样依赖回读）
+    std::string containerPath; // 空表示不写
+    long long containerFrames = 0; // 容量（帧），0 表示取 --frames，未指定帧数时为 600
+
+    // 无头模式：不连接显示服务器，通过 GLFW null 平台创建上下文
+    bool headless = false;
+    std::string contextApi = "egl"; // egl（surfaceless）或 osmesa
+    double durationSeconds = 10.0;  // 运行时长
+    long long frameLimit = 0;       // 呈现帧数上限，0 表示只按时长
+
+    // 批处理：按作业文件依次无头渲染，并把每个作业的结果写入汇总 JSON
+    std::string batchFile;
+    std::string batchSummary = "batch_summary.json";
+    // 多进程渲染农场：协调进程启动 farmProcesses 个无头渲染进程并分发帧区间（需要 --frames）
+    int farmProcesses = 0;
+    std::string farmListen; // 协调进程监听地址（unix:路径 或 tcp:主机:端口），空表示临时 Unix 套接字
+    std::string farmWorker; // 非空表示本进程是渲染进程，连接到该地址
+    int farmChunk = 0;      // 每次分配的帧数，0 表示自动
+
+    // 批处理作业的相机路径与模型旋转（只能在作业文件中设置）；开启后场景时间按 targetFps 的固定步长推进
+    SceneScript script;
+};
+
+// 解析命令行参数；无法识别的取值输出提示并保留默认值
+// unknown 非空时收集无法识别（或缺少取值）的 -- 开关，供批处理作业文件报错
+void ParseRenderArgs(int argc, char **argv, RenderSettings &settings, std::vector<std::string> *unknown = nullptr);
+
+// 帧容器的容量（帧）：--container-frames，否则 --frames，都未指定时为 600
+long long ContainerCapacity(const RenderSettings &settings);
@@ -0,0 +1,164 @@
+#include "RenderTargetPool.h"
+#include <algorithm>
+
+std::atomic<unsigned long long> RenderTargetPool::totalHits{0};
+std::atomic<unsigned long long> RenderTargetPool::totalMisses{0};
+std::atomic<unsigned long long> RenderTargetPool::totalEvictions{0};
+std::atomic<size_t> RenderTargetPool::totalResidentBytes{0};
+std::atomic<size_t> RenderTargetPool::totalIdleBytes{0};
+std::atomic<size_t> RenderTargetPool::totalTransientBytes{0};
+std::atomic<size_t> RenderTargetPool::totalAliasedBytes{0};
+std::atomic<size_t> RenderTargetPool::peakUnaliasedBytes{0};
+std::atomic<size_t> RenderTargetPool::peakBytes{0};
+
+RenderTargetPool::RenderTargetPool(int bucket, int idleFrames)
+    : bucket(std::max(1, bucket)), idleFrames(std::max(1, idleFrames))
+{
+}
+
+RenderTargetPool::~RenderTargetPool()
+{
+    Trim();
+    if (!inUse.empty())
+        std::cout << "渲染目标池销毁时仍有 " << inUse.size() << " 个目标未归还" << std::endl;
+}
+
+Framebuffer *RenderTargetPool::Acquire(const FramebufferDesc &desc, bool bucketed)
+{
+    int maxWidth = bucketed ? RoundUp(desc.width) : desc.width;
+    int maxHeight = bucketed ? RoundUp(desc.height) : desc.height;
+
+    // 同一档中面积最小的空闲目标；同面积时取最近归还的（驱动端更可能仍在缓存中）
+    int best = -1;
+    for (int i = (int)idle.size() - 1; i >= 0; --i)
+    {
+        const FramebufferDesc &a = idle[i].target->GetDesc();
+        if (!a.SameFormat(desc))
+            continue;
+        if (a.width < desc.width || a.height < desc.height || a.width > maxWidth || a.height > maxHeight)
+            continue;
+        if (best < 0 || a.GetBytes() < idle[best].target->GetDesc().GetBytes())
+            best = i;
+    }
+
+    Framebuffer *target;
+    if (best >= 0)
+    {
+        target = idle[best].target;
+        idle.erase(idle.begin() + best);
+        totalIdleBytes -= target->GetAllocatedBytes();
+        hits++;
+        totalHits++;
+    }
+    else
+    {
+        FramebufferDesc allocated = desc;
+        allocated.width = maxWidth;
+        allocated.height = maxHeight;
+        target = new Framebuffer(allocated, &heap);
+        residentBytes += target->GetAllocatedBytes();
+        totalResidentBytes += target->GetAllocatedBytes();
+        UpdatePeaks();
+        misses++;
+        totalMisses++;
+    }
+    target->SetSize(desc.width, desc.height);
+    inUse.insert(target);
+    return target;
+}
+
+void RenderTargetPool::Release(Framebuffer *target)
+{
+    if (!target)
+        return;
+    auto it = inUse.find(target);
+    if (it == inUse.end())
+    {
+        std::cout << "渲染目标池: 归还了不属于本池的目标" << std::endl;
+        return;
+    }
+    idle.push_back({target, frame});
+    inUse.erase(it);
+    totalIdleBytes += target->GetAllocatedBytes();
+}
+
+void RenderTargetPool::Tick()
+{
+    frame++;
+    for (size_t i = 0; i < idle.size();)
+    {
+        if (frame - idle[i].releasedFrame > (uint64_t)idleFrames)
+        {
+            Destroy(idle[i].target, true);
+            idle.erase(idle.begin() + i);
+        }
+        else
+        {
+            i++;
+        }
+    }
+}
+
+void RenderTargetPool::Trim()
+{
+    for (const IdleTarget &entry : idle)
+        Destroy(entry.target, false);
+    idle.clear();
+}
+
+void RenderTargetPool::Destroy(Framebuffer *target, bool evicted)
+{
+    size_t bytes = target->GetAllocatedBytes();
+    delete target;
+    residentBytes -= bytes;
+    totalResidentBytes -= bytes;
+    totalIdleBytes -= bytes;
+    if (evicted)
+        totalEvictions++;
+}
+
+RenderTargetStats RenderTargetPool::GetTotalStats()
+{
+    RenderTargetStats stats;
+    stats.hits = totalHits.load();
+    stats.misses = totalMisses.load();
+    stats.evictions = totalEvictions.load();
+    stats.residentBytes = totalResidentBytes.load();
+    stats.idleBytes = totalIdleBytes.load();
+    stats.transientBytes = totalTransientBytes.load();
+    stats.aliasedBytes = totalAliasedBytes.load();
+    stats.residentBytes += stats.aliasedBytes;
+    stats.peakUnaliasedBytes = peakUnaliasedBytes.load();
+    stats.peakBytes = peakBytes.load();
+    return stats;
+}
+
+void RenderTargetPool::AccountTransient(long long virtualDelta, long long physicalDelta)
+{
+    totalTransientBytes += (size_t)virtualDelta;
+    totalAliasedBytes += (size_t)physicalDelta;
+    UpdatePeaks();
+}
+
+void RenderTargetPool::ResetPeaks()
+{
+    size_t owned = totalResidentBytes.load();
+    peakUnaliasedBytes = owned + totalTransientBytes.load();
+    peakBytes = owned + totalAliasedBytes.load();
+}
+
+void RenderTargetPool::UpdatePeaks()
+{
+    // 多个渲染线程同时更新：各自按当前值取最大
+    size_t owned = totalResidentBytes.load();
+    size_t unaliased = owned + totalTransientBytes.load();
+    size_t aliased = owned + totalAliasedBytes.load();
+    size_t peak = peakUnaliasedBytes.load();
+    while (unaliased > peak && !peakUnaliasedBytes.compare_exchange_weak(peak, unaliased))
+    {
+    }
+    peak = peakBytes.load();
+    while (aliased > peak && !peakBytes.compare_exchange_weak(peak, aliased))
+    {
+    }
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+#include "Framebuffer.h"
+#include "TransientHeap.h"
+
+// 全部渲染目标池的累计统计（各线程的池共同更新，任意线程可读）
+struct RenderTargetStats
+{
+    unsigned long long hits = 0;
+    unsigned long long misses = 0;
+    unsigned long long evictions = 0;
+    size_t residentBytes = 0; // 已分配（使用中 + 空闲）的显存估计，瞬态附件按实际共享后的块计
+    size_t idleBytes = 0;     // 其中空闲、等待复用的部分
+    // 瞬态附件（深度/模板与多重采样颜色渲染缓冲）：各目标各自分配时需要的显存与共享后实际分配的显存
+    size_t transientBytes = 0;
+    size_t aliasedBytes = 0;
+    // 显存峰值：不共享瞬态附件时（驻留 - 实际块 + 各自分配）与实际
+    size_t peakUnaliasedBytes = 0;
+    size_t peakBytes = 0;
+};
+
+// 渲染目标池：按描述（宽, 高, 附件格式, 采样数）复用 Framebuffer，避免拖动窗口时反复分配纹理与渲染缓冲。
+// 归还的目标进入空闲表；按尺寸分档的请求可以复用同一档中不小于所需尺寸的目标，
+// 未命中时按档的上限分配，窗口在一档之内变化时始终命中。空闲超过 idleFrames 帧的目标被释放。
+// 池中的目标共用一个瞬态堆：深度/模板与多重采样颜色渲染缓冲在生命期（Bind 到 Unbind）不重叠的目标之间共享。
+// FBO 不在上下文间共享：每个渲染线程各自持有一个池，只在该线程的上下文中使用。
+class RenderTargetPool
+{
+public:
+    static const int DefaultBucket = 64;
+    static const int DefaultIdleFrames = 120;
+
+    // bucket：分档粒度（像素）；idleFrames：空闲目标保留的帧数
+    explicit RenderTargetPool(int bucket = DefaultBucket, int idleFrames = DefaultIdleFrames);
+    // 释放空闲目标；使用中的目标应已全部归还
+    ~RenderTargetPool();
+
+    // 取得一个渲染目标，尺寸（GetWidth/GetHeight）等于 desc 的宽高。
+    // bucketed 为 false 时分配尺寸与 desc 完全相同（采样整张纹理的使用者需要）；
+    // 为 true 时分配尺寸可能更大，内容位于纹理左下角
+    Framebuffer *Acquire(const FramebufferDesc &desc, bool bucketed = false);
+    // 归还 Acquire 取得的目标
+    void Release(Framebuffer *target);
+    // 每帧调用一次：推进帧计数并逐出空闲过久的目标
+    void Tick();
+    // 立即释放全部空闲目标
+    void Trim();
+
+    unsigned long long GetHits() const { return hits; }
+    unsigned long long GetMisses() const { return misses; }
+    size_t GetResidentBytes() const { return residentBytes + heap.GetPhysicalBytes(); }
+    int GetIdleTargets() const { return (int)idle.size(); }
+
+    const TransientHeap &GetTransientHeap() const { return heap; }
+
+    static RenderTargetStats GetTotalStats();
+    // 把显存峰值重置为当前值（每次无头运行开始时调用，按运行统计峰值）
+    static void ResetPeaks();
+    // 瞬态堆登记/注销附件（virtualDelta）与分配/释放块（physicalDelta）时更新全局统计
+    static void AccountTransient(long long virtualDelta, long long physicalDelta);
+
+private:
+    struct IdleTarget
+    {
+        Framebuffer *target;
+        uint64_t releasedFrame;
+    };
+
+    int RoundUp(int size) const { return (size + bucket - 1) / bucket * bucket; }
+    void Destroy(Framebuffer *target, bool evicted);
+    static void UpdatePeaks();
+
+    // 先于全部目标构造、后于全部目标析构
+    TransientHeap heap;
+    int bucket;
+    int idleFrames;
+    uint64_t frame = 0;
+    std::vector<IdleTarget> idle;
+    std::unordered_set<Framebuffer *> inUse;
+
+    unsigned long long hits = 0, misses = 0;
+    size_t residentBytes = 0;
+
+    static std::atomic<unsigned long long> totalHits, totalMisses, totalEvictions;
+    static std::atomic<size_t> totalResidentBytes, totalIdleBytes;
+    static std::atomic<size_t> totalTransientBytes, totalAliasedBytes;
+    static std::atomic<size_t> peakUnaliasedBytes, peakBytes;
+};
@@ -9,6 +9,7 @@ Renderer::Renderer(int width, int height) : screenWidth(width), screenHeight(hei
     sceneShader = nullptr;
     screenShader = nullptr;
     fbo = nullptr;
+    targets = nullptr;
     scene = nullptr;
 }
 
@@ -16,8 +17,11 @@ Renderer::~Renderer()
 {
     delete sceneShader;
     delete screenShader;
-    delete fbo;
+    if (targets) targets->Release(fbo);
+    delete targets;
     delete scene;
+    delete sceneTimer;
+    delete resolveTimer;
     glDeleteVertexArrays(1, &quadVAO);
     glDeleteBuffers(1, &quadVBO);
 }
@@ -36,10 +40,17 @@ void Renderer::Init()
 
     screenShader->use();
     screenShader->setInt("screenTexture", 0);
-
-    // 初始化 FBO、场景物体、全屏四边形
-    fbo = new Framebuffer(screenWidth, screenHeight);
-    scene = new Scene();
+    screenShader->setVec4("region", 0.0f, 0.0f, 1.0f, 1.0f);
+    screenShader->setVec2("uvScale", 1.0f, 1.0f);
+    screenShader->setVec2("texelSize", 0.0f, 0.0f);
+    screenShader->setFloat("sharpness", 0.0f);
+
+    // 初始化 FBO、场景物体、全屏四边形；初始尺寸按原样分配，之后的尺寸变化按档复用
+    targets = new RenderTargetPool();
+    fbo = targets->Acquire(TargetDesc());
+    scene = new Scene(uploads);
+    sceneTimer = new GpuTimer();
+    resolveTimer = new GpuTimer();
     InitQuad();
 }
 
@@ -69,42 +80,72 @@ void Renderer::InitQuad()
     glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void *)(2 * sizeof(float)));
 }
 
-void Renderer::Render()
+void Renderer::Render(const SceneState &state)
 {
-    float time = (float)glfwGetTime();
+    RenderScene(state);
+    RenderScreen();
+}
+
+void Renderer::RenderOffscreen(const SceneState &state)
+{
+    RenderScene(state);
+}
 
+void Renderer::RenderScene(const SceneState &state)
+{
     // --- 第一阶段：离屏渲染 ---
     // 绑定自定义 FBO，所有渲染结果写入其中的纹理附件，而非屏幕
+    // 动态分辨率：只缩小内容尺寸，屏幕阶段按 uvScale 放大
+    int percent = resolution.GetPercent();
+    fbo->SetSize(DynamicResolution::Scale(screenWidth, percent), DynamicResolution::Scale(screenHeight, percent));
+    targets->Tick();
+    sceneTimer->Begin();
     fbo->Bind();
     glEnable(GL_DEPTH_TEST);
-    glClearColor(0.1f, 0.1f, 0.1f, 1.0f); // 深色背景清屏
+    glClearColor(state.clearColor.r, state.clearColor.g, state.clearColor.b, state.clearColor.a); // 深色背景清屏
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    // 渲染 3D 场景（旋转的立方体）
+    // 渲染 3D 场景（快照中的每个物体）
+    scene->SyncUploads();
     sceneShader->use();
-    glm::mat4 model = glm::mat4(1.0f);
-    glm::mat4 view = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -3.0f));
-    glm::mat4 projection = glm::perspective(glm::radians(45.0f), (float)screenWidth / (float)screenHeight, 0.1f, 100.0f);
-
-    model = glm::rotate(model, time, glm::vec3(0.5f, 1.0f, 0.0f));
-
-    sceneShader->setMat4("view", view);
-    sceneShader->setMat4("projection", projection);
-    sceneShader->setMat4("model", model);
-
-    scene->Draw();
+    sceneShader->setFloat("textureMix", scene->GetTexture() ? 1.0f : 0.0f);
+    sceneShader->setMat4("view", state.view);
+    sceneShader->setMat4("projection", state.projection);
+    for (int i = 0; i < state.objectCount; ++i)
+    {
+        sceneShader->setMat4("model", state.objects[i].model);
+        scene->Draw(state.objects[i].mesh);
+    }
+    sceneTimer->End();
+
+    // 多重采样时解析到屏幕阶段与回读采样的纹理
+    resolveTimer->Begin();
+    fbo->Resolve();
+    resolveTimer->End();
 
     // 解绑 FBO，恢复默认帧缓冲区
     fbo->Unbind();
 
+    // 渲染比例只改变 GPU 的填充量：提交耗时与模拟负载（sleep）不随它变化，控制器只看 GPU 计时
+    resolution.Update(sceneTimer->GetMs() + resolveTimer->GetMs());
+}
+
+void Renderer::RenderScreen()
+{
     // --- 第二阶段：屏幕后处理 ---
     // 可以在这里禁用深度测试，这对于绘制全屏四边形往往是好的
+    // 离屏阶段的视口是内容尺寸（动态分辨率时小于窗口），屏幕阶段恢复为整个窗口
+    glViewport(0, 0, screenWidth, screenHeight);
     glDisable(GL_DEPTH_TEST);
     glClearColor(1.0f, 1.0f, 1.0f, 1.0f); // 纯白背景清屏（实际上会被四边形覆盖）
     glClear(GL_COLOR_BUFFER_BIT);
 
     // 绘制全屏四边形，并将离屏渲染产生的纹理作为贴图输入
     screenShader->use();
+    screenShader->setVec2("uvScale", (float)fbo->GetWidth() / fbo->GetAllocatedWidth(),
+                          (float)fbo->GetHeight() / fbo->GetAllocatedHeight());
+    screenShader->setVec2("texelSize", 1.0f / fbo->GetAllocatedWidth(), 1.0f / fbo->GetAllocatedHeight());
+    screenShader->setFloat("sharpness", filter == UpscaleFilter::Sharpen ? UpscaleSharpness : 0.0f);
     glBindVertexArray(quadVAO);
     glBindTexture(GL_TEXTURE_2D, fbo->GetTextureID()); // 使用 FBO 的颜色纹理
     glDrawArrays(GL_TRIANGLES, 0, 6);
@@ -116,7 +157,26 @@ void Renderer::Resize(int width, int height)
     screenHeight = height;
     glViewport(0, 0, width, height);
 
-    // 如果需要，使用新尺寸重新创建 FBO，确保严格匹配
-    delete fbo;
-    fbo = new Framebuffer(width, height);
+    // 先归还再按档取回：尺寸在同一档内变化时拿回的就是刚归还的目标，不发生分配
+    targets->Release(fbo);
+    fbo = targets->Acquire(TargetDesc(), true);
+}
+
+void Renderer::SetSamples(int samples)
+{
+    this->samples = samples;
+    if (!fbo)
+        return;
+    targets->Release(fbo);
+    fbo = targets->Acquire(TargetDesc(), true);
+}
+
+FramebufferDesc Renderer::TargetDesc() const
+{
+    FramebufferDesc desc;
+    desc.width = screenWidth;
+    desc.height = screenHeight;
+    desc.colors[0] = colorFormat;
+    desc.samples = samples;
+    return desc;
 }
@@ -3,8 +3,12 @@
 #include <glad/glad.h>
 #include <vector>
 #include "Shader.h"
-#include "Framebuffer.h"
+#include "RenderTargetPool.h"
+#include "GpuTimer.h"
+#include "DynamicResolution.h"
+#include "ScreenRenderer.h"
 #include "Scene.h"
+#include "SceneState.h"
 
 class Renderer
 {
@@ -13,9 +17,32 @@ public:
     ~Renderer();
 
     void Init();
-    void Render();
+    // 按主线程给出的场景快照渲染一帧
+    void Render(const SceneState &state);
+    // 只完成离屏阶段，不绘制到默认帧缓冲（无头模式没有默认帧缓冲）
+    void RenderOffscreen(const SceneState &state);
+    unsigned int GetTextureID() const { return fbo ? fbo->GetTextureID() : 0; }
+    // 纹理中有效内容的尺寸（窗口缩放后渲染目标可能大于它，内容位于左下角）
+    int GetTextureWidth() const { return fbo ? fbo->GetWidth() : 0; }
+    int GetTextureHeight() const { return fbo ? fbo->GetHeight() : 0; }
+    const RenderTargetPool *GetTargetPool() const { return targets; }
     void Resize(int width, int height);
     void SetSceneWorkload(int load);
+    // 异步上传的资源来源，需在 Init() 前设置
+    void SetUploadThread(const UploadThread *uploads) { this->uploads = uploads; }
+    // 离屏目标的颜色格式，需在 Init() 前设置
+    void SetColorFormat(ColorFormat format) { colorFormat = format; }
+    // 离屏目标的多重采样数（0/2/4/8），Init() 之后设置时立即重建目标
+    void SetSamples(int samples);
+    // 实际使用的采样数（受驱动上限限制）
+    int GetSamples() const { return fbo ? fbo->GetSamples() : 0; }
+    // 动态分辨率：帧耗时预算（毫秒，0 表示固定 100%）与放大方式
+    void SetResolutionBudget(double ms) { resolution.SetBudget(ms); }
+    const DynamicResolution &GetResolution() const { return resolution; }
+    void SetUpscaleFilter(UpscaleFilter filter) { this->filter = filter; }
+    // 离屏阶段的 GPU 耗时（毫秒）：场景绘制与多重采样解析
+    double GetSceneGpuMs() const { return sceneTimer ? sceneTimer->GetMs() : 0.0; }
+    double GetResolveGpuMs() const { return resolveTimer ? resolveTimer->GetMs() : 0.0; }
 
 private:
     int screenWidth, screenHeight;
@@ -24,9 +51,18 @@ private:
     Shader *sceneShader;
     Shader *screenShader;
     Framebuffer *fbo;
+    RenderTargetPool *targets;
     Scene *scene;
+    const UploadThread *uploads = nullptr;
+    ColorFormat colorFormat = ColorFormat::Rgba8;
+    int samples = 0;
+    GpuTimer *sceneTimer = nullptr;
+    GpuTimer *resolveTimer = nullptr;
+    DynamicResolution resolution;
+    UpscaleFilter filter = UpscaleFilter::Bilinear;
 
+    FramebufferDesc TargetDesc() const;
     void InitQuad();
-    void RenderScene();
+    void RenderScene(const SceneState &state);
     void RenderScreen();
 };
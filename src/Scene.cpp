@@ -1,8 +1,10 @@
 #include "Scene.h"
+#include "UploadThread.h"
+#include <cmath>
 #include <thread>
 #include <chrono>
 
-Scene::Scene() {
+Scene::Scene(const UploadThread *uploads) : uploads(uploads) {
     float cubeVertices[] = {
         // 位置               // 纹理坐标
         -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
@@ -60,27 +62,72 @@ Scene::Scene() {
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
     glEnableVertexAttribArray(1);
     glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
+
+    meshVAO.push_back(cubeVAO);
+    meshVertexCount.push_back(36);
 }
 
 Scene::~Scene() {
+    // 上传的缓冲与纹理归上传线程所有，这里只删除本上下文的 VAO
+    for (size_t i = 1; i < meshVAO.size(); ++i) {
+        if (meshVAO[i]) glDeleteVertexArrays(1, &meshVAO[i]);
+    }
     glDeleteVertexArrays(1, &cubeVAO);
     glDeleteBuffers(1, &cubeVBO);
 }
 
-void Scene::Draw() {
-    glBindVertexArray(cubeVAO);
-    glDrawArrays(GL_TRIANGLES, 0, 36);
+void Scene::SyncUploads(int limit) {
+    if (!uploads) return;
+
+    // 资源按编号顺序发布，遇到第一个尚未完成的就停下
+    int published = uploads->GetPublishedCount();
+    if (limit >= 0 && limit < published) published = limit;
+    while (syncedAssets < published) {
+        const UploadedAsset &asset = uploads->GetAsset(syncedAssets);
+        GLint status = GL_UNSIGNALED;
+        glGetSynciv(asset.fence, GL_SYNC_STATUS, 1, nullptr, &status);
+        if (status != GL_SIGNALED) break;
+
+        unsigned int vao = 0;
+        if (asset.type == UploadType::Mesh) {
+            // 栅栏已触发后再在本上下文绑定缓冲，保证看到完整的数据
+            glGenVertexArrays(1, &vao);
+            glBindVertexArray(vao);
+            glBindBuffer(GL_ARRAY_BUFFER, asset.name);
+            glEnableVertexAttribArray(0);
+            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
+            glEnableVertexAttribArray(1);
+            glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
+            glBindVertexArray(0);
+        } else {
+            texture = asset.name;
+        }
+        meshVAO.push_back(vao);
+        meshVertexCount.push_back(asset.vertexCount);
+        syncedAssets++;
+    }
+}
+
+void Scene::Draw(int mesh) {
+    if (mesh < 0 || mesh >= (int)meshVAO.size() || !meshVAO[mesh]) return;
+
+    // 没有纹理时解绑，避免采样到仍绑定在单元 0 上的渲染目标
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glBindVertexArray(meshVAO[mesh]);
+    glDrawArrays(GL_TRIANGLES, 0, meshVertexCount[mesh]);
     
     // 模拟渲染负载 (Simulate Render Load)
     // 现代 GPU 处理简单的 Draw Call 速度极快，难以通过增加循环次数来压测。
     // 这里使用 sleep 来模拟"驱动程序提交命令耗时"或者"GPU处理阻塞"。
     // 1个单位 workload = 100微秒 (0.1ms)
     // 100个单位 = 10ms
+    // 视为填充受限：只渲染部分画面时耗时按覆盖比例缩放
     if (workload > 0) {
         // 使用 busy loop 可能比 sleep 更稳定，避免操作系统调度带来的额外波动
         // 但 sleep 对多线程演示更直观（让出 CPU 时间片）
         // 这里为了让单线程确确实实变卡，我们用 sleep
-        std::this_thread::sleep_for(std::chrono::microseconds(workload * 100));
+        std::this_thread::sleep_for(std::chrono::microseconds((long long)(workload * 100 * coverage)));
     }
     glBindVertexArray(0);
 }
@@ -88,3 +135,48 @@ void Scene::Draw() {
 void Scene::SetWorkload(int load) {
     workload = load;
 }
+
+void Scene::SetCoverage(float fraction) {
+    coverage = fraction;
+}
+
+std::vector<float> Scene::BuildTorus(int rings, int sides) {
+    const float pi = 3.14159265f;
+    const float major = TorusMajor, minor = TorusMinor;
+    std::vector<float> vertices;
+    vertices.reserve((size_t)rings * sides * 6 * 5);
+
+    auto emit = [&](int r, int s) {
+        float u = (float)r / rings, v = (float)s / sides;
+        float theta = u * 2.0f * pi, phi = v * 2.0f * pi;
+        float ring = major + minor * std::cos(phi);
+        vertices.push_back(ring * std::cos(theta));
+        vertices.push_back(minor * std::sin(phi));
+        vertices.push_back(ring * std::sin(theta));
+        vertices.push_back(u * 8.0f);
+        vertices.push_back(v * 2.0f);
+    };
+    for (int r = 0; r < rings; ++r) {
+        for (int s = 0; s < sides; ++s) {
+            emit(r, s); emit(r + 1, s); emit(r + 1, s + 1);
+            emit(r, s); emit(r + 1, s + 1); emit(r, s + 1);
+        }
+    }
+    return vertices;
+}
+
+std::vector<unsigned char> Scene::BuildChecker(int size, int cells) {
+    std::vector<unsigned char> pixels((size_t)size * size * 4);
+    int cell = size / cells > 0 ? size / cells : 1;
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            bool light = ((x / cell) + (y / cell)) % 2 == 0;
+            unsigned char *p = &pixels[((size_t)y * size + x) * 4];
+            p[0] = light ? 230 : 40;
+            p[1] = light ? 200 : 60;
+            p[2] = light ? 120 : 90;
+            p[3] = 255;
+        }
+    }
+    return pixels;
+}
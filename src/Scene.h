@@ -3,14 +3,39 @@
 #include <glad/glad.h>
 #include <vector>
 
+class UploadThread;
+
 class Scene {
 public:
-    Scene();
+    // uploads 非空时，异步上传完成的网格与纹理会在确认驻留后加入场景
+    explicit Scene(const UploadThread *uploads = nullptr);
     ~Scene();
-    void Draw();
+    // 绘制编号为 mesh 的网格：0 为内置立方体，k 为第 k-1 号上传资源；尚未驻留的网格不绘制
+    void Draw(int mesh = 0);
+    // 在本线程上下文中非阻塞检查上传完成栅栏，把已驻留的资源加入场景（每帧开始时调用）
+    // limit >= 0 时最多加入前 limit 个资源，多个线程合作绘制同一帧时用于保持一致
+    void SyncUploads(int limit = -1);
+    // 已驻留的纹理（0 表示没有），绑定在纹理单元 0
+    unsigned int GetTexture() const { return texture; }
     void SetWorkload(int load);
+    // 分块渲染时本块占整帧的比例（0~1），模拟负载按它分摊到各块；整帧绘制保持 1。
+    // 模拟负载代表每帧固定的 CPU/驱动耗时，与渲染分辨率无关
+    void SetCoverage(float fraction);
+
+    // 演示资源：细分圆环网格（位置 + 纹理坐标）与棋盘格纹理，用于测试异步上传
+    // 圆环位于 xz 平面，局部包围盒为 ±(TorusMajor + TorusMinor, TorusMinor, TorusMajor + TorusMinor)
+    static constexpr float TorusMajor = 0.35f, TorusMinor = 0.12f;
+    static std::vector<float> BuildTorus(int rings, int sides);
+    static std::vector<unsigned char> BuildChecker(int size, int cells);
 
 private:
     unsigned int cubeVAO, cubeVBO;
+    const UploadThread *uploads;
+    int syncedAssets = 0;
+    // 上传网格的 VAO 不在上下文间共享，每个渲染线程各自创建；下标为网格编号
+    std::vector<unsigned int> meshVAO;
+    std::vector<int> meshVertexCount;
+    unsigned int texture = 0;
     int workload = 0;
+    float coverage = 1.0f;
 };
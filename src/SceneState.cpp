@@ -0,0 +1,121 @@
+#include "SceneState.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+// 文件头用于识别快照文件并校验结构体布局
+static const uint32_t SnapshotMagic = 0x53434e31; // "SCN1"
+
+SceneState SimulateScene(uint64_t frame, double time, float aspect, int orbitMesh)
+{
+    SceneState state;
+    state.frame = frame;
+    state.time = time;
+    state.view = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -3.0f));
+    state.projection = glm::perspective(glm::radians(45.0f), aspect, 0.1f, 100.0f);
+    state.objectCount = 1;
+    state.objects[0].mesh = 0;
+    state.objects[0].model = glm::rotate(glm::mat4(1.0f), (float)time, glm::vec3(0.5f, 1.0f, 0.0f));
+    if (orbitMesh >= 0)
+    {
+        glm::mat4 orbit = glm::rotate(glm::mat4(1.0f), (float)time * 0.5f, glm::vec3(0.0f, 1.0f, 0.0f));
+        orbit = glm::translate(orbit, glm::vec3(0.9f, 0.0f, 0.0f));
+        state.objects[1].mesh = orbitMesh;
+        state.objects[1].model = glm::rotate(orbit, (float)time, glm::vec3(1.0f, 0.0f, 0.0f));
+        state.objectCount = 2;
+    }
+    return state;
+}
+
+void SceneScript::Apply(SceneState &state, double progress, double time, float aspect) const
+{
+    if (!cameras.empty())
+    {
+        // 相机关键帧均匀分布在作业进度上
+        double position = std::clamp(progress, 0.0, 1.0) * (cameras.size() - 1);
+        size_t index = std::min((size_t)position, cameras.size() - 1);
+        size_t next = std::min(index + 1, cameras.size() - 1);
+        float t = (float)(position - index);
+        const CameraPose &a = cameras[index];
+        const CameraPose &b = cameras[next];
+        glm::vec3 eye = glm::mix(a.eye, b.eye, t);
+        glm::vec3 target = glm::mix(a.target, b.target, t);
+        float fov = a.fovDegrees + (b.fovDegrees - a.fovDegrees) * t;
+        state.view = glm::lookAt(eye, target, glm::vec3(0.0f, 1.0f, 0.0f));
+        state.projection = glm::perspective(glm::radians(fov), aspect, 0.1f, 100.0f);
+    }
+    glm::vec3 axis = glm::length(rotationAxis) > 0.0f ? rotationAxis : glm::vec3(0.0f, 1.0f, 0.0f);
+    state.objects[0].model = glm::rotate(glm::mat4(1.0f), glm::radians(rotationDegreesPerSecond) * (float)time, axis);
+}
+
+void SimulateLogicLoad(int units)
+{
+    if (units <= 0)
+        return;
+    volatile double acc = 0.0;
+    int loops = units * 10000;
+    for (int i = 0; i < loops; ++i)
+    {
+        acc += std::sqrt((double)(i % 100 + 1));
+    }
+}
+
+SceneRecorder::SceneRecorder(const char *path)
+{
+    file = std::fopen(path, "wb");
+    if (!file)
+    {
+        std::cout << "无法创建快照录制文件: " << path << std::endl;
+        return;
+    }
+    uint32_t header[2] = {SnapshotMagic, (uint32_t)sizeof(SceneState)};
+    std::fwrite(header, sizeof(header), 1, file);
+}
+
+SceneRecorder::~SceneRecorder()
+{
+    if (file)
+        std::fclose(file);
+}
+
+void SceneRecorder::Write(const SceneState &state)
+{
+    if (file)
+        std::fwrite(&state, sizeof(SceneState), 1, file);
+}
+
+ScenePlayer::ScenePlayer(const char *path)
+{
+    file = std::fopen(path, "rb");
+    if (!file)
+    {
+        std::cout << "无法打开快照回放文件: " << path << std::endl;
+        return;
+    }
+    uint32_t header[2] = {0, 0};
+    if (std::fread(header, sizeof(header), 1, file) != 1 || header[0] != SnapshotMagic || header[1] != sizeof(SceneState))
+    {
+        std::cout << "快照文件格式不匹配: " << path << std::endl;
+        std::fclose(file);
+        file = nullptr;
+    }
+}
+
+ScenePlayer::~ScenePlayer()
+{
+    if (file)
+        std::fclose(file);
+}
+
+bool ScenePlayer::Next(SceneState &state)
+{
+    if (!file)
+        return false;
+    if (std::fread(&state, sizeof(SceneState), 1, file) == 1)
+        return true;
+
+    // 到达末尾：跳过文件头从头循环
+    std::fseek(file, 2 * sizeof(uint32_t), SEEK_SET);
+    return std::fread(&state, sizeof(SceneState), 1, file) == 1;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+// 一帧完整的场景状态快照：由主线程（逻辑线程）计算，渲染线程只读
+// 平凡可复制，可以直接整块写入文件用于录制与回放
+struct SceneState
+{
+    static const int MaxObjects = 16;
+
+    struct Object
+    {
+        int mesh = 0; // 0 为内置立方体，k 为第 k-1 号异步上传资源（见 Scene::Draw）
+        glm::mat4 model{1.0f};
+    };
+
+    uint64_t frame = 0; // 0 表示尚无有效快照
+    double time = 0.0;
+    glm::vec4 clearColor{0.1f, 0.1f, 0.1f, 1.0f};
+    glm::mat4 view{1.0f};
+    glm::mat4 projection{1.0f};
+    int objectCount = 0;
+    Object objects[MaxObjects];
+};
+
+// 演示场景的逻辑更新：绕 (0.5, 1, 0) 轴旋转的立方体；orbitMesh >= 0 时再加入一个绕立方体公转的网格
+SceneState SimulateScene(uint64_t frame, double time, float aspect, int orbitMesh = -1);
+
+// 批处理作业的场景脚本：相机关键帧在整段作业上线性插值，模型按固定角速度旋转
+struct SceneScript
+{
+    struct CameraPose
+    {
+        glm::vec3 eye{0.0f, 0.0f, 3.0f};
+        glm::vec3 target{0.0f};
+        float fovDegrees = 45.0f;
+    };
+
+    bool active = false;
+    std::vector<CameraPose> cameras; // 为空时使用演示场景的默认相机
+    glm::vec3 rotationAxis{0.5f, 1.0f, 0.0f};
+    float rotationDegreesPerSecond = 57.29578f; // 与演示场景相同（1 弧度/秒）
+
+    // 覆盖 state 的相机与主物体旋转；progress 为作业进度（0–1），time 为模拟时间
+    void Apply(SceneState &state, double progress, double time, float aspect) const;
+};
+
+// 模拟主线程（逻辑线程）CPU 密集型任务，units 为负载单位
+void SimulateLogicLoad(int units);
+
+// 快照录制：每帧追加写入二进制文件
+class SceneRecorder
+{
+public:
+    explicit SceneRecorder(const char *path);
+    ~SceneRecorder();
+    bool IsOpen() const { return file != nullptr; }
+    void Write(const SceneState &state);
+
+private:
+    FILE *file = nullptr;
+};
+
+// 快照回放：按录制顺序逐帧读取，读到末尾后从头循环
+class ScenePlayer
+{
+public:
+    explicit ScenePlayer(const char *path);
+    ~ScenePlayer();
+    bool IsOpen() const { return file != nullptr; }
+    bool Next(SceneState &state);
+
+private:
+    FILE *file = nullptr;
+};
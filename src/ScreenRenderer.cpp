@@ -1,6 +1,33 @@
 #include "ScreenRenderer.h"
+#include "Framebuffer.h"
 #include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
+#include <cstring>
+
+const char *UpscaleFilterName(UpscaleFilter filter)
+{
+    switch (filter)
+    {
+    case UpscaleFilter::Bilinear:
+        return "bilinear";
+    case UpscaleFilter::Sharpen:
+        return "sharpen";
+    }
+    return "unknown";
+}
+
+bool ParseUpscaleFilter(const char *name, UpscaleFilter &filter)
+{
+    for (UpscaleFilter f : {UpscaleFilter::Bilinear, UpscaleFilter::Sharpen})
+    {
+        if (std::strcmp(name, UpscaleFilterName(f)) == 0)
+        {
+            filter = f;
+            return true;
+        }
+    }
+    return false;
+}
 
 ScreenRenderer::ScreenRenderer() : quadVAO(0), quadVBO(0), screenShader(nullptr) {}
 
@@ -16,6 +43,9 @@ void ScreenRenderer::Init()
     screenShader = new Shader("shaders/screen.vert", "shaders/screen.frag");
     screenShader->use();
     screenShader->setInt("screenTexture", 0);
+    screenShader->setVec2("uvScale", 1.0f, 1.0f);
+    screenShader->setVec2("texelSize", 0.0f, 0.0f);
+    screenShader->setFloat("sharpness", 0.0f);
 
     float quadVertices[] = {
         // 位置        // 纹理坐标
@@ -38,10 +68,32 @@ void ScreenRenderer::Init()
     glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void *)(2 * sizeof(float)));
 }
 
+void ScreenRenderer::SetSource(const Framebuffer *target)
+{
+    screenShader->use();
+    if (!target)
+    {
+        screenShader->setVec2("uvScale", 1.0f, 1.0f);
+        screenShader->setVec2("texelSize", 0.0f, 0.0f);
+        screenShader->setFloat("sharpness", 0.0f);
+        return;
+    }
+    screenShader->setVec2("uvScale", (float)target->GetWidth() / target->GetAllocatedWidth(),
+                          (float)target->GetHeight() / target->GetAllocatedHeight());
+    screenShader->setVec2("texelSize", 1.0f / target->GetAllocatedWidth(), 1.0f / target->GetAllocatedHeight());
+    screenShader->setFloat("sharpness", filter == UpscaleFilter::Sharpen ? UpscaleSharpness : 0.0f);
+}
+
 void ScreenRenderer::DrawTexture(unsigned int textureID)
+{
+    DrawTextureRegion(textureID, 0.0f, 0.0f, 1.0f, 1.0f);
+}
+
+void ScreenRenderer::DrawTextureRegion(unsigned int textureID, float x0, float y0, float x1, float y1)
 {
     glDisable(GL_DEPTH_TEST);
     screenShader->use();
+    screenShader->setVec4("region", x0, y0, x1, y1);
     glBindVertexArray(quadVAO);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, textureID);
@@ -3,15 +3,37 @@
 #include <glad/glad.h>
 #include "Shader.h"
 
+class Framebuffer;
+
+// 内部渲染分辨率低于输出时的放大方式
+enum class UpscaleFilter
+{
+    Bilinear, // 双线性
+    Sharpen   // 双线性 + 4 邻域反锐化掩模，补偿放大造成的模糊
+};
+
+const char *UpscaleFilterName(UpscaleFilter filter);
+bool ParseUpscaleFilter(const char *name, UpscaleFilter &filter);
+
+// 锐化放大的强度
+const float UpscaleSharpness = 0.25f;
+
 class ScreenRenderer
 {
 public:
     ScreenRenderer();
     ~ScreenRenderer();
     void Init();
+    // 之后绘制的纹理来自 target：按其内容尺寸缩放纹理坐标，锐化时按其分配尺寸取邻域；
+    // nullptr 表示整张纹理（此时不锐化）
+    void SetSource(const Framebuffer *target);
+    void SetUpscaleFilter(UpscaleFilter filter) { this->filter = filter; }
     void DrawTexture(unsigned int textureID);
+    // 只绘制纹理的一部分到屏幕对应位置（坐标为 0~1 的纹理坐标，原点在左下角）
+    void DrawTextureRegion(unsigned int textureID, float x0, float y0, float x1, float y1);
 
 private:
     unsigned int quadVAO, quadVBO;
     Shader *screenShader;
+    UpscaleFilter filter = UpscaleFilter::Bilinear;
 };
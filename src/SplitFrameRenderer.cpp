@@ -0,0 +1,367 @@
+#include "SplitFrameRenderer.h"
+#include "ScreenRenderer.h"
+#include "Scene.h"
+#include "Shader.h"
+#include "UploadThread.h"
+#include "FrameReadback.h"
+#include "RenderTargetPool.h"
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+const char *TileBalanceName(TileBalance balance)
+{
+    return balance == TileBalance::Static ? "static" : "dynamic";
+}
+
+bool ParseTileBalance(const char *name, TileBalance &balance)
+{
+    for (TileBalance b : {TileBalance::Static, TileBalance::Dynamic})
+    {
+        if (std::strcmp(name, TileBalanceName(b)) == 0)
+        {
+            balance = b;
+            return true;
+        }
+    }
+    return false;
+}
+
+SplitFrameRenderer::SplitFrameRenderer(GLFWwindow *shareWindow, int width, int height)
+    : shareWindow(shareWindow), width(width), height(height)
+{
+}
+
+SplitFrameRenderer::~SplitFrameRenderer()
+{
+    Stop();
+}
+
+void SplitFrameRenderer::Configure(int threadCount, int tileCount)
+{
+    this->threadCount = std::clamp(threadCount, 1, MaxThreads);
+    this->tileCount = std::clamp(tileCount, 1, MaxTiles);
+}
+
+void SplitFrameRenderer::Start(bool startPaused)
+{
+    paused = startPaused;
+    if (running)
+        return;
+
+    // 共享上下文窗口必须在主线程中创建
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    for (int i = 0; i < threadCount; ++i)
+    {
+        TileThread *t = new TileThread();
+        t->window = glfwCreateWindow(1, 1, "tile worker", NULL, shareWindow);
+        if (!t->window)
+        {
+            std::cerr << "无法创建分块渲染线程窗口/上下文" << std::endl;
+            delete t;
+            break;
+        }
+        threads.push_back(t);
+    }
+    if (threads.empty())
+        return;
+    threadCount = (int)threads.size();
+
+    tileOwner[0].assign(tileCount, 0);
+    tileOwner[1].assign(tileCount, 0);
+    displayedFrame = 0;
+    completedFrame = 0;
+    fpsFrames = 0;
+    latencyAccumMs = 0.0;
+    fpsWindowStart = std::chrono::steady_clock::now();
+
+    running = true;
+    {
+        std::lock_guard<std::mutex> lock(frameMutex);
+        KickFrame(1);
+    }
+    for (int i = 0; i < threadCount; ++i)
+        threads[i]->thread = std::thread(&SplitFrameRenderer::ThreadMain, this, i);
+}
+
+void SplitFrameRenderer::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(frameMutex);
+        running = false;
+    }
+    frameCv.notify_all();
+
+    for (TileThread *t : threads)
+    {
+        if (t->thread.joinable())
+            t->thread.join();
+        glfwDestroyWindow(t->window);
+        delete t;
+    }
+    threads.clear();
+    displayedFrame = 0;
+}
+
+void SplitFrameRenderer::KickFrame(uint64_t frame)
+{
+    frameInFlight = frame;
+    frameScene = pendingScene;
+    sceneFrames[frame & 1] = pendingScene.frame;
+    frameAssets = uploads ? uploads->CountResident() : 0;
+    frameBalance = balance.load();
+    kickTime = std::chrono::steady_clock::now();
+    nextTile = FrameTag(frame);
+    tilesDone = FrameTag(frame);
+}
+
+void SplitFrameRenderer::ThreadMain(int index)
+{
+    TileThread &self = *threads[index];
+    glfwMakeContextCurrent(self.window);
+
+    FramebufferDesc desc;
+    desc.width = width;
+    desc.height = height;
+    desc.colors[0] = colorFormat;
+    desc.samples = samples;
+    // 两组 FBO 从本线程的池取得：同一时刻只渲染其中一组，深度与多重采样颜色共享一份
+    RenderTargetPool *targets = new RenderTargetPool();
+    self.fbo[0] = targets->Acquire(desc);
+    self.fbo[1] = targets->Acquire(desc);
+    Scene *scene = new Scene(uploads);
+    Shader *shader = new Shader("shaders/scene.vert", "shaders/scene.frag");
+
+    uint64_t lastFrame = 0;
+    while (true)
+    {
+        uint64_t frame;
+        SceneState state;
+        int assets;
+        TileBalance mode;
+        {
+            std::unique_lock<std::mutex> lock(frameMutex);
+            frameCv.wait(lock, [&]() { return !running.load() || frameInFlight > lastFrame; });
+            if (!running)
+                break;
+            frame = frameInFlight;
+            state = frameScene;
+            assets = frameAssets;
+            mode = frameBalance;
+        }
+
+        scene->SetWorkload(targetWorkload.load());
+        scene->SyncUploads(assets);
+        int rendered = RenderTiles(index, frame, mode, state, scene, shader);
+        self.lastTileCount = rendered;
+        lastFrame = frame;
+
+        // 最后一个完成分块的线程负责标记整帧完成
+        if (tilesDone.fetch_add(rendered, std::memory_order_acq_rel) + rendered == FrameTag(frame) + tileCount)
+        {
+            std::lock_guard<std::mutex> lock(frameMutex);
+            completedFrame = frame;
+            lastLatencyMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - kickTime).count();
+        }
+    }
+
+    // 主线程已不再取帧，回收遗留栅栏与资源
+    for (int p = 0; p < 2; ++p)
+    {
+        if (GLsync f = self.readyFence[p].exchange(nullptr))
+            glDeleteSync(f);
+        if (GLsync f = self.releaseFence[p].exchange(nullptr))
+            glDeleteSync(f);
+        targets->Release(self.fbo[p]);
+        self.fbo[p] = nullptr;
+    }
+    delete targets;
+    delete shader;
+    delete scene;
+    glfwMakeContextCurrent(nullptr);
+}
+
+int SplitFrameRenderer::RenderTiles(int index, uint64_t frame, TileBalance frameBalance, const SceneState &state, Scene *scene, Shader *shader)
+{
+    TileThread &self = *threads[index];
+    int parity = (int)(frame & 1);
+
+    // 主线程可能仍在采样这组 FBO：GPU 端等待释放栅栏
+    if (GLsync release = self.releaseFence[parity].exchange(nullptr))
+    {
+        glWaitSync(release, 0, GL_TIMEOUT_IGNORED);
+        glDeleteSync(release);
+    }
+
+    Framebuffer *fbo = self.fbo[parity];
+    bool bound = false;
+    int count = 0;
+
+    auto renderTile = [&](int tile) {
+        if (!bound)
+        {
+            // 所有分块共用整帧的投影，只用 scissor 限定各自的子区域
+            fbo->Bind();
+            glEnable(GL_DEPTH_TEST);
+            glEnable(GL_SCISSOR_TEST);
+            glClearColor(state.clearColor.r, state.clearColor.g, state.clearColor.b, state.clearColor.a);
+            shader->use();
+            shader->setFloat("textureMix", scene->GetTexture() ? 1.0f : 0.0f);
+            shader->setMat4("view", state.view);
+            shader->setMat4("projection", state.projection);
+            bound = true;
+        }
+
+        int y0 = tile * height / tileCount;
+        int y1 = (tile + 1) * height / tileCount;
+        glScissor(0, y0, width, y1 - y0);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        scene->SetCoverage((float)(y1 - y0) / height);
+        for (int i = 0; i < state.objectCount; ++i)
+        {
+            shader->setMat4("model", state.objects[i].model);
+            scene->Draw(state.objects[i].mesh);
+        }
+        // scissor 仍限定在本分块：只解析自己渲染的区域
+        fbo->Resolve();
+        tileOwner[parity][tile] = index;
+        count++;
+    };
+
+    if (frameBalance == TileBalance::Static)
+    {
+        for (int tile = index; tile < tileCount; tile += threadCount)
+            renderTile(tile);
+    }
+    else
+    {
+        while (true)
+        {
+            uint64_t ticket = nextTile.fetch_add(1);
+            if ((ticket & ~0xffffffffull) != FrameTag(frame) || (int)(ticket & 0xffffffffull) >= tileCount)
+                break;
+            renderTile((int)(ticket & 0xffffffffull));
+        }
+    }
+
+    if (bound)
+    {
+        glDisable(GL_SCISSOR_TEST);
+        fbo->Unbind();
+        GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        glFlush();
+        self.readyFence[parity].store(fence);
+    }
+    return count;
+}
+
+bool SplitFrameRenderer::TryAcquireFrame()
+{
+    if (!running || paused)
+        return false;
+
+    uint64_t frame;
+    double latency;
+    {
+        std::lock_guard<std::mutex> lock(frameMutex);
+        frame = completedFrame;
+        latency = lastLatencyMs;
+    }
+    if (frame <= displayedFrame)
+        return false;
+
+    // 非阻塞检查所有线程的就绪栅栏
+    int parity = (int)(frame & 1);
+    for (TileThread *t : threads)
+    {
+        GLsync fence = t->readyFence[parity].load();
+        if (!fence)
+            continue;
+        GLint status = GL_UNSIGNALED;
+        glGetSynciv(fence, GL_SYNC_STATUS, 1, nullptr, &status);
+        if (status != GL_SIGNALED)
+            return false;
+    }
+    for (TileThread *t : threads)
+    {
+        if (GLsync fence = t->readyFence[parity].exchange(nullptr))
+            glDeleteSync(fence);
+    }
+
+    // 旧的一组 FBO 不再被采样：插入释放栅栏后归还给线程
+    if (displayedFrame > 0)
+    {
+        int oldParity = (int)(displayedFrame & 1);
+        for (TileThread *t : threads)
+        {
+            GLsync old = t->releaseFence[oldParity].exchange(glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+            if (old)
+                glDeleteSync(old);
+        }
+        glFlush();
+    }
+    displayedFrame = frame;
+
+    {
+        std::lock_guard<std::mutex> lock(frameMutex);
+        KickFrame(frame + 1);
+    }
+    frameCv.notify_all();
+
+    // 统计帧率与整帧延迟
+    fpsFrames++;
+    latencyAccumMs += latency;
+    auto now = std::chrono::steady_clock::now();
+    std::chrono::duration<double> elapsed = now - fpsWindowStart;
+    if (elapsed.count() >= 1.0)
+    {
+        fps = fpsFrames / elapsed.count();
+        frameLatencyMs = latencyAccumMs / fpsFrames;
+        fpsFrames = 0;
+        latencyAccumMs = 0.0;
+        fpsWindowStart = now;
+    }
+    return true;
+}
+
+void SplitFrameRenderer::Composite(ScreenRenderer *screen)
+{
+    if (displayedFrame == 0)
+        return;
+
+    int parity = (int)(displayedFrame & 1);
+    for (int tile = 0; tile < tileCount; ++tile)
+    {
+        TileThread *owner = threads[tileOwner[parity][tile]];
+        float y0 = (float)(tile * height / tileCount) / height;
+        float y1 = (float)((tile + 1) * height / tileCount) / height;
+        screen->DrawTextureRegion(owner->fbo[parity]->GetTextureID(), 0.0f, y0, 1.0f, y1);
+    }
+}
+
+bool SplitFrameRenderer::Readback(FrameReadback *readback)
+{
+    if (displayedFrame == 0 || !readback->BeginFrame(displayedFrame, width, height, GetSceneFrame()))
+        return false;
+
+    // 回读命令排在释放栅栏之前，线程复用这组 FBO 前 GPU 已完成读取
+    int parity = (int)(displayedFrame & 1);
+    for (int tile = 0; tile < tileCount; ++tile)
+    {
+        TileThread *owner = threads[tileOwner[parity][tile]];
+        int y0 = tile * height / tileCount;
+        int y1 = (tile + 1) * height / tileCount;
+        readback->ReadRegion(owner->fbo[parity]->GetTextureID(), 0, y0, width, y1 - y0);
+    }
+    readback->EndFrame();
+    return true;
+}
+
+std::vector<int> SplitFrameRenderer::GetTilesPerThread() const
+{
+    std::vector<int> counts;
+    for (TileThread *t : threads)
+        counts.push_back(t->lastTileCount.load());
+    return counts;
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Framebuffer.h"
+#include "SceneState.h"
+
+class ScreenRenderer;
+class FrameReadback;
+class UploadThread;
+class Scene;
+class Shader;
+
+// 分块分配策略
+enum class TileBalance
+{
+    Static, // 第 t 块固定由第 t % T 个线程渲染
+    Dynamic // 线程从共享计数器领取下一块，先完成者多做（负载均衡）
+};
+
+const char *TileBalanceName(TileBalance balance);
+bool ParseTileBalance(const char *name, TileBalance &balance);
+
+// 分帧渲染（SFR）：一帧按水平条带切分，由 T 个共享上下文的线程并行渲染，
+// 每块通过 scissor 限定在整帧投影中的子区域，最后由 ScreenRenderer 合成到屏幕。
+//
+// 帧流水线（两帧深）：主线程取走第 F 帧的同时启动第 F+1 帧，线程写入另一组 FBO；
+// 主线程切换到新帧时为旧一组 FBO 插入释放栅栏，线程复用前以 glWaitSync 等待。
+// 主线程不取帧时不会启动新帧，线程自然停在条件变量上（热待命）。
+class SplitFrameRenderer
+{
+public:
+    static const int MaxThreads = 8;
+    static const int MaxTiles = 32;
+
+    SplitFrameRenderer(GLFWwindow *shareWindow, int width, int height);
+    ~SplitFrameRenderer();
+
+    // 线程数与分块数在下次 Start() 时生效，分配策略立即生效
+    void Configure(int threadCount, int tileCount);
+    void SetBalance(TileBalance balance) { this->balance.store(balance); }
+    // 渲染目标的颜色格式与多重采样数，在下次 Start() 时生效
+    void SetColorFormat(ColorFormat format) { colorFormat = format; }
+    void SetSamples(int samples) { this->samples = samples; }
+    int GetThreadCount() const { return threadCount; }
+    int GetTileCount() const { return tileCount; }
+
+    void Start(bool startPaused = false);
+    void Stop();
+    void Pause() { paused = true; }
+    void Resume() { paused = false; }
+    bool IsRunning() const { return running.load(); }
+
+    void SetSceneWorkload(int load) { targetWorkload.store(load); }
+    // 主线程：设置下一次启动的帧所使用的场景快照
+    void PublishScene(const SceneState &state) { pendingScene = state; }
+    // 异步上传的资源来源，在下次 Start() 时生效
+    void SetUploadThread(const UploadThread *uploads) { this->uploads = uploads; }
+
+    // 主线程：非阻塞检查下一帧是否全部完成，完成则切换为当前帧并启动下一帧
+    bool TryAcquireFrame();
+    bool HasFrame() const { return displayedFrame > 0; }
+    // 当前帧所使用的场景快照帧号
+    uint64_t GetSceneFrame() const { return displayedFrame ? sceneFrames[displayedFrame & 1] : 0; }
+    // 主线程：将当前帧的所有分块绘制到当前帧缓冲
+    void Composite(ScreenRenderer *screen);
+    // 主线程：为当前帧的所有分块发起异步回读，拼成一整帧；回读环已满时返回 false
+    bool Readback(FrameReadback *readback);
+
+    double GetFPS() const { return fps; }
+    // 从启动一帧到所有分块完成的平均耗时（毫秒）
+    double GetFrameLatencyMs() const { return frameLatencyMs; }
+    // 每个线程最近一帧渲染的分块数
+    std::vector<int> GetTilesPerThread() const;
+
+private:
+    struct TileThread
+    {
+        GLFWwindow *window = nullptr;
+        std::thread thread;
+        Framebuffer *fbo[2] = {nullptr, nullptr};
+        std::atomic<GLsync> readyFence[2] = {{nullptr}, {nullptr}};
+        std::atomic<GLsync> releaseFence[2] = {{nullptr}, {nullptr}};
+        std::atomic<int> lastTileCount{0};
+    };
+
+    void ThreadMain(int index);
+    // 在线程中渲染第 frame 帧分配给自己的分块，返回渲染的分块数
+    int RenderTiles(int index, uint64_t frame, TileBalance frameBalance, const SceneState &state, Scene *scene, Shader *shader);
+    // 在持有 frameMutex 时启动下一帧
+    void KickFrame(uint64_t frame);
+    static uint64_t FrameTag(uint64_t frame) { return (frame & 0xffffffffull) << 32; }
+
+    GLFWwindow *shareWindow;
+    int width, height;
+    int threadCount = 4;
+    int tileCount = 8;
+    ColorFormat colorFormat = ColorFormat::Rgba8;
+    int samples = 0;
+    std::atomic<TileBalance> balance{TileBalance::Dynamic};
+    std::vector<TileThread *> threads;
+    const UploadThread *uploads = nullptr;
+
+    std::atomic<bool> running{false};
+    std::atomic<bool> paused{false};
+    std::atomic<int> targetWorkload{0};
+
+    // 帧协调（帧边界加锁，分块领取无锁）
+    std::mutex frameMutex;
+    std::condition_variable frameCv;
+    uint64_t frameInFlight = 0;  // 正在渲染的帧序号
+    uint64_t completedFrame = 0; // 最近全部完成的帧序号
+    SceneState frameScene;       // 启动帧时拷贝的场景快照，同一帧所有分块一致
+    uint64_t sceneFrames[2] = {0, 0}; // 按帧序号奇偶记录每帧所用快照的帧号（主线程访问）
+    int frameAssets = 0;         // 启动帧时已驻留的上传资源数，所有分块使用同一组资源
+    TileBalance frameBalance = TileBalance::Dynamic; // 同一帧内所有线程使用相同策略
+    std::chrono::steady_clock::time_point kickTime;
+    // 高 32 位为帧序号，低 32 位为计数；迟到的线程不会误领或误计下一帧的分块
+    std::atomic<uint64_t> nextTile{0};
+    std::atomic<uint64_t> tilesDone{0};
+    std::vector<int> tileOwner[2];
+
+    // 主线程状态
+    uint64_t displayedFrame = 0;
+    SceneState pendingScene;
+    double fps = 0.0;
+    double frameLatencyMs = 0.0;
+    double latencyAccumMs = 0.0;
+    int fpsFrames = 0;
+    std::chrono::steady_clock::time_point fpsWindowStart;
+    double lastLatencyMs = 0.0; // 受 frameMutex 保护
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+// 单生产者单消费者无锁环形队列
+// 生产者与消费者各自只写自己的索引，索引分处不同缓存行以避免伪共享
+template <typename T, size_t Capacity>
+class SpscRing
+{
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity 必须是 2 的幂");
+
+public:
+    // 生产者：要么全部写入，要么一条都不写（保证一帧的命令不被拆散）
+    bool TryPush(const T *items, size_t count)
+    {
+        size_t tailPos = tail.load(std::memory_order_relaxed);
+        size_t headPos = head.load(std::memory_order_acquire);
+        if (Capacity - (tailPos - headPos) < count)
+            return false;
+        for (size_t i = 0; i < count; ++i)
+            buffer[(tailPos + i) & (Capacity - 1)] = items[i];
+        tail.store(tailPos + count, std::memory_order_release);
+        return true;
+    }
+
+    // 消费者
+    bool TryPop(T &out)
+    {
+        size_t headPos = head.load(std::memory_order_relaxed);
+        if (headPos == tail.load(std::memory_order_acquire))
+            return false;
+        out = buffer[headPos & (Capacity - 1)];
+        head.store(headPos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 任意线程：近似的待消费条目数
+    size_t Size() const
+    {
+        return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+    }
+
+    // 生产者：可写入的条目数（只会比实际值小）
+    size_t FreeSpace() const
+    {
+        return Capacity - (tail.load(std::memory_order_relaxed) - head.load(std::memory_order_acquire));
+    }
+
+private:
+    alignas(64) std::atomic<size_t> head{0}; // 消费者写
+    alignas(64) std::atomic<size_t> tail{0}; // 生产者写
+    alignas(64) T buffer[Capacity];
+};
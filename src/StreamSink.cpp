@@ -0,0 +1,344 @@
+#include "StreamSink.h"
+#include <algorithm>
+#include <cstring>
+#include <csignal>
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+const char *SinkFormatName(SinkFormat format)
+{
+    switch (format)
+    {
+    case SinkFormat::Raw:
+        return "raw";
+    case SinkFormat::Y4m:
+        return "y4m";
+    }
+    return "unknown";
+}
+
+bool ParseSinkFormat(const char *name, SinkFormat &format)
+{
+    for (SinkFormat f : {SinkFormat::Raw, SinkFormat::Y4m})
+    {
+        if (std::strcmp(name, SinkFormatName(f)) == 0)
+        {
+            format = f;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char *SinkPolicyName(SinkPolicy policy)
+{
+    switch (policy)
+    {
+    case SinkPolicy::Block:
+        return "block";
+    case SinkPolicy::Drop:
+        return "drop";
+    }
+    return "unknown";
+}
+
+bool ParseSinkPolicy(const char *name, SinkPolicy &policy)
+{
+    for (SinkPolicy p : {SinkPolicy::Block, SinkPolicy::Drop})
+    {
+        if (std::strcmp(name, SinkPolicyName(p)) == 0)
+        {
+            policy = p;
+            return true;
+        }
+    }
+    return false;
+}
+
+int StreamSink::stdoutFd = -1;
+
+void StreamSink::ReserveStdout()
+{
+    if (stdoutFd >= 0)
+        return;
+    std::fflush(stdout);
+#ifdef _WIN32
+    stdoutFd = _dup(_fileno(stdout));
+    _dup2(_fileno(stderr), _fileno(stdout));
+    _setmode(stdoutFd, _O_BINARY);
+#else
+    stdoutFd = dup(STDOUT_FILENO);
+    dup2(STDERR_FILENO, STDOUT_FILENO);
+#endif
+}
+
+StreamSink::StreamSink(const std::string &path, SinkFormat format, SinkPolicy policy, double fps, int queueCapacity)
+    : format(format), policy(policy), fps(std::max(1.0, fps)), capacity(std::max(1, queueCapacity))
+{
+#ifndef _WIN32
+    // 下游关闭时让 write 返回错误而不是终止进程
+    std::signal(SIGPIPE, SIG_IGN);
+#endif
+    // 打开 FIFO 会阻塞到读端（编码器）就绪
+    if (path == "-")
+    {
+        ReserveStdout();
+#ifdef _WIN32
+        file = _fdopen(stdoutFd, "wb");
+#else
+        file = fdopen(stdoutFd, "wb");
+#endif
+    }
+    else
+    {
+        file = std::fopen(path.c_str(), "wb");
+    }
+    if (!file)
+    {
+        std::fprintf(stderr, "无法打开帧输出: %s\n", path.c_str());
+        return;
+    }
+    std::fprintf(stderr, "帧输出: %s  格式: %s  背压策略: %s  队列: %d 帧\n",
+                 path == "-" ? "stdout" : path.c_str(), SinkFormatName(format), SinkPolicyName(policy), capacity);
+    writerThread = std::thread(&StreamSink::WriterMain, this);
+}
+
+StreamSink::~StreamSink()
+{
+    Close();
+}
+
+void StreamSink::Push(const ReadbackFrame &frame)
+{
+    if (!file)
+        return;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    if (broken)
+        return;
+    if (width == 0)
+    {
+        width = frame.width;
+        height = frame.height;
+        layout = frame.format;
+        range = frame.range;
+        if (format == SinkFormat::Raw)
+            std::fprintf(stderr, "原始流参数: ffmpeg -f rawvideo -pix_fmt %s -s %dx%d -r %g -i <输入>\n",
+                         layout == ReadbackFormat::I420 ? "yuv420p" : "rgba", width, height, fps);
+    }
+    if (frame.width != width || frame.height != height || frame.format != layout)
+    {
+        // 流的尺寸与像素布局在首帧确定，不能中途改变
+        droppedFrames++;
+        LogBackpressure("尺寸或像素布局与输出流不符，丢弃帧", droppedFrames);
+        return;
+    }
+
+    if ((int)queue.size() >= capacity)
+    {
+        if (policy == SinkPolicy::Drop)
+        {
+            droppedFrames++;
+            LogBackpressure("写出跟不上，按策略丢弃帧", droppedFrames);
+            return;
+        }
+        // 阻塞生产者：背压沿主线程传回渲染队列
+        auto start = std::chrono::steady_clock::now();
+        notFull.wait(lock, [this]() { return (int)queue.size() < capacity || broken; });
+        blockedFrames++;
+        blockedMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        LogBackpressure("写出跟不上，按策略阻塞生产者", blockedFrames);
+        if (broken)
+            return;
+    }
+
+    QueuedFrame queued;
+    queued.frameIndex = frame.frameIndex;
+    if (!freeBuffers.empty())
+    {
+        queued.pixels = std::move(freeBuffers.back());
+        freeBuffers.pop_back();
+    }
+    queued.pixels.resize(frame.bytes);
+    std::memcpy(queued.pixels.data(), frame.pixels, frame.bytes);
+    queue.push_back(std::move(queued));
+    lock.unlock();
+    notEmpty.notify_one();
+}
+
+void StreamSink::Close()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        closing = true;
+    }
+    notEmpty.notify_all();
+    if (writerThread.joinable())
+        writerThread.join();
+
+    if (file)
+    {
+        std::fclose(file);
+        file = nullptr;
+        std::fprintf(stderr, "帧输出结束  写出: %llu 帧  丢弃: %llu 帧  阻塞: %llu 次 (共 %.1f ms)\n",
+                     writtenFrames, droppedFrames, blockedFrames, blockedMs);
+    }
+}
+
+void StreamSink::LogBackpressure(const char *what, unsigned long long count)
+{
+    auto now = std::chrono::steady_clock::now();
+    if (now - lastLog < std::chrono::seconds(1))
+        return;
+    lastLog = now;
+    std::fprintf(stderr, "[帧输出] %s（累计 %llu）\n", what, count);
+}
+
+void StreamSink::WriterMain()
+{
+    bool headerWritten = false;
+    while (true)
+    {
+        QueuedFrame frame;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            notEmpty.wait(lock, [this]() { return closing || !queue.empty(); });
+            if (queue.empty())
+                break;
+            frame = std::move(queue.front());
+            queue.pop_front();
+        }
+        notFull.notify_one();
+
+        bool ok = true;
+        if (!headerWritten && format == SinkFormat::Y4m)
+        {
+            // 帧率以有理数表示，保留三位小数精度
+            int num = (int)(fps * 1000.0 + 0.5);
+            ok = std::fprintf(file, "YUV4MPEG2 W%d H%d F%d:1000 Ip A1:1 C420jpeg XYSCSS=420JPEG XCOLORRANGE=%s\n", width, height, num,
+                              range == YuvRange::Full ? "FULL" : "LIMITED") > 0;
+        }
+        headerWritten = true;
+        ok = ok && WriteFrame(frame);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        freeBuffers.push_back(std::move(frame.pixels));
+        if (!ok)
+        {
+            // 下游已关闭：之后的帧全部丢弃，不再阻塞生产者
+            broken = true;
+            queue.clear();
+            std::fprintf(stderr, "[帧输出] 写出失败，下游可能已关闭，停止输出\n");
+            notFull.notify_all();
+            break;
+        }
+        writtenFrames++;
+    }
+}
+
+bool StreamSink::WriteFrame(const QueuedFrame &frame)
+{
+    const unsigned char *pixels = frame.pixels.data();
+    size_t rowBytes = (size_t)width * 4;
+
+    // GPU 已转换好的 I420 帧：两种格式都原样写出平面
+    if (layout == ReadbackFormat::I420)
+    {
+        if (format == SinkFormat::Y4m && std::fwrite("FRAME\n", 1, 6, file) != 6)
+            return false;
+        if (std::fwrite(pixels, 1, frame.pixels.size(), file) != frame.pixels.size())
+            return false;
+        return std::fflush(file) == 0;
+    }
+
+    if (format == SinkFormat::Raw)
+    {
+        // OpenGL 行序自底向上，逐行倒序写出
+        for (int y = height - 1; y >= 0; --y)
+        {
+            if (std::fwrite(pixels + y * rowBytes, 1, rowBytes, file) != rowBytes)
+                return false;
+        }
+        return std::fflush(file) == 0;
+    }
+
+    // RGBA -> I420（BT.601 全范围），同时垂直翻转
+    int chromaW = (width + 1) / 2, chromaH = (height + 1) / 2;
+    size_t lumaSize = (size_t)width * height, chromaSize = (size_t)chromaW * chromaH;
+    converted.resize(lumaSize + 2 * chromaSize);
+    unsigned char *yPlane = converted.data();
+    unsigned char *uPlane = yPlane + lumaSize;
+    unsigned char *vPlane = uPlane + chromaSize;
+
+    auto clampByte = [](float v) { return (unsigned char)std::clamp(v + 0.5f, 0.0f, 255.0f); };
+    for (int y = 0; y < height; ++y)
+    {
+        const unsigned char *row = pixels + (size_t)(height - 1 - y) * rowBytes;
+        for (int x = 0; x < width; ++x)
+        {
+            const unsigned char *p = row + x * 4;
+            yPlane[(size_t)y * width + x] = clampByte(0.299f * p[0] + 0.587f * p[1] + 0.114f * p[2]);
+        }
+    }
+    for (int cy = 0; cy < chromaH; ++cy)
+    {
+        for (int cx = 0; cx < chromaW; ++cx)
+        {
+            // 2x2 像素取平均后计算色度
+            float r = 0.0f, g = 0.0f, b = 0.0f;
+            int n = 0;
+            for (int dy = 0; dy < 2; ++dy)
+            {
+                int y = std::min(cy * 2 + dy, height - 1);
+                const unsigned char *row = pixels + (size_t)(height - 1 - y) * rowBytes;
+                for (int dx = 0; dx < 2; ++dx)
+                {
+                    const unsigned char *p = row + std::min(cx * 2 + dx, width - 1) * 4;
+                    r += p[0];
+                    g += p[1];
+                    b += p[2];
+                    n++;
+                }
+            }
+            r /= n;
+            g /= n;
+            b /= n;
+            uPlane[(size_t)cy * chromaW + cx] = clampByte(-0.168736f * r - 0.331264f * g + 0.5f * b + 128.0f);
+            vPlane[(size_t)cy * chromaW + cx] = clampByte(0.5f * r - 0.418688f * g - 0.081312f * b + 128.0f);
+        }
+    }
+
+    if (std::fwrite("FRAME\n", 1, 6, file) != 6)
+        return false;
+    if (std::fwrite(converted.data(), 1, converted.size(), file) != converted.size())
+        return false;
+    return std::fflush(file) == 0;
+}
+
+unsigned long long StreamSink::GetWrittenFrames() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return writtenFrames;
+}
+
+unsigned long long StreamSink::GetDroppedFrames() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return droppedFrames;
+}
+
+unsigned long long StreamSink::GetBlockedFrames() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return blockedFrames;
+}
+
+double StreamSink::GetBlockedMs() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return blockedMs;
+}
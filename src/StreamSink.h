@@ -0,0 +1,100 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "FrameReadback.h"
+
+// 输出流格式
+enum class SinkFormat
+{
+    Raw, // 原始帧，自顶向下，无任何头部：RGBA8（-pix_fmt rgba），GPU 转换 YUV 时为 I420（-pix_fmt yuv420p）
+    Y4m  // YUV4MPEG2 4:2:0，头部携带尺寸与帧率；回读为 RGBA 时在写出线程按全范围 BT.601 转换
+};
+
+// 写出跟不上时的背压策略
+enum class SinkPolicy
+{
+    Block, // 阻塞生产者（主线程）直到写出线程腾出空间，不丢帧
+    Drop   // 丢弃新帧，生产者永不等待
+};
+
+const char *SinkFormatName(SinkFormat format);
+bool ParseSinkFormat(const char *name, SinkFormat &format);
+const char *SinkPolicyName(SinkPolicy policy);
+bool ParseSinkPolicy(const char *name, SinkPolicy &policy);
+
+// 帧流输出：把回读到的帧写到 stdout 或命名管道（FIFO）/文件，供外部编码器读取。
+// 回读回调只把像素拷贝进有界队列，格式转换、垂直翻转与写出都在独立的写出线程中完成；
+// 回读已在 GPU 上转换为 I420 时直接写出，不再经过 CPU 转换。
+// 写到 stdout 时，进程的其他输出被重定向到 stderr，保证数据流干净。
+class StreamSink
+{
+public:
+    // path 为 "-" 时写到 stdout；queueCapacity 为队列中最多缓存的帧数
+    StreamSink(const std::string &path, SinkFormat format, SinkPolicy policy, double fps, int queueCapacity);
+    ~StreamSink();
+
+    bool IsOpen() const { return file != nullptr; }
+
+    // 把进程的 stdout 留给数据流，之后 printf / std::cout 的输出改写到 stderr。
+    // 应在任何日志输出之前调用；构造写到 "-" 的 StreamSink 时会自动调用（可重复调用）
+    static void ReserveStdout();
+
+    // 主线程（回读回调）：入队一帧；队列满时按策略阻塞或丢弃
+    void Push(const ReadbackFrame &frame);
+    // 写完队列中剩余的帧并关闭输出
+    void Close();
+
+    unsigned long long GetWrittenFrames() const;
+    unsigned long long GetDroppedFrames() const;
+    unsigned long long GetBlockedFrames() const;
+    double GetBlockedMs() const;
+
+private:
+    struct QueuedFrame
+    {
+        uint64_t frameIndex = 0;
+        std::vector<unsigned char> pixels;
+    };
+
+    void WriterMain();
+    bool WriteFrame(const QueuedFrame &frame);
+    // 限频日志：同一类事件每秒最多输出一条
+    void LogBackpressure(const char *what, unsigned long long count);
+
+    static int stdoutFd; // ReserveStdout 保存的原 stdout 描述符，-1 表示尚未保留
+
+    FILE *file = nullptr;
+    SinkFormat format;
+    SinkPolicy policy;
+    double fps;
+    int capacity;
+    int width = 0, height = 0; // 首帧决定，之后尺寸或像素布局不同的帧被丢弃
+    ReadbackFormat layout = ReadbackFormat::Rgba8;
+    YuvRange range = YuvRange::Full;
+
+    std::thread writerThread;
+    mutable std::mutex mutex;
+    std::condition_variable notEmpty;
+    std::condition_variable notFull;
+    std::deque<QueuedFrame> queue;
+    std::vector<std::vector<unsigned char>> freeBuffers;
+    bool closing = false;
+    bool broken = false; // 下游已关闭（例如编码器退出）
+
+    unsigned long long writtenFrames = 0;
+    unsigned long long droppedFrames = 0;
+    unsigned long long blockedFrames = 0;
+    double blockedMs = 0.0;
+    std::chrono::steady_clock::time_point lastLog;
+
+    // 写出线程私有
+    std::vector<unsigned char> converted;
+};
@@ -0,0 +1,150 @@
+#include "TransientHeap.h"
+#include "RenderTargetPool.h"
+#include <algorithm>
+
+TransientHeap::~TransientHeap()
+{
+    for (Block &block : blocks)
+        Free(block);
+    RenderTargetPool::AccountTransient(-(long long)virtualBytes, 0);
+}
+
+int TransientHeap::Register(GLenum internalFormat, int samples, int width, int height, int bytesPerPixel)
+{
+    Attachment attachment;
+    attachment.registered = true;
+    attachment.format = internalFormat;
+    attachment.samples = samples;
+    attachment.width = width;
+    attachment.height = height;
+    attachment.bytesPerPixel = bytesPerPixel;
+
+    size_t bytes = Bytes(width, height, bytesPerPixel, samples);
+    virtualBytes += bytes;
+    RenderTargetPool::AccountTransient((long long)bytes, 0);
+
+    for (size_t i = 0; i < attachments.size(); ++i)
+    {
+        if (!attachments[i].registered)
+        {
+            attachments[i] = attachment;
+            return (int)i;
+        }
+    }
+    attachments.push_back(attachment);
+    return (int)attachments.size() - 1;
+}
+
+void TransientHeap::Unregister(int handle)
+{
+    Attachment &attachment = attachments[handle];
+    if (!attachment.registered)
+        return;
+    Release(handle);
+    attachment.registered = false;
+    size_t bytes = Bytes(attachment.width, attachment.height, attachment.bytesPerPixel, attachment.samples);
+    virtualBytes -= bytes;
+    RenderTargetPool::AccountTransient(-(long long)bytes, 0);
+
+    // 同格式剩余使用者的最大尺寸：没有使用者时释放块，否则收缩到该尺寸
+    int maxWidth = 0, maxHeight = 0;
+    for (const Attachment &other : attachments)
+    {
+        if (other.registered && other.format == attachment.format && other.samples == attachment.samples)
+        {
+            maxWidth = std::max(maxWidth, other.width);
+            maxHeight = std::max(maxHeight, other.height);
+        }
+    }
+    for (Block &block : blocks)
+    {
+        if (!block.renderbuffer || block.format != attachment.format || block.samples != attachment.samples)
+            continue;
+        if (maxWidth == 0)
+            Free(block);
+        else if (block.owner < 0 && (block.width > maxWidth || block.height > maxHeight))
+            Allocate(block, std::min(block.width, maxWidth), std::min(block.height, maxHeight));
+    }
+}
+
+unsigned int TransientHeap::Acquire(int handle)
+{
+    Attachment &attachment = attachments[handle];
+    auto usable = [&](const Block &block) {
+        return block.renderbuffer && block.owner < 0 && block.format == attachment.format && block.samples == attachment.samples;
+    };
+
+    // 上一次的块空闲时直接沿用；否则取任意空闲的同类块（需要时放大），都被占用时新建
+    int chosen = -1;
+    if (attachment.block >= 0 && usable(blocks[attachment.block]))
+        chosen = attachment.block;
+    for (int i = 0; chosen < 0 && i < (int)blocks.size(); ++i)
+    {
+        if (usable(blocks[i]))
+            chosen = i;
+    }
+    if (chosen < 0)
+    {
+        for (int i = 0; chosen < 0 && i < (int)blocks.size(); ++i)
+        {
+            if (!blocks[i].renderbuffer)
+                chosen = i;
+        }
+        if (chosen < 0)
+        {
+            blocks.emplace_back();
+            chosen = (int)blocks.size() - 1;
+        }
+        Block &block = blocks[chosen];
+        block.format = attachment.format;
+        block.samples = attachment.samples;
+        block.bytesPerPixel = attachment.bytesPerPixel;
+        glGenRenderbuffers(1, &block.renderbuffer);
+        Allocate(block, attachment.width, attachment.height);
+    }
+
+    Block &block = blocks[chosen];
+    if (block.width < attachment.width || block.height < attachment.height)
+        Allocate(block, std::max(block.width, attachment.width), std::max(block.height, attachment.height));
+    block.owner = handle;
+    attachment.block = chosen;
+    return block.renderbuffer;
+}
+
+void TransientHeap::Release(int handle)
+{
+    int index = attachments[handle].block;
+    if (index >= 0 && blocks[index].owner == handle)
+        blocks[index].owner = -1;
+}
+
+int TransientHeap::GetBlockCount() const
+{
+    int count = 0;
+    for (const Block &block : blocks)
+        count += block.renderbuffer ? 1 : 0;
+    return count;
+}
+
+void TransientHeap::Allocate(Block &block, int width, int height)
+{
+    size_t before = block.width > 0 ? Bytes(block.width, block.height, block.bytesPerPixel, block.samples) : 0;
+    block.width = width;
+    block.height = height;
+    glBindRenderbuffer(GL_RENDERBUFFER, block.renderbuffer);
+    glRenderbufferStorageMultisample(GL_RENDERBUFFER, block.samples, block.format, width, height);
+    size_t after = Bytes(width, height, block.bytesPerPixel, block.samples);
+    physicalBytes = physicalBytes - before + after;
+    RenderTargetPool::AccountTransient(0, (long long)after - (long long)before);
+}
+
+void TransientHeap::Free(Block &block)
+{
+    if (!block.renderbuffer)
+        return;
+    glDeleteRenderbuffers(1, &block.renderbuffer);
+    size_t bytes = Bytes(block.width, block.height, block.bytesPerPixel, block.samples);
+    physicalBytes -= bytes;
+    RenderTargetPool::AccountTransient(0, -(long long)bytes);
+    block = Block();
+}
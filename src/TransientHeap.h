@@ -0,0 +1,66 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <cstddef>
+#include <vector>
+
+// 瞬态附件堆：按帧内生命期让互不重叠的渲染缓冲附件共享存储。
+// 深度/模板渲染缓冲与多重采样颜色渲染缓冲只在一个目标的 Bind() 到 Unbind() 之间有意义
+// （之后没有人读取深度，多重采样颜色已解析到纹理），同一上下文中的命令按提交顺序执行，
+// 因此生命期不重叠的附件可以放在同一个渲染缓冲里。
+// 生命期在运行时分析：Acquire 时取一个同格式、同采样数且此刻空闲的块，没有时才新建，
+// 同时存活的附件（例如同一目标的两个多重采样颜色附件）必然落在不同的块上。
+// 块的尺寸取使用者中的最大值（GL 3.0 起附件尺寸可以不同，渲染区域取交集）。
+// FBO 不在上下文间共享：每个渲染线程各自持有一个堆（随渲染目标池），只在该线程的上下文中使用。
+class TransientHeap
+{
+public:
+    ~TransientHeap();
+
+    // 登记一个瞬态附件，返回句柄；bytesPerPixel 为单个采样的字节数
+    int Register(GLenum internalFormat, int samples, int width, int height, int bytesPerPixel);
+    // 注销附件；某种格式不再有使用者时释放它的块，否则按剩余使用者收缩
+    void Unregister(int handle);
+    // 附件生命期开始：返回此刻承载它的渲染缓冲（尽量沿用上一次的块，避免重新挂接）
+    unsigned int Acquire(int handle);
+    // 附件生命期结束，块可以交给其他附件
+    void Release(int handle);
+
+    // 不共享时这些附件需要的显存，与实际分配的显存
+    size_t GetVirtualBytes() const { return virtualBytes; }
+    size_t GetPhysicalBytes() const { return physicalBytes; }
+    int GetBlockCount() const;
+
+private:
+    struct Attachment
+    {
+        bool registered = false;
+        GLenum format = 0;
+        int samples = 0;
+        int width = 0, height = 0;
+        int bytesPerPixel = 0;
+        int block = -1; // 最近一次承载它的块
+    };
+    struct Block
+    {
+        unsigned int renderbuffer = 0; // 0 表示已释放的空位
+        GLenum format = 0;
+        int samples = 0;
+        int width = 0, height = 0;
+        int bytesPerPixel = 0;
+        int owner = -1; // 当前占用它的附件，-1 表示空闲
+    };
+
+    static size_t Bytes(int width, int height, int bytesPerPixel, int samples)
+    {
+        return (size_t)width * height * bytesPerPixel * (samples > 0 ? samples : 1);
+    }
+    // 把块的存储改为 width x height（内容不保留）
+    void Allocate(Block &block, int width, int height);
+    void Free(Block &block);
+
+    std::vector<Attachment> attachments;
+    std::vector<Block> blocks;
+    size_t virtualBytes = 0;
+    size_t physicalBytes = 0;
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// 无锁三缓冲：单写者写入后缓冲并原子发布，单读者总是取到最新的完整快照
+// 写者与读者各自独占一个缓冲，中间缓冲通过一次原子交换在两者之间传递，读者永远不会看到写了一半的数据
+template <typename T>
+class TripleBuffer
+{
+public:
+    // 写者：取得可写的后缓冲
+    T &Back() { return buffers[backIndex]; }
+
+    // 写者：发布后缓冲，与中间缓冲交换
+    void Publish()
+    {
+        uint8_t previous = middle.exchange((uint8_t)(backIndex | DirtyBit), std::memory_order_acq_rel);
+        backIndex = previous & IndexMask;
+    }
+
+    void Publish(const T &value)
+    {
+        Back() = value;
+        Publish();
+    }
+
+    // 读者：若有新发布的快照则切换到它，返回是否有更新
+    bool Update()
+    {
+        if (!(middle.load(std::memory_order_relaxed) & DirtyBit))
+            return false;
+        uint8_t previous = middle.exchange((uint8_t)frontIndex, std::memory_order_acq_rel);
+        frontIndex = previous & IndexMask;
+        return true;
+    }
+
+    // 读者：当前持有的快照
+    const T &Front() const { return buffers[frontIndex]; }
+
+private:
+    static const uint8_t DirtyBit = 0x4;
+    static const uint8_t IndexMask = 0x3;
+
+    T buffers[3]{};
+    int backIndex = 0;  // 仅写者访问
+    int frontIndex = 1; // 仅读者访问
+    std::atomic<uint8_t> middle{2};
+};
@@ -0,0 +1,253 @@
+#include "UploadThread.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+UploadThread::UploadThread(GLFWwindow *shareWindow)
+    : shareWindow(shareWindow), uploadWindow(nullptr)
+{
+    // 与 Worker 相同：隐藏窗口只为提供共享上下文，必须在主线程中创建
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    uploadWindow = glfwCreateWindow(1, 1, "upload", NULL, shareWindow);
+    if (!uploadWindow)
+    {
+        std::cerr << "无法创建上传线程窗口/上下文" << std::endl;
+    }
+}
+
+UploadThread::~UploadThread()
+{
+    Stop();
+    if (uploadWindow)
+    {
+        glfwDestroyWindow(uploadWindow);
+        uploadWindow = nullptr;
+    }
+}
+
+void UploadThread::Start()
+{
+    if (uploadThread.joinable() || !uploadWindow)
+        return;
+    running = true;
+    uploadThread = std::thread(&UploadThread::ThreadMain, this);
+}
+
+void UploadThread::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(requestMutex);
+        running = false;
+    }
+    requestCv.notify_all();
+    if (uploadThread.joinable())
+        uploadThread.join();
+}
+
+int UploadThread::UploadMesh(std::vector<float> vertices)
+{
+    UploadRequest request;
+    request.type = UploadType::Mesh;
+    request.vertices = std::move(vertices);
+    return Enqueue(std::move(request));
+}
+
+int UploadThread::UploadTexture(int width, int height, std::vector<unsigned char> rgba)
+{
+    if ((size_t)width * height * 4 != rgba.size())
+    {
+        std::cerr << "纹理数据大小与尺寸不符: " << width << "x" << height << std::endl;
+        return -1;
+    }
+    UploadRequest request;
+    request.type = UploadType::Texture;
+    request.pixels = std::move(rgba);
+    request.width = width;
+    request.height = height;
+    return Enqueue(std::move(request));
+}
+
+int UploadThread::Enqueue(UploadRequest &&request)
+{
+    int index;
+    {
+        std::lock_guard<std::mutex> lock(requestMutex);
+        if (nextAsset >= MaxAssets)
+        {
+            std::cerr << "上传资源数已达上限 " << MaxAssets << std::endl;
+            return -1;
+        }
+        index = nextAsset++;
+        requests.push_back(std::move(request));
+        pendingUploads++;
+    }
+    requestCv.notify_one();
+    return index;
+}
+
+int UploadThread::CountResident() const
+{
+    int count = GetPublishedCount();
+    for (int i = 0; i < count; ++i)
+    {
+        GLint status = GL_UNSIGNALED;
+        glGetSynciv(assets[i].fence, GL_SYNC_STATUS, 1, nullptr, &status);
+        if (status != GL_SIGNALED)
+            return i;
+    }
+    return count;
+}
+
+UploadThread::StagingSlot &UploadThread::AcquireStaging()
+{
+    StagingSlot &slot = staging[nextStaging];
+    nextStaging = (nextStaging + 1) % StagingSlots;
+
+    // 上传线程不在渲染热路径上，可以在 CPU 端等待暂存缓冲被 GPU 读完
+    if (slot.fence)
+    {
+        while (glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000) == GL_TIMEOUT_EXPIRED)
+        {
+        }
+        glDeleteSync(slot.fence);
+        slot.fence = nullptr;
+    }
+    return slot;
+}
+
+void UploadThread::UploadMeshData(const UploadRequest &request, UploadedAsset &asset)
+{
+    size_t total = request.vertices.size() * sizeof(float);
+    const unsigned char *src = (const unsigned char *)request.vertices.data();
+
+    glGenBuffers(1, &asset.name);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, asset.name);
+    glBufferData(GL_COPY_WRITE_BUFFER, total, nullptr, GL_STATIC_DRAW);
+
+    for (size_t offset = 0; offset < total; offset += StagingSize)
+    {
+        size_t chunk = std::min(StagingSize, total - offset);
+        StagingSlot &slot = AcquireStaging();
+        glBindBuffer(GL_COPY_READ_BUFFER, slot.buffer);
+        void *dst = glMapBufferRange(GL_COPY_READ_BUFFER, 0, chunk, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+        std::memcpy(dst, src + offset, chunk);
+        glUnmapBuffer(GL_COPY_READ_BUFFER);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, offset, chunk);
+        slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    asset.vertexCount = (int)(request.vertices.size() / 5);
+    uploadedBytes += total;
+}
+
+void UploadThread::UploadTextureData(const UploadRequest &request, UploadedAsset &asset)
+{
+    size_t rowBytes = (size_t)request.width * 4;
+    int rowsPerChunk = (int)std::max<size_t>(1, StagingSize / rowBytes);
+
+    glGenTextures(1, &asset.name);
+    glBindTexture(GL_TEXTURE_2D, asset.name);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, request.width, request.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+    // 按行分块：每块经 PBO 由 glTexSubImage2D 异步拷贝到纹理
+    for (int y = 0; y < request.height; y += rowsPerChunk)
+    {
+        int rows = std::min(rowsPerChunk, request.height - y);
+        size_t chunk = rows * rowBytes;
+        StagingSlot &slot = AcquireStaging();
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.buffer);
+        void *dst = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, chunk, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+        std::memcpy(dst, request.pixels.data() + y * rowBytes, chunk);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, y, request.width, rows, GL_RGBA, GL_UNSIGNED_BYTE, (void *)0);
+        slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    asset.width = request.width;
+    asset.height = request.height;
+    uploadedBytes += request.pixels.size();
+}
+
+void UploadThread::ThreadMain()
+{
+    glfwMakeContextCurrent(uploadWindow);
+
+    // 暂存缓冲环：整个生命周期只分配一次
+    for (StagingSlot &slot : staging)
+    {
+        glGenBuffers(1, &slot.buffer);
+        glBindBuffer(GL_COPY_READ_BUFFER, slot.buffer);
+        glBufferData(GL_COPY_READ_BUFFER, StagingSize, nullptr, GL_STREAM_DRAW);
+    }
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+
+    while (true)
+    {
+        UploadRequest request;
+        {
+            std::unique_lock<std::mutex> lock(requestMutex);
+            requestCv.wait(lock, [this]() { return !running.load() || !requests.empty(); });
+            if (!running)
+                break;
+            request = std::move(requests.front());
+            requests.pop_front();
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        int index = published.load();
+        UploadedAsset &asset = assets[index];
+        asset.type = request.type;
+        if (request.type == UploadType::Mesh)
+            UploadMeshData(request, asset);
+        else
+            UploadTextureData(request, asset);
+
+        // 完成栅栏：渲染线程轮询到 signaled 后才把资源加入场景
+        asset.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        glFlush();
+        published.store(index + 1, std::memory_order_release);
+        pendingUploads--;
+
+        busySeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (busySeconds > 0.0)
+            throughputMBps.store(uploadedBytes.load() / (1024.0 * 1024.0) / busySeconds);
+    }
+
+    // 未处理的请求随线程一起丢弃
+    {
+        std::lock_guard<std::mutex> lock(requestMutex);
+        requests.clear();
+        nextAsset = 0;
+        pendingUploads = 0;
+    }
+
+    // 渲染线程已全部停止，可以回收共享资源
+    for (StagingSlot &slot : staging)
+    {
+        if (slot.fence)
+            glDeleteSync(slot.fence);
+        glDeleteBuffers(1, &slot.buffer);
+        slot = StagingSlot();
+    }
+    int count = published.exchange(0);
+    for (int i = 0; i < count; ++i)
+    {
+        UploadedAsset &asset = assets[i];
+        if (asset.type == UploadType::Mesh)
+            glDeleteBuffers(1, &asset.name);
+        else
+            glDeleteTextures(1, &asset.name);
+        glDeleteSync(asset.fence);
+        asset = UploadedAsset();
+    }
+    glfwMakeContextCurrent(nullptr);
+}
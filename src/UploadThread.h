@@ -0,0 +1,105 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 上传完成的资源类型
+enum class UploadType
+{
+    Mesh,   // 顶点缓冲（位置 vec3 + 纹理坐标 vec2，与立方体布局一致）
+    Texture // RGBA8 二维纹理
+};
+
+// 已提交到 GPU 的资源；发布后不再修改，渲染线程轮询 fence 确认完全驻留后才使用
+struct UploadedAsset
+{
+    UploadType type = UploadType::Mesh;
+    unsigned int name = 0; // 缓冲或纹理对象（上下文间共享）
+    int vertexCount = 0;
+    int width = 0, height = 0;
+    GLsync fence = nullptr;
+};
+
+// 异步上传线程：第三个共享上下文，通过暂存缓冲环（PBO / 复制源缓冲）分块把顶点与纹理数据流式上传到 GPU，
+// 渲染线程不再承担 glBufferData / glTexImage2D 的拷贝耗时。
+//
+// 每个暂存槽位复用前等待其上一次拷贝的栅栏；一个资源的全部分块提交后插入完成栅栏并按请求顺序发布。
+// 资源编号在请求时分配，等于发布顺序。
+class UploadThread
+{
+public:
+    static const int MaxAssets = 64;
+    static const int StagingSlots = 4;
+    static const size_t StagingSize = 4 * 1024 * 1024;
+
+    explicit UploadThread(GLFWwindow *shareWindow);
+    ~UploadThread();
+
+    void Start();
+    void Stop();
+
+    // 请求上传（任意线程），返回资源编号；资源数已满时返回 -1
+    int UploadMesh(std::vector<float> vertices);
+    int UploadTexture(int width, int height, std::vector<unsigned char> rgba);
+
+    // 渲染线程：已发布的资源数与资源描述（编号小于发布数的条目只读、无需加锁）
+    int GetPublishedCount() const { return published.load(std::memory_order_acquire); }
+    const UploadedAsset &GetAsset(int index) const { return assets[index]; }
+    // 非阻塞：按编号顺序统计完成栅栏已触发的资源数（需在任一共享上下文中调用）
+    int CountResident() const;
+
+    // 统计
+    int GetPendingUploads() const { return pendingUploads.load(); }
+    unsigned long long GetUploadedBytes() const { return uploadedBytes.load(); }
+    // 上传线程忙碌期间的平均吞吐量（MB/s）
+    double GetThroughputMBps() const { return throughputMBps.load(); }
+
+private:
+    struct UploadRequest
+    {
+        UploadType type;
+        std::vector<float> vertices;
+        std::vector<unsigned char> pixels;
+        int width = 0, height = 0;
+    };
+
+    struct StagingSlot
+    {
+        unsigned int buffer = 0;
+        GLsync fence = nullptr;
+    };
+
+    void ThreadMain();
+    int Enqueue(UploadRequest &&request);
+    // 取得下一个暂存槽位，必要时等待其上一次拷贝完成
+    StagingSlot &AcquireStaging();
+    void UploadMeshData(const UploadRequest &request, UploadedAsset &asset);
+    void UploadTextureData(const UploadRequest &request, UploadedAsset &asset);
+
+    GLFWwindow *shareWindow;
+    GLFWwindow *uploadWindow;
+    std::thread uploadThread;
+    std::atomic<bool> running{false};
+
+    std::mutex requestMutex;
+    std::condition_variable requestCv;
+    std::deque<UploadRequest> requests;
+    int nextAsset = 0; // 受 requestMutex 保护
+
+    UploadedAsset assets[MaxAssets];
+    std::atomic<int> published{0};
+
+    StagingSlot staging[StagingSlots];
+    int nextStaging = 0; // 仅上传线程访问
+
+    std::atomic<int> pendingUploads{0};
+    std::atomic<unsigned long long> uploadedBytes{0};
+    std::atomic<double> throughputMBps{0.0};
+    double busySeconds = 0.0; // 仅上传线程访问
+};
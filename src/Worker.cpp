@@ -1,13 +1,12 @@
 #include "Worker.h"
 #include "Shader.h"
-#include <glm/glm.hpp>
-#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
 #include <iostream>
 #include <chrono>
 
 Worker::Worker(GLFWwindow *shareWindow, int width, int height)
     : shareWindow(shareWindow), workerWindow(nullptr), width(width), height(height),
-      fboA(nullptr), fboB(nullptr), frontFbo(nullptr), backFbo(nullptr), scene(nullptr), running(false), frontTexture(0), latestFence(nullptr)
+      queue(nullptr), scene(nullptr), running(false)
 {
     // 创建一个不可见的窗口，与主窗口共享资源
     // 必须在主线程中完成
@@ -24,8 +23,18 @@ Worker::~Worker()
     Stop();
 }
 
-void Worker::Start()
+void Worker::Start(bool startPaused)
 {
+    // 线程仍驻留时只需切换待命状态
+    if (workerThread.joinable())
+    {
+        if (startPaused)
+            Pause();
+        else
+            Resume();
+        return;
+    }
+
     // 如果窗口被销毁，重建它
     if (!workerWindow)
     {
@@ -38,14 +47,22 @@ void Worker::Start()
         }
     }
     running = true;
+    paused = startPaused;
+    renderedFrames = 0;
+    presentingQueue = nullptr;
     workerThread = std::thread(&Worker::ThreadMain, this);
 }
 
 void Worker::Stop()
 {
-    running = false;
+    {
+        std::lock_guard<std::mutex> lock(pauseMutex);
+        running = false;
+    }
+    pauseCv.notify_all();
     if (workerThread.joinable())
         workerThread.join();
+    presentingQueue = nullptr;
 
     // 线程会自行清理资源，这里只需销毁窗口
     // 不要解绑主线程的上下文
@@ -54,58 +71,240 @@ void Worker::Stop()
         glfwDestroyWindow(workerWindow);
         workerWindow = nullptr;
     }
+}
+
+void Worker::Pause()
+{
+    if (paused.load())
+        return;
+    RequestSwitch(true);
+}
+
+void Worker::Resume()
+{
+    if (!paused.load())
+        return;
+    RequestSwitch(false);
+}
+
+void Worker::RequestSwitch(bool pause)
+{
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    switchRequestNs.store(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+    {
+        std::lock_guard<std::mutex> lock(pauseMutex);
+        paused = pause;
+    }
+    pauseCv.notify_all();
+}
+
+void Worker::WaitWhilePaused()
+{
+    if (!paused.load())
+        return;
 
-    // 清理遗留的栅欄对象
-    GLsync fence = latestFence.load();
-    if (fence)
+    auto ackLatency = [this]() {
+        auto now = std::chrono::steady_clock::now().time_since_epoch();
+        long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now).count() - switchRequestNs.load();
+        switchLatencyUs.store(ns / 1000.0);
+    };
+
+    // 挂起前确保已提交的命令送达 GPU
+    glFlush();
+    fps.store(0.0);
+    ackLatency();
+
+    std::unique_lock<std::mutex> lock(pauseMutex);
+    pauseCv.wait(lock, [this]() { return !paused.load() || !running.load(); });
+    lock.unlock();
+
+    if (running)
     {
-        glDeleteSync(fence);
-        latestFence.store(nullptr);
+        ackLatency();
+        // 丢弃暂停前残留的就绪帧，避免恢复后先呈现过期画面
+        if (FrameQueue *q = queue.load())
+            q->DiscardReady();
     }
 }
 
+void Worker::SetPresentMode(PresentMode mode)
+{
+    presentMode.store(mode);
+    if (FrameQueue *q = queue.load())
+        q->SetPresentMode(mode);
+}
+
+void Worker::SetPacing(PacingMode mode, double targetFps)
+{
+    governor.SetMode(mode);
+    governor.SetTargetFps(targetFps);
+}
+
+void Worker::SetFrameSequence(uint64_t first, uint64_t stride)
+{
+    sequenceFirst.store(first);
+    sequenceStride.store(stride > 0 ? stride : 1);
+    sequencePending.store(true);
+}
+
 unsigned int Worker::GetTextureID() const
 {
-    return frontTexture.load();
+    FrameQueue *q = presentingQueue;
+    if (!q || q->GetPresentSlot() < 0)
+        return 0;
+    return q->GetTextureID(q->GetPresentSlot());
 }
 
-unsigned int Worker::GetReadyTexture()
+const Framebuffer *Worker::GetPresentTarget() const
 {
-    // 等待并获取最新的纹理
-    GLsync fence = latestFence.exchange(nullptr);
-    if (fence)
-    {
-        GLenum waitRes = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
-        (void)waitRes;
-        glDeleteSync(fence);
-    }
-    return frontTexture.load();
+    FrameQueue *q = presentingQueue;
+    if (!q || q->GetPresentSlot() < 0)
+        return nullptr;
+    return q->GetFramebuffer(q->GetPresentSlot());
+}
+
+uint64_t Worker::GetSceneFrame() const
+{
+    FrameQueue *q = presentingQueue;
+    if (!q || q->GetPresentSlot() < 0)
+        return 0;
+    return q->GetSceneFrame(q->GetPresentSlot());
 }
 
 unsigned int Worker::TryGetReadyTexture()
 {
-    // 非阻塞检查：如果没有新栅欄，直接返回纹理（可能是旧的）
-    GLsync fence = latestFence.load();
-    if (!fence)
+    FrameQueue *q = queue.load();
+    if (!q)
+        return 0;
+
+    int slot = q->TryAcquirePresentSlot();
+    if (slot >= 0)
+        return PresentFrom(q, slot);
+
+    // 新尺寸的队列尚无就绪帧：继续消费旧队列中剩余的帧
+    FrameQueue *old = retiredQueue.load();
+    if (old && (slot = old->TryAcquirePresentSlot()) >= 0)
+        return PresentFrom(old, slot);
+    return 0;
+}
+
+unsigned int Worker::TryAcquireFrame(uint64_t frameIndex)
+{
+    FrameQueue *q = queue.load();
+    if (!q)
+        return 0;
+
+    int slot = q->TryAcquirePresentSlot(frameIndex);
+    if (slot >= 0)
+        return PresentFrom(q, slot);
+
+    // AFR 中该帧可能在重建队列前已提交到旧队列
+    FrameQueue *old = retiredQueue.load();
+    if (old && (slot = old->TryAcquirePresentSlot(frameIndex)) >= 0)
+        return PresentFrom(old, slot);
+    return 0;
+}
+
+unsigned int Worker::PresentFrom(FrameQueue *q, int slot)
+{
+    if (presentingQueue != q)
     {
-        return frontTexture.load();
+        // 呈现源换到另一个队列：归还旧队列中的帧
+        if (presentingQueue)
+            presentingQueue->ReleasePresentSlot();
+        presentingQueue = q;
     }
+    // 新队列已出帧，旧队列不再需要，交给渲染线程在其上下文中销毁。
+    // 先把它放进 releasedQueue 再清空 retiredQueue：两者之一始终非空，渲染线程在交接途中不会开始下一次重建；
+    // 渲染线程还没删掉上一个已放弃的队列时保持 retiredQueue 不变，下次呈现再试
+    if (q == queue.load())
+    {
+        FrameQueue *old = retiredQueue.load();
+        FrameQueue *none = nullptr;
+        if (old && releasedQueue.compare_exchange_strong(none, old))
+            retiredQueue.store(nullptr);
+    }
+    return q->GetTextureID(slot);
+}
+
+void Worker::ReleaseFrame()
+{
+    if (presentingQueue)
+        presentingQueue->ReleasePresentSlot();
+}
+
+bool Worker::SubmitCommands(const RenderCommand *cmds, size_t count)
+{
+    return commands.TryPush(cmds, count);
+}
 
-    // 检查 GPU 命令是否完成
-    GLenum waitRes = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
-    if (waitRes == GL_ALREADY_SIGNALED || waitRes == GL_CONDITION_SATISFIED)
+void Worker::ExecuteCommands()
+{
+    RenderCommand cmd;
+    while (commands.TryPop(cmd))
     {
-        // 尝试获取所有权并删除栅欄
-        GLsync expected = fence;
-        if (latestFence.compare_exchange_strong(expected, nullptr))
+        switch (cmd.type)
         {
-            glDeleteSync(fence);
+        case RenderCommandType::SetWorkload:
+            sceneWorkload = cmd.value;
+            scene->SetWorkload(sceneWorkload);
+            break;
+        case RenderCommandType::Resize:
+            // 只记录最新的尺寸，重建推迟到尺寸稳定之后
+            if (cmd.width > 0 && cmd.height > 0 && (cmd.width != pendingWidth || cmd.height != pendingHeight))
+            {
+                pendingWidth = cmd.width;
+                pendingHeight = cmd.height;
+                pendingSince = std::chrono::steady_clock::now();
+            }
+            break;
         }
-        return frontTexture.load();
     }
+}
 
-    // 未完成返回 0
-    return 0;
+void Worker::ApplyPendingResize()
+{
+    if (FrameQueue *released = releasedQueue.exchange(nullptr))
+        delete released;
+
+    bool resized = pendingWidth != width.load() || pendingHeight != height.load();
+    bool reformatted = !queue.load()->GetFramebuffer(0)->GetDesc().SameFormat(TargetDesc(width, height));
+    if (!resized && !reformatted)
+        return;
+    // 尺寸仍在变化，或上一次重建的旧队列还没被主线程放弃时暂不重建；只改格式时不必等尺寸稳定
+    if (resized && std::chrono::steady_clock::now() - pendingSince < ResizeSettleTime)
+        return;
+    if (retiredQueue.load() || releasedQueue.load())
+        return;
+
+    // 在本线程上下文中分配新队列；旧队列先登记为退役再切换，主线程看到新队列时必然也能看到旧队列
+    FrameQueue *fresh = new FrameQueue(queueDepth, TargetDesc(pendingWidth, pendingHeight), presentMode.load(), targets);
+    width = pendingWidth;
+    height = pendingHeight;
+    retiredQueue.store(queue.load());
+    queue.store(fresh);
+}
+
+FramebufferDesc Worker::TargetDesc(int width, int height) const
+{
+    FramebufferDesc desc;
+    desc.width = width;
+    desc.height = height;
+    desc.colors[0] = colorFormat.load();
+    desc.samples = samples.load();
+    return desc;
+}
+
+int Worker::GetQueueOccupancy() const
+{
+    FrameQueue *q = queue.load();
+    return q ? q->GetOccupancy() : 0;
+}
+
+unsigned long long Worker::GetDroppedFrames() const
+{
+    FrameQueue *q = queue.load();
+    return q ? q->GetDroppedFrames() : 0;
 }
 
 void Worker::ThreadMain()
@@ -119,15 +318,15 @@ void Worker::ThreadMain()
     // 设置当前线程上下文
     glfwMakeContextCurrent(workerWindow);
 
-    // 初始化双缓冲 FBO
-    fboA = new Framebuffer(width, height);
-    fboB = new Framebuffer(width, height);
-    frontFbo = fboA;
-    backFbo = fboB;
-    frontTexture.store(frontFbo->GetTextureID());
-    latestFence.store(nullptr);
+    // 初始化 N 深度渲染队列；槽位从本线程的渲染目标池取得，尺寸来回变化时复用旧队列归还的目标
+    targets = new RenderTargetPool();
+    queue.store(new FrameQueue(queueDepth, TargetDesc(width, height), presentMode.load(), targets));
 
-    scene = new Scene();
+    scene = new Scene(uploads);
+    scene->SetWorkload(sceneWorkload);
+    gpuTimer = new GpuTimer();
+    pendingWidth = width;
+    pendingHeight = height;
     Shader sceneShader("shaders/scene.vert", "shaders/scene.frag");
 
     // 渲染循环
@@ -137,36 +336,83 @@ void Worker::ThreadMain()
 
     while (running)
     {
-        // 更新负载
-        scene->SetWorkload(targetWorkload.load());
+        // 热待命：挂起直到恢复
+        if (paused.load())
+        {
+            WaitWhilePaused();
+            frames = 0;
+            lastReport = clock::now();
+            governor.Reset();
+            continue;
+        }
+
+        // 应用新的帧序号分配
+        if (sequencePending.exchange(false))
+            nextFrameIndex = sequenceFirst.load();
+
+        // 按调速模式等待下一帧的开始时刻
+        FrameQueue *q = queue.load();
+        governor.Pace(q, [this]() { return running.load() && !paused.load(); });
+        if (!running || paused)
+            continue;
+
+        // 执行主线程录制的命令，并切换到最新的场景快照；尚未收到任何快照时不渲染
+        ExecuteCommands();
+        ApplyPendingResize();
+        targets->Tick();
+        q = queue.load();
+        snapshots.Update();
+        const SceneState &state = snapshots.Front();
+        if (state.frame == 0)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+
+        // 获取可写槽位；FIFO 队列已满时等待消费者取帧
+        int slot = q->AcquireRenderSlot();
+        if (slot < 0)
+        {
+            q->WaitForConsumer(std::chrono::milliseconds(1));
+            continue;
+        }
 
-        // 渲染到后缓冲
-        backFbo->Bind();
+        // 渲染到槽位；动态分辨率只改变内容尺寸（左下角），渲染目标不重新分配，
+        // 内容尺寸随槽位一起交给主线程
+        Framebuffer *target = q->GetFramebuffer(slot);
+        int percent = resolution.GetPercent();
+        target->SetSize(DynamicResolution::Scale(target->GetAllocatedWidth(), percent),
+                        DynamicResolution::Scale(target->GetAllocatedHeight(), percent));
+        gpuTimer->Begin();
+        target->Bind();
         glEnable(GL_DEPTH_TEST);
-        glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+        glClearColor(state.clearColor.r, state.clearColor.g, state.clearColor.b, state.clearColor.a);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+        // 按快照中的相机与物体变换绘制
+        scene->SyncUploads();
         sceneShader.use();
-        glm::mat4 model = glm::mat4(1.0f);
-        glm::mat4 view = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -3.0f));
-        glm::mat4 projection = glm::perspective(glm::radians(45.0f), (float)width / (float)height, 0.1f, 100.0f);
-        float time = (float)glfwGetTime();
-        model = glm::rotate(model, time, glm::vec3(0.5f, 1.0f, 0.0f));
-        sceneShader.setMat4("view", view);
-        sceneShader.setMat4("projection", projection);
-        sceneShader.setMat4("model", model);
-
-        scene->Draw();
-        backFbo->Unbind();
-
-        // 提交命令并插入栅欄
-        glFlush();
-        GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
-        latestFence.store(fence);
+        sceneShader.setFloat("textureMix", scene->GetTexture() ? 1.0f : 0.0f);
+        sceneShader.setMat4("view", state.view);
+        sceneShader.setMat4("projection", state.projection);
+        for (int i = 0; i < state.objectCount; ++i)
+        {
+            sceneShader.setMat4("model", state.objects[i].model);
+            scene->Draw(state.objects[i].mesh);
+        }
+        // 多重采样时解析到主线程采样的纹理（每帧一次）
+        target->Resolve();
+        target->Unbind();
+        gpuTimer->End();
 
-        // 交换前后缓冲
-        std::swap(frontFbo, backFbo);
-        frontTexture.store(frontFbo->GetTextureID());
+        // 插入栅欄并提交命令，随后将槽位交给消费者
+        GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        glFlush();
+        // 渲染比例只改变 GPU 的填充量，控制器只看 GPU 计时（与单线程渲染器一致）
+        resolution.Update(gpuTimer->GetMs());
+        q->SubmitRenderSlot(slot, fence, nextFrameIndex, state.frame);
+        nextFrameIndex += sequenceStride.load();
+        renderedFrames++;
 
         // 计算渲染帧率
         frames++;
@@ -178,17 +424,18 @@ void Worker::ThreadMain()
             frames = 0;
             lastReport = now;
         }
-
-        // 无休眠全速运行
     }
 
     // 线程退出前资源清理
-    delete fboA; 
-    delete fboB; 
+    delete queue.exchange(nullptr);
+    delete retiredQueue.exchange(nullptr);
+    delete releasedQueue.exchange(nullptr);
+    delete targets;
+    targets = nullptr;
     delete scene;
-    fboA = nullptr;
-    fboB = nullptr;
     scene = nullptr;
+    delete gpuTimer;
+    gpuTimer = nullptr;
     
     // 解绑上下文
     glfwMakeContextCurrent(nullptr);
@@ -4,9 +4,20 @@
 #include <GLFW/glfw3.h>
 #include <thread>
 #include <atomic>
-#include "Framebuffer.h"
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include "FrameQueue.h"
+#include "FrameGovernor.h"
+#include "DynamicResolution.h"
+#include "GpuTimer.h"
+#include "RenderCommand.h"
 #include "Scene.h"
-#include <glad/glad.h>
+#include "SceneState.h"
+#include "SpscRing.h"
+#include "TripleBuffer.h"
+
+class UploadThread;
 
 class Worker
 {
@@ -14,40 +25,144 @@ public:
     Worker(GLFWwindow *shareWindow, int width, int height);
     ~Worker();
 
-    void Start();
+    // 启动渲染线程；startPaused 为 true 时线程完成资源初始化后立即进入待命
+    void Start(bool startPaused = false);
+    // 彻底停止线程并释放上下文与全部资源
     void Stop();
-    void SetSceneWorkload(int load) { targetWorkload.store(load); }
+    // 热待命：线程挂起在条件变量上，上下文、FBO、Scene、Shader 均保持驻留
+    void Pause();
+    void Resume();
+    bool IsRunning() const { return running.load(); }
+    bool IsPaused() const { return paused.load(); }
+    // 最近一次 Pause()/Resume() 请求到渲染线程响应的耗时（微秒）
+    double GetSwitchLatencyUs() const { return switchLatencyUs.load(); }
+    // 主线程提交命令（单生产者）；队列空间不足时整批拒绝并返回 false
+    bool SubmitCommands(const RenderCommand *commands, size_t count);
+    size_t GetCommandFreeSpace() const { return commands.FreeSpace(); }
+    // 尚未被渲染线程执行的命令数
+    size_t GetPendingCommands() const { return commands.Size(); }
+    // 主线程发布最新的场景快照（单写者，无锁）；渲染线程每帧开始时取最新一份
+    void PublishScene(const SceneState &state) { snapshots.Publish(state); }
+    // 异步上传的资源来源，在下次 Start() 创建场景时生效
+    void SetUploadThread(const UploadThread *uploads) { this->uploads = uploads; }
+
+    // 渲染目标尺寸：线程运行时以 Resize 命令提交，由渲染线程在尺寸稳定后重建队列
+    int GetRenderWidth() const { return width.load(); }
+    int GetRenderHeight() const { return height.load(); }
+
+    // 队列深度在下次 Start() 重建线程或重建队列时生效，呈现模式立即生效
+    void SetQueueDepth(int depth) { queueDepth = depth; }
+    int GetQueueDepth() const { return queueDepth; }
+    void SetPresentMode(PresentMode mode);
+    PresentMode GetPresentMode() const { return presentMode.load(); }
+    // 渲染目标的颜色格式与多重采样数：渲染线程在下一帧开始前按新格式重建队列
+    void SetColorFormat(ColorFormat format) { colorFormat.store(format); }
+    void SetSamples(int samples) { this->samples.store(samples); }
+
+    // 动态分辨率的帧耗时预算（毫秒，0 表示固定 100%），立即生效
+    void SetResolutionBudget(double ms) { resolution.SetBudget(ms); }
+    const DynamicResolution &GetResolution() const { return resolution; }
+
+    // 渲染节奏控制（立即生效）
+    void SetPacing(PacingMode mode, double targetFps);
+    PacingMode GetPacingMode() const { return governor.GetMode(); }
+    // 渲染线程等待时间占比（0~1）
+    double GetIdleRatio() const { return governor.GetIdleRatio(); }
 
+    // 帧序号分配：本 Worker 渲染 first, first+stride, first+2*stride... 帧（AFR 使用）
+    // 在线程启动或从暂停恢复时生效
+    void SetFrameSequence(uint64_t first, uint64_t stride);
+
+    // 当前正在呈现的纹理 ID
     unsigned int GetTextureID() const;
-    // 等待 GPU 完成工作并返回最新的纹理 ID
-    unsigned int GetReadyTexture();
-    // 非阻塞获取就绪纹理；若未就绪返回 0
+    // 当前呈现的帧所在的渲染目标（内容尺寸即该帧的渲染分辨率），没有时为 nullptr
+    const Framebuffer *GetPresentTarget() const;
+    // 当前呈现的帧所使用的场景快照帧号（0 表示没有）
+    uint64_t GetSceneFrame() const;
+    // 非阻塞获取新的就绪纹理；若没有新帧返回 0
     unsigned int TryGetReadyTexture();
+    // 非阻塞获取指定帧序号的纹理；该帧未就绪时返回 0
+    unsigned int TryAcquireFrame(uint64_t frameIndex);
+    // 归还当前呈现的帧（呈现源切换到其他 Worker 时调用）
+    void ReleaseFrame();
     
     // 获取渲染线程的实时 FPS
     double GetFPS() const { return fps.load(); }
+    // 队列中等待呈现的帧数
+    int GetQueueOccupancy() const;
+    // 渲染完成但从未被呈现的帧数
+    unsigned long long GetDroppedFrames() const;
+    // 自 Start() 以来渲染的总帧数
+    unsigned long long GetRenderedFrames() const { return renderedFrames.load(); }
 
 private:
     void ThreadMain();
+    // 在渲染线程中检查暂停请求，必要时挂起直到恢复或停止
+    void WaitWhilePaused();
+    void RequestSwitch(bool pause);
+    // 在渲染线程中执行所有已提交的命令
+    void ExecuteCommands();
+    // 在渲染线程中回收旧队列，并在尺寸稳定后（或格式变化时立即）重建队列
+    void ApplyPendingResize();
+    // 主线程：从 q 的 slot 呈现，必要时把旧尺寸的队列交还渲染线程销毁
+    unsigned int PresentFrom(FrameQueue *q, int slot);
+    FramebufferDesc TargetDesc(int width, int height) const;
 
     GLFWwindow *shareWindow;
     GLFWwindow *workerWindow;
-    int width, height;
+    std::atomic<int> width, height;
 
-    // 双缓冲 FBO
-    Framebuffer *fboA;
-    Framebuffer *fboB;
-    Framebuffer *frontFbo;
-    Framebuffer *backFbo;
+    // N 深度渲染队列（由 Worker 线程创建与销毁）
+    std::atomic<FrameQueue *> queue;
+    // 尺寸变化时的旧队列：主线程继续消费其中剩余的帧，直到新队列产出第一帧
+    std::atomic<FrameQueue *> retiredQueue{nullptr};
+    // 主线程已不再使用、等待渲染线程在自己的上下文中销毁的队列
+    std::atomic<FrameQueue *> releasedQueue{nullptr};
+    // 主线程当前呈现的帧所在的队列（仅主线程访问）
+    FrameQueue *presentingQueue = nullptr;
+    int queueDepth = 3;
+    std::atomic<PresentMode> presentMode{PresentMode::Mailbox};
+    std::atomic<ColorFormat> colorFormat{ColorFormat::Rgba8};
+    std::atomic<int> samples{0};
+    // 队列槽位的渲染目标池（仅渲染线程访问）
+    RenderTargetPool *targets = nullptr;
     Scene *scene;
+    const UploadThread *uploads = nullptr;
+    FrameGovernor governor;
+    DynamicResolution resolution;
+    // 渲染线程的 GPU 计时（仅渲染线程访问）
+    GpuTimer *gpuTimer = nullptr;
 
     std::thread workerThread;
     std::atomic<bool> running;
-    // 向主线程暴露的同步原语
-    std::atomic<unsigned int> frontTexture;
-    std::atomic<GLsync> latestFence;
-    std::atomic<int> targetWorkload{0};
+
+    // 主线程 -> 渲染线程的命令流
+    static const size_t CommandCapacity = 256;
+    SpscRing<RenderCommand, CommandCapacity> commands;
+
+    // 主线程 -> 渲染线程的场景快照，渲染线程只读
+    TripleBuffer<SceneState> snapshots;
+    int sceneWorkload = 0;
+
+    // 尺寸变化合并：拖动窗口产生的连续 Resize 只保留最后一个，尺寸稳定一段时间后才重建
+    static constexpr std::chrono::milliseconds ResizeSettleTime{50};
+    int pendingWidth = 0, pendingHeight = 0; // 仅渲染线程访问
+    std::chrono::steady_clock::time_point pendingSince;
+
+    // 暂停/恢复
+    std::atomic<bool> paused{false};
+    std::mutex pauseMutex;
+    std::condition_variable pauseCv;
+    std::atomic<long long> switchRequestNs{0};
+    std::atomic<double> switchLatencyUs{0.0};
     
     // FPS 计算
     std::atomic<double> fps{0.0};
+    std::atomic<unsigned long long> renderedFrames{0};
+
+    // 帧序号分配
+    std::atomic<uint64_t> sequenceFirst{1};
+    std::atomic<uint64_t> sequenceStride{1};
+    std::atomic<bool> sequencePending{true};
+    uint64_t nextFrameIndex = 1; // 仅渲染线程访问
 };
@@ -0,0 +1,274 @@
+#include "WorkerPool.h"
+#include <algorithm>
+
+WorkerPool::WorkerPool(GLFWwindow *shareWindow, int width, int height, int workerCount)
+    : shareWindow(shareWindow), width(width), height(height), pendingCount(std::clamp(workerCount, 1, MaxWorkers))
+{
+    ResizeWorkers(pendingCount);
+}
+
+WorkerPool::~WorkerPool()
+{
+    Stop();
+    for (Worker *worker : workers)
+        delete worker;
+}
+
+void WorkerPool::SetWorkerCount(int count)
+{
+    pendingCount = std::clamp(count, 1, MaxWorkers);
+}
+
+void WorkerPool::ResizeWorkers(int count)
+{
+    // 必须在主线程中调用：Worker 构造时创建共享上下文窗口
+    while ((int)workers.size() > count)
+    {
+        delete workers.back();
+        workers.pop_back();
+    }
+    while ((int)workers.size() < count)
+    {
+        workers.push_back(new Worker(shareWindow, width, height));
+        workers.back()->SetUploadThread(uploads);
+        workers.back()->SetQueueDepth(queueDepth);
+        workers.back()->SetColorFormat(colorFormat);
+        workers.back()->SetSamples(samples);
+    }
+
+    // AFR 需要按帧序号严格呈现，不能丢帧
+    for (Worker *worker : workers)
+    {
+        worker->SetPresentMode(count > 1 ? PresentMode::Fifo : presentMode);
+        worker->SetPacing(pacingMode, targetFps / count);
+        worker->SetResolutionBudget(resolutionBudget * count);
+    }
+}
+
+void WorkerPool::AssignSequences()
+{
+    // 每次分配使用新的帧序号纪元，暂停前残留的旧帧不会被误认为新帧
+    uint64_t base = ((nextFrame >> 32) + 1) << 32;
+    int count = (int)workers.size();
+    for (int i = 0; i < count; ++i)
+        workers[i]->SetFrameSequence(base + i, count);
+    nextFrame = base;
+}
+
+void WorkerPool::Start(bool startPaused)
+{
+    bool running = !workers.empty() && workers[0]->IsRunning();
+    if (!running && pendingCount != (int)workers.size())
+        ResizeWorkers(pendingCount);
+    if (!running)
+    {
+        AssignSequences();
+        presentingWorker = -1;
+        presentingTexture = 0;
+    }
+
+    for (Worker *worker : workers)
+        worker->Start(startPaused);
+}
+
+void WorkerPool::Stop()
+{
+    for (Worker *worker : workers)
+        worker->Stop();
+    presentingWorker = -1;
+    presentingTexture = 0;
+}
+
+void WorkerPool::Pause()
+{
+    for (Worker *worker : workers)
+        worker->Pause();
+}
+
+void WorkerPool::Resume()
+{
+    if (workers.size() > 1)
+        AssignSequences();
+    for (Worker *worker : workers)
+        worker->Resume();
+}
+
+bool WorkerPool::SubmitCommands(const CommandList &commands)
+{
+    // 主线程是唯一生产者，检查后的可用空间只会变大
+    for (Worker *worker : workers)
+    {
+        if (worker->GetCommandFreeSpace() < commands.Size())
+        {
+            rejectedSubmits++;
+            return false;
+        }
+    }
+    for (Worker *worker : workers)
+        worker->SubmitCommands(commands.Data(), commands.Size());
+    return true;
+}
+
+bool WorkerPool::Resize(int width, int height)
+{
+    // 之后新建的 Worker 直接使用新尺寸
+    this->width = width;
+    this->height = height;
+    CommandList commands;
+    commands.Resize(width, height);
+    return SubmitCommands(commands);
+}
+
+void WorkerPool::SetUploadThread(const UploadThread *uploads)
+{
+    this->uploads = uploads;
+    for (Worker *worker : workers)
+        worker->SetUploadThread(uploads);
+}
+
+void WorkerPool::PublishScene(const SceneState &state)
+{
+    for (Worker *worker : workers)
+        worker->PublishScene(state);
+}
+
+size_t WorkerPool::GetPendingCommands() const
+{
+    size_t pending = 0;
+    for (Worker *worker : workers)
+        pending = std::max(pending, worker->GetPendingCommands());
+    return pending;
+}
+
+void WorkerPool::SetQueueDepth(int depth)
+{
+    queueDepth = depth;
+    for (Worker *worker : workers)
+        worker->SetQueueDepth(depth);
+}
+
+void WorkerPool::SetColorFormat(ColorFormat format)
+{
+    colorFormat = format;
+    for (Worker *worker : workers)
+        worker->SetColorFormat(format);
+}
+
+void WorkerPool::SetSamples(int samples)
+{
+    this->samples = samples;
+    for (Worker *worker : workers)
+        worker->SetSamples(samples);
+}
+
+void WorkerPool::SetResolutionBudget(double ms)
+{
+    resolutionBudget = ms;
+    for (Worker *worker : workers)
+        worker->SetResolutionBudget(ms * workers.size());
+}
+
+void WorkerPool::SetPresentMode(PresentMode mode)
+{
+    presentMode = mode;
+    if (workers.size() == 1)
+        workers[0]->SetPresentMode(mode);
+}
+
+void WorkerPool::SetPacing(PacingMode mode, double fps)
+{
+    pacingMode = mode;
+    targetFps = fps;
+    for (Worker *worker : workers)
+        worker->SetPacing(mode, fps / workers.size());
+}
+
+unsigned int WorkerPool::GetTextureID() const
+{
+    if (workers.size() == 1)
+        return workers[0]->GetTextureID();
+    return presentingTexture;
+}
+
+const Framebuffer *WorkerPool::GetPresentTarget() const
+{
+    if (workers.size() == 1)
+        return workers[0]->GetPresentTarget();
+    return presentingWorker >= 0 ? workers[presentingWorker]->GetPresentTarget() : nullptr;
+}
+
+uint64_t WorkerPool::GetSceneFrame() const
+{
+    if (workers.size() == 1)
+        return workers[0]->GetSceneFrame();
+    return presentingWorker >= 0 ? workers[presentingWorker]->GetSceneFrame() : 0;
+}
+
+unsigned int WorkerPool::TryGetReadyTexture()
+{
+    if (workers.size() == 1)
+        return workers[0]->TryGetReadyTexture();
+
+    // 下一帧由哪个 Worker 负责由帧序号决定
+    int count = (int)workers.size();
+    int owner = (int)((nextFrame & 0xffffffffull) % count);
+    unsigned int tex = workers[owner]->TryAcquireFrame(nextFrame);
+    if (!tex)
+        return 0;
+
+    // 呈现源切换到另一个 Worker：归还上一帧，让其尽快复用该槽位
+    if (presentingWorker >= 0 && presentingWorker != owner)
+        workers[presentingWorker]->ReleaseFrame();
+    presentingWorker = owner;
+    presentingTexture = tex;
+    nextFrame++;
+    return tex;
+}
+
+double WorkerPool::GetFPS() const
+{
+    double total = 0.0;
+    for (Worker *worker : workers)
+        total += worker->GetFPS();
+    return total;
+}
+
+int WorkerPool::GetQueueOccupancy() const
+{
+    int total = 0;
+    for (Worker *worker : workers)
+        total += worker->GetQueueOccupancy();
+    return total;
+}
+
+unsigned long long WorkerPool::GetDroppedFrames() const
+{
+    unsigned long long total = 0;
+    for (Worker *worker : workers)
+        total += worker->GetDroppedFrames();
+    return total;
+}
+
+unsigned long long WorkerPool::GetRenderedFrames() const
+{
+    unsigned long long total = 0;
+    for (Worker *worker : workers)
+        total += worker->GetRenderedFrames();
+    return total;
+}
+
+double WorkerPool::GetIdleRatio() const
+{
+    double total = 0.0;
+    for (Worker *worker : workers)
+        total += worker->GetIdleRatio();
+    return workers.empty() ? 0.0 : total / workers.size();
+}
+
+double WorkerPool::GetSwitchLatencyUs() const
+{
+    double latency = 0.0;
+    for (Worker *worker : workers)
+        latency = std::max(latency, worker->GetSwitchLatencyUs());
+    return latency;
+}
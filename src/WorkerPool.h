@@ -0,0 +1,92 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <cstdint>
+#include <vector>
+#include "Worker.h"
+
+// 交替帧渲染（AFR）：K 个共享上下文的 Worker，第 i 个 Worker 渲染第 i, i+K, i+2K... 帧
+// 主线程严格按帧序号呈现。K = 1 时退化为单个 Worker，沿用其呈现模式。
+class WorkerPool
+{
+public:
+    static const int MaxWorkers = 8;
+
+    WorkerPool(GLFWwindow *shareWindow, int width, int height, int workerCount = 1);
+    ~WorkerPool();
+
+    // Worker 数量变化需要重建上下文，在下次 Start() 重建线程时生效
+    void SetWorkerCount(int count);
+    int GetWorkerCount() const { return (int)workers.size(); }
+
+    void Start(bool startPaused = false);
+    void Stop();
+    void Pause();
+    void Resume();
+
+    // 向所有 Worker 提交同一批命令；任一 Worker 的命令队列空间不足时整批放弃
+    bool SubmitCommands(const CommandList &commands);
+    size_t GetPendingCommands() const;
+    unsigned long long GetRejectedSubmits() const { return rejectedSubmits; }
+    // 通知所有 Worker 改变渲染尺寸；命令队列满时返回 false，由调用方下一帧重试
+    bool Resize(int width, int height);
+    int GetRenderWidth() const { return workers.empty() ? width : workers[0]->GetRenderWidth(); }
+    int GetRenderHeight() const { return workers.empty() ? height : workers[0]->GetRenderHeight(); }
+    // 向所有 Worker 发布同一份场景快照，不会阻塞也不会被拒绝
+    void PublishScene(const SceneState &state);
+    // 异步上传的资源来源，对之后启动的 Worker 生效
+    void SetUploadThread(const UploadThread *uploads);
+    void SetQueueDepth(int depth);
+    // 渲染目标的颜色格式与多重采样数，各 Worker 在下一帧开始前重建队列
+    void SetColorFormat(ColorFormat format);
+    void SetSamples(int samples);
+    // AFR（K > 1）时各 Worker 固定使用 FIFO，丢帧会破坏帧序
+    void SetPresentMode(PresentMode mode);
+    // 动态分辨率的帧耗时预算（毫秒，0 表示关闭）：AFR 时每个 Worker 有 K 个呈现间隔完成一帧，预算乘以 K
+    void SetResolutionBudget(double ms);
+    // 第一个 Worker 的动态分辨率状态（AFR 时各 Worker 独立调整，负载相同时基本一致）
+    const DynamicResolution &GetResolution() const { return workers[0]->GetResolution(); }
+    // 帧率上限按 Worker 数量均分
+    void SetPacing(PacingMode mode, double targetFps);
+
+    unsigned int GetTextureID() const;
+    // 当前呈现的帧所在的渲染目标
+    const Framebuffer *GetPresentTarget() const;
+    // 当前呈现的帧所使用的场景快照帧号
+    uint64_t GetSceneFrame() const;
+    // 非阻塞获取下一帧（按帧序号）；若没有新帧返回 0
+    unsigned int TryGetReadyTexture();
+
+    double GetFPS() const;
+    int GetQueueOccupancy() const;
+    unsigned long long GetDroppedFrames() const;
+    unsigned long long GetRenderedFrames() const;
+    double GetIdleRatio() const;
+    double GetSwitchLatencyUs() const;
+
+private:
+    void ResizeWorkers(int count);
+    // 为所有 Worker 分配对齐的帧序号，并重置呈现进度
+    void AssignSequences();
+
+    GLFWwindow *shareWindow;
+    int width, height;
+    std::vector<Worker *> workers;
+    int pendingCount;
+    const UploadThread *uploads = nullptr;
+    int queueDepth = 3;
+    ColorFormat colorFormat = ColorFormat::Rgba8;
+    int samples = 0;
+    double resolutionBudget = 0.0;
+
+    PresentMode presentMode = PresentMode::Mailbox;
+    PacingMode pacingMode = PacingMode::Unlimited;
+    double targetFps = 60.0;
+
+    // 呈现进度（仅主线程访问）
+    uint64_t nextFrame = 1;
+    int presentingWorker = -1;
+    unsigned int presentingTexture = 0;
+    unsigned long long rejectedSubmits = 0;
+};
@@ -0,0 +1,234 @@
+#include "YuvConverter.h"
+#include <cstring>
+#include <iostream>
+
+const char *YuvMatrixName(YuvMatrix matrix)
+{
+    switch (matrix)
+    {
+    case YuvMatrix::None:
+        return "none";
+    case YuvMatrix::Bt601:
+        return "bt601";
+    case YuvMatrix::Bt709:
+        return "bt709";
+    }
+    return "unknown";
+}
+
+bool ParseYuvMatrix(const char *name, YuvMatrix &matrix)
+{
+    for (YuvMatrix m : {YuvMatrix::None, YuvMatrix::Bt601, YuvMatrix::Bt709})
+    {
+        if (std::strcmp(name, YuvMatrixName(m)) == 0)
+        {
+            matrix = m;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char *YuvRangeName(YuvRange range)
+{
+    return range == YuvRange::Full ? "full" : "limited";
+}
+
+bool ParseYuvRange(const char *name, YuvRange &range)
+{
+    for (YuvRange r : {YuvRange::Full, YuvRange::Limited})
+    {
+        if (std::strcmp(name, YuvRangeName(r)) == 0)
+        {
+            range = r;
+            return true;
+        }
+    }
+    return false;
+}
+
+YuvConverter::YuvConverter(YuvMatrix matrix, YuvRange range) : matrix(matrix), range(range)
+{
+    // 亮度系数 Kr/Kb，色度行由 (B - Y) / (2(1 - Kb)) 与 (R - Y) / (2(1 - Kr)) 展开
+    float kr = matrix == YuvMatrix::Bt709 ? 0.2126f : 0.299f;
+    float kb = matrix == YuvMatrix::Bt709 ? 0.0722f : 0.114f;
+    float kg = 1.0f - kr - kb;
+    float su = 0.5f / (1.0f - kb), sv = 0.5f / (1.0f - kr);
+
+    shader = new Shader("shaders/screen.vert", "shaders/yuv.frag");
+    shader->use();
+    shader->setInt("sourceTexture", 0);
+    shader->setVec4("region", 0.0f, 0.0f, 1.0f, 1.0f);
+    shader->setVec3("yCoeffs", kr, kg, kb);
+    shader->setVec3("uCoeffs", -kr * su, -kg * su, (1.0f - kb) * su);
+    shader->setVec3("vCoeffs", (1.0f - kr) * sv, -kg * sv, -kb * sv);
+    if (range == YuvRange::Full)
+    {
+        shader->setVec2("yRange", 1.0f, 0.0f);
+        shader->setVec2("cRange", 1.0f, 128.0f / 255.0f);
+    }
+    else
+    {
+        shader->setVec2("yRange", 219.0f / 255.0f, 16.0f / 255.0f);
+        shader->setVec2("cRange", 224.0f / 255.0f, 128.0f / 255.0f);
+    }
+
+    float quadVertices[] = {
+        // 位置        // 纹理坐标
+        -1.0f, 1.0f, 0.0f, 1.0f,
+        -1.0f, -1.0f, 0.0f, 0.0f,
+        1.0f, -1.0f, 1.0f, 0.0f,
+
+        -1.0f, 1.0f, 0.0f, 1.0f,
+        1.0f, -1.0f, 1.0f, 0.0f,
+        1.0f, 1.0f, 1.0f, 1.0f};
+    glGenVertexArrays(1, &quadVAO);
+    glGenBuffers(1, &quadVBO);
+    glBindVertexArray(quadVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), &quadVertices, GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void *)0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void *)(2 * sizeof(float)));
+    glBindVertexArray(0);
+
+    glGenFramebuffers(1, &copyFbo);
+    std::cout << "GPU YUV 转换: " << YuvMatrixName(matrix) << " " << YuvRangeName(range) << std::endl;
+}
+
+YuvConverter::~YuvConverter()
+{
+    ReleaseTargets();
+    glDeleteFramebuffers(1, &copyFbo);
+    glDeleteVertexArrays(1, &quadVAO);
+    glDeleteBuffers(1, &quadVBO);
+    delete shader;
+}
+
+size_t YuvConverter::FrameBytes(int width, int height)
+{
+    size_t chromaW = (width + 1) / 2, chromaH = (height + 1) / 2;
+    return (size_t)width * height + 2 * chromaW * chromaH;
+}
+
+void YuvConverter::ReleaseTargets()
+{
+    for (Framebuffer *target : {luma, chroma, assembly})
+    {
+        if (target)
+            targets.Release(target);
+    }
+    luma = chroma = assembly = nullptr;
+    width = height = 0;
+}
+
+void YuvConverter::Prepare(int width, int height)
+{
+    targets.Tick();
+    if (width == this->width && height == this->height)
+        return;
+    ReleaseTargets();
+    this->width = width;
+    this->height = height;
+
+    // Framebuffer 创建时会改变 GL_FRAMEBUFFER 绑定
+    GLint previousDraw = 0, previousRead = 0;
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previousDraw);
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previousRead);
+
+    FramebufferDesc desc;
+    desc.width = width;
+    desc.height = height;
+    desc.colors[0] = ColorFormat::R8;
+    desc.depth = DepthAttachment::None;
+    luma = targets.Acquire(desc, true);
+
+    // 色度 pass 一次写两个平面
+    desc.width = (width + 1) / 2;
+    desc.height = (height + 1) / 2;
+    desc.colorCount = 2;
+    desc.colors[1] = ColorFormat::R8;
+    chroma = targets.Acquire(desc, true);
+
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, previousDraw);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, previousRead);
+}
+
+void YuvConverter::CopyRegion(unsigned int texture, int x, int y, int w, int h)
+{
+    GLint previous = 0, previousRead = 0;
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previous);
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previousRead);
+    if (!assembly)
+    {
+        FramebufferDesc desc;
+        desc.width = width;
+        desc.height = height;
+        desc.depth = DepthAttachment::None;
+        assembly = targets.Acquire(desc);
+    }
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, copyFbo);
+    glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, assembly->GetId());
+    glBlitFramebuffer(x, y, x + w, y + h, x, y, x + w, y + h, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, 0, 0);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, previousRead);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, previous);
+}
+
+void YuvConverter::Convert(unsigned int texture)
+{
+    // 转换插在主线程的上屏与 UI 之间：保存并恢复调用方的帧缓冲、视口与深度测试
+    GLint previous = 0, viewport[4];
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previous);
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    GLboolean depthTest = glIsEnabled(GL_DEPTH_TEST);
+    glDisable(GL_DEPTH_TEST);
+
+    shader->use();
+    glBindVertexArray(quadVAO);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, texture);
+
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, luma->GetId());
+    glViewport(0, 0, width, height);
+    shader->setInt("chroma", 0);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, chroma->GetId());
+    glViewport(0, 0, (width + 1) / 2, (height + 1) / 2);
+    shader->setInt("chroma", 1);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, previous);
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+    if (depthTest)
+        glEnable(GL_DEPTH_TEST);
+}
+
+void YuvConverter::ReadPlanes(size_t offset)
+{
+    int chromaW = (width + 1) / 2, chromaH = (height + 1) / 2;
+    // R8 行宽可能为奇数，按 1 字节对齐紧密排列
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glPixelStorei(GL_PACK_ROW_LENGTH, 0);
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, luma->GetId());
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    glReadPixels(0, 0, width, height, GL_RED, GL_UNSIGNED_BYTE, (void *)offset);
+    offset += (size_t)width * height;
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, chroma->GetId());
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    glReadPixels(0, 0, chromaW, chromaH, GL_RED, GL_UNSIGNED_BYTE, (void *)offset);
+    offset += (size_t)chromaW * chromaH;
+    glReadBuffer(GL_COLOR_ATTACHMENT1);
+    glReadPixels(0, 0, chromaW, chromaH, GL_RED, GL_UNSIGNED_BYTE, (void *)offset);
+
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+}
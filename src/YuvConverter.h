@@ -0,0 +1,72 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <cstddef>
+#include "Framebuffer.h"
+#include "RenderTargetPool.h"
+#include "Shader.h"
+
+// GPU 端 YUV 转换使用的矩阵，None 表示不转换（回读 RGBA）
+enum class YuvMatrix
+{
+    None,
+    Bt601,
+    Bt709
+};
+
+// 量化范围
+enum class YuvRange
+{
+    Full,   // 0–255
+    Limited // Y 16–235，UV 16–240（视频编码器的常用默认值）
+};
+
+const char *YuvMatrixName(YuvMatrix matrix);
+bool ParseYuvMatrix(const char *name, YuvMatrix &matrix);
+const char *YuvRangeName(YuvRange range);
+bool ParseYuvRange(const char *name, YuvRange &range);
+
+// 回读前的 RGB -> I420 转换：亮度 pass 写全分辨率 R8 目标，色度 pass 用两个颜色附件同时写半分辨率的 U/V。
+// 三个平面按 Y、U、V 顺序紧密读进同一个 PBO，得到行序自顶向下的 I420，字节数约为 RGBA 的 37.5%。
+// 分块渲染的帧先用 glBlitFramebuffer 拼进一张整帧纹理再转换。
+// 三个目标从转换器自己的渲染目标池取得（回读所在上下文的池），尺寸来回变化时复用归还的目标。
+// FBO 不在上下文间共享：必须在回读所在的上下文线程中构造、使用与销毁。
+class YuvConverter
+{
+public:
+    YuvConverter(YuvMatrix matrix, YuvRange range);
+    ~YuvConverter();
+
+    // 一帧 I420 的字节数（奇数尺寸的色度平面向上取整）
+    static size_t FrameBytes(int width, int height);
+
+    // 按帧尺寸准备渲染目标（每帧调用），尺寸变化时换用池中对应尺寸的目标
+    void Prepare(int width, int height);
+    // 分块帧：把 texture 中 (x, y, w, h) 区域拷贝到拼装纹理的相同位置
+    void CopyRegion(unsigned int texture, int x, int y, int w, int h);
+    // 转换一张整帧纹理 / 转换拼装好的帧
+    void Convert(unsigned int texture);
+    void ConvertAssembled() { Convert(assembly->GetTextureID()); }
+    // 把三个平面读到当前绑定的 GL_PIXEL_PACK_BUFFER 的 offset 处
+    void ReadPlanes(size_t offset);
+
+    YuvMatrix GetMatrix() const { return matrix; }
+    YuvRange GetRange() const { return range; }
+
+private:
+    void ReleaseTargets();
+
+    YuvMatrix matrix;
+    YuvRange range;
+    Shader *shader = nullptr;
+    unsigned int quadVAO = 0, quadVBO = 0;
+    int width = 0, height = 0;
+
+    // 先于全部目标构造、后于全部目标析构
+    RenderTargetPool targets;
+    // 无深度的 R8 目标：亮度一个附件，色度两个附件（U、V）；只写、读内容区域，按尺寸分档
+    Framebuffer *luma = nullptr, *chroma = nullptr;
+    // 分块帧的拼装目标（首次使用时取得）：转换时采样整张纹理，尺寸与帧一致
+    Framebuffer *assembly = nullptr;
+    unsigned int copyFbo = 0;
+};
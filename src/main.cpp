@@ -2,14 +2,32 @@
 #include <GLFW/glfw3.h>
 #include <iostream>
 #include <chrono>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
 
 #include "imgui.h"
 #include "imgui_impl_glfw.h"
 #include "imgui_impl_opengl3.h"
 
 #include "Renderer.h"
-#include "Worker.h"
+#include "WorkerPool.h"
+#include "SplitFrameRenderer.h"
+#include "Benchmark.h"
 #include "ScreenRenderer.h"
+#include "SceneState.h"
+#include "UploadThread.h"
+#include "RenderSettings.h"
+#include "Headless.h"
+#include "BatchJob.h"
+#include "FrameReadback.h"
+#include "DamageTracker.h"
+#include "StreamSink.h"
+#include "ImageExporter.h"
+#include "FrameServer.h"
+#include "FrameContainer.h"
+#include "RenderFarm.h"
 
 void framebuffer_size_callback(GLFWwindow *window, int width, int height);
 
@@ -17,26 +35,53 @@ const unsigned int SCR_WIDTH = 1920;
 const unsigned int SCR_HEIGHT = 1080;
 
 Renderer *globalSingleRenderer = nullptr;
+// 最近一次窗口尺寸变化，由主循环转发给 Worker（拖动窗口时每帧最多转发一次）
+int pendingResizeWidth = 0, pendingResizeHeight = 0;
+bool resizePending = false;
 
 int main(int argc, char** argv)
 {
-    // 默认设置
-    bool useMultiThread = false;
-    int cpuLoad = 0;
-    int renderLoad = 0;
-
-    // 解析命令行参数
-    for (int i = 1; i < argc; ++i) if (std::string(argv[i]) == "--single") useMultiThread = false;
-    for (int i = 1; i < argc; ++i) if (std::string(argv[i]) == "--multi") useMultiThread = true;
-
-    // 1. 初始化 GLFW
-    glfwInit();
+    // 解析命令行参数，交互模式下的可调参数从这里取初值
+    RenderSettings settings;
+    ParseRenderArgs(argc, argv, settings);
+    // 帧流写到 stdout 时，之后的日志全部改写到 stderr
+    if (settings.sinkPath == "-")
+        StreamSink::ReserveStdout();
+    // 渲染农场的协调进程不需要 GL 上下文，只负责启动渲染进程并分发帧区间
+    if (settings.farmProcesses > 0 || (!settings.farmListen.empty() && settings.farmWorker.empty()))
+        return Farm::RunCoordinator(settings, argc, argv);
+    RenderMode renderMode = settings.renderMode;
+    int cpuLoad = settings.cpuLoad;
+    int renderLoad = settings.renderLoad;
+    int queueDepth = settings.queueDepth;
+    PresentMode presentMode = settings.presentMode;
+    PacingMode pacingMode = settings.pacingMode;
+    int targetFps = settings.targetFps;
+    int workerCount = settings.workerCount;
+    int sfrThreads = settings.sfrThreads;
+    int sfrTiles = settings.sfrTiles;
+    TileBalance tileBalance = settings.tileBalance;
+    int msaaSamples = settings.msaaSamples;
+    bool dynamicResolution = settings.resolutionBudgetMs > 0.0;
+    float resolutionBudget = dynamicResolution ? (float)settings.resolutionBudgetMs : 1000.0f / 60.0f;
+    int upscaleIndex = (int)settings.upscaleFilter;
+
+    // 1. 初始化 GLFW（无头模式使用不连接显示服务器的 null 平台）
+    if (settings.headless)
+        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+    if (!glfwInit())
+    {
+        std::cout << "初始化 GLFW 失败" << std::endl;
+        return -1;
+    }
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 
-    // 2. 创建窗口对象
-    GLFWwindow *window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "OffScreenRendering Demo", NULL, NULL);
+    // 2. 创建窗口对象（无头模式下只是一个没有窗口的上下文）
+    GLFWwindow *window = settings.headless
+        ? Headless::CreateContext(SCR_WIDTH, SCR_HEIGHT, settings.contextApi)
+        : glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "OffScreenRendering Demo", NULL, NULL);
     if (window == NULL)
     {
         std::cout << "创建 GLFW 窗口失败" << std::endl;
@@ -45,9 +90,12 @@ int main(int argc, char** argv)
     }
     // 3. 将窗口的上下文设置为当前线程的主上下文
     glfwMakeContextCurrent(window);
-    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
-    // 禁用垂直同步以获得更高帧率
-    glfwSwapInterval(0);
+    if (!settings.headless)
+    {
+        glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+        // 禁用垂直同步以获得更高帧率
+        glfwSwapInterval(0);
+    }
 
     // 4. 初始化 GLAD (加载OpenGL函数指针)
     if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
@@ -56,6 +104,45 @@ int main(int argc, char** argv)
         return -1;
     }
 
+    // 非交互式 AFR 扩展性测试：输出报告后直接退出
+    if (settings.afrScalingSeconds > 0.0)
+    {
+        Benchmark::RunAfrScaling(window, SCR_WIDTH, SCR_HEIGHT, WorkerPool::MaxWorkers, settings.afrScalingSeconds, renderLoad);
+        glfwTerminate();
+        return 0;
+    }
+    // 非交互式抗锯齿开销测试：MSAA 与超采样的 GPU 耗时对比
+    if (settings.aaBenchSeconds > 0.0)
+    {
+        Benchmark::RunAntialiasing(SCR_WIDTH, SCR_HEIGHT, settings.aaBenchSeconds, renderLoad);
+        glfwTerminate();
+        return 0;
+    }
+
+    // 批处理：依次运行作业文件中的每个作业，结果写入汇总 JSON
+    if (!settings.batchFile.empty())
+    {
+        int failed = Batch::Run(window, settings);
+        glfwTerminate();
+        return failed == 0 ? 0 : 1;
+    }
+
+    // 渲染农场的渲染进程：按协调进程分配的帧区间无头渲染
+    if (!settings.farmWorker.empty())
+    {
+        int rc = Farm::RunWorker(window, settings, SCR_WIDTH, SCR_HEIGHT);
+        glfwTerminate();
+        return rc;
+    }
+
+    // 无头模式：不创建 ImGui，按设置的时长/帧数离屏运行并输出统计
+    if (settings.headless)
+    {
+        Headless::Run(window, settings, SCR_WIDTH, SCR_HEIGHT);
+        glfwTerminate();
+        return 0;
+    }
+
     // 设置 ImGui 上下文
     IMGUI_CHECKVERSION();
     ImGui::CreateContext();
@@ -75,19 +162,44 @@ int main(int argc, char** argv)
     ImGui_ImplOpenGL3_Init("#version 330");
 
     // 5. 初始化渲染系统
+    // 异步上传线程（第三个共享上下文）
+    UploadThread* uploader = new UploadThread(window);
+    uploader->Start();
+
     // 单线程渲染器
     Renderer* singleRenderer = new Renderer(SCR_WIDTH, SCR_HEIGHT);
+    singleRenderer->SetUploadThread(uploader);
+    singleRenderer->SetColorFormat(settings.colorFormat);
+    singleRenderer->SetSamples(msaaSamples);
+    singleRenderer->SetUpscaleFilter(settings.upscaleFilter);
     singleRenderer->Init();
     globalSingleRenderer = singleRenderer; // 用于窗口调整大小回调
 
     // 多线程 Worker 和 屏幕渲染器
-    Worker* worker = new Worker(window, SCR_WIDTH, SCR_HEIGHT);
+    WorkerPool* workerPool = new WorkerPool(window, SCR_WIDTH, SCR_HEIGHT, workerCount);
+    workerPool->SetQueueDepth(queueDepth);
+    workerPool->SetColorFormat(settings.colorFormat);
+    workerPool->SetSamples(msaaSamples);
+    workerPool->SetPresentMode(presentMode);
+    workerPool->SetPacing(pacingMode, targetFps);
+    workerPool->SetUploadThread(uploader);
     ScreenRenderer* screen = new ScreenRenderer();
     screen->Init();
-
-    if (useMultiThread) {
-        worker->Start();
-    }
+    screen->SetUpscaleFilter(settings.upscaleFilter);
+    // 实际生效的动态分辨率预算（回读开启时为 0），变化时才通知渲染端
+    double appliedBudget = -1.0;
+
+    // 分块多线程渲染器
+    SplitFrameRenderer* splitRenderer = new SplitFrameRenderer(window, SCR_WIDTH, SCR_HEIGHT);
+    splitRenderer->Configure(sfrThreads, sfrTiles);
+    splitRenderer->SetBalance(tileBalance);
+    splitRenderer->SetColorFormat(settings.colorFormat);
+    splitRenderer->SetSamples(msaaSamples);
+    splitRenderer->SetUploadThread(uploader);
+
+    // Worker 常驻：非当前模式下以热待命状态启动，保持上下文与资源驻留
+    workerPool->Start(renderMode != RenderMode::Multi);
+    splitRenderer->Start(renderMode != RenderMode::Split);
 
     // 6. 渲染循环（FPS/帧时统计）
     using clock = std::chrono::high_resolution_clock;
@@ -97,23 +209,70 @@ int main(int argc, char** argv)
     double lastFps = 0.0;
     double lastAvgMs = 0.0;
 
-    // 辅助函数：模拟主线程 CPU 密集型任务
-    auto DoHeavyWork = [](int units){
-        if (units <= 0) return;
-        volatile double acc = 0.0;
-        int loops = units * 10000;
-        for (int i = 0; i < loops; ++i)
-        {
-            acc += sqrt((double)(i % 100 + 1));
-        }
-    };
-    
     // 记录上一帧的模式状态
-    bool prevMultiThread = useMultiThread;
+    RenderMode prevRenderMode = renderMode;
 
     // 纹理状态追踪
     unsigned int lastTex = 0;
 
+    // 主线程拥有场景状态：每帧计算一份快照发布给渲染端，参数变化录制为命令提交给 Worker
+    CommandList frameCommands;
+    uint64_t simFrame = 0;
+    int sentWorkload = -1;
+
+    // 快照录制/回放：回放时不再运行场景逻辑，逐帧重放录制的快照
+    SceneRecorder *recorder = settings.recordPath.empty() ? nullptr : new SceneRecorder(settings.recordPath.c_str());
+    ScenePlayer *player = settings.replayPath.empty() ? nullptr : new ScenePlayer(settings.replayPath.c_str());
+
+    // 异步上传演示：一个约 15MB 的细分圆环与一张 16MB 的纹理，上传期间渲染不受影响
+    int orbitMesh = -1;
+    auto RequestUploadDemo = [&]() {
+        int mesh = uploader->UploadMesh(Scene::BuildTorus(512, 256));
+        uploader->UploadTexture(2048, 2048, Scene::BuildChecker(2048, 16));
+        if (mesh >= 0) orbitMesh = mesh + 1;
+    };
+    if (settings.uploadDemo) RequestUploadDemo();
+
+    // 帧流输出与图像序列导出：回读完成的帧交给各自的线程
+    StreamSink *sink = nullptr;
+    if (!settings.sinkPath.empty())
+        sink = new StreamSink(settings.sinkPath, settings.sinkFormat, settings.sinkPolicy, settings.sinkFps, settings.sinkQueue);
+    ImageExporter *exporter = nullptr;
+    if (!settings.exportDir.empty())
+        exporter = new ImageExporter(settings.exportDir, settings.exportFormat, settings.exportThreads, settings.exportEvery, settings.exportInFlight);
+    // 共享内存帧服务：槽位按初始窗口尺寸分配，放大窗口后的帧不发布
+    FrameServer *frameServer = nullptr;
+    if (!settings.shmName.empty())
+        frameServer = new FrameServer(settings.shmName, settings.shmSlots, SCR_WIDTH, SCR_HEIGHT);
+    // 帧容器：同样按初始窗口尺寸分配槽位
+    FrameContainer *container = nullptr;
+    if (!settings.containerPath.empty())
+        container = new FrameContainer(settings.containerPath, ContainerCapacity(settings), SCR_WIDTH, SCR_HEIGHT);
+    FrameReadback::Callback readbackCallback = nullptr;
+    if (sink || exporter || frameServer || container)
+    {
+        readbackCallback = [sink, exporter, frameServer, container](const ReadbackFrame &frame) {
+            // 共享内存发布与帧容器写入都只是一次 memcpy，放在可能阻塞的输出之前
+            if (frameServer) frameServer->Publish(frame);
+            if (container) container->Write(frame);
+            if (sink) sink->Push(frame);
+            if (exporter) exporter->Push(frame);
+        };
+    }
+
+    // PBO 异步回读：每个新帧发起一次，开启输出或导出时把像素交给它们
+    int readbackDepth = settings.readbackDepth > 0 ? settings.readbackDepth : 3;
+    bool readbackEnabled = settings.readbackDepth > 0;
+    // GPU 端 YUV 转换：图像导出与共享内存帧服务需要 RGBA，开启它们时不提供
+    int yuvMatrixIndex = (int)settings.yuvMatrix;
+    int yuvRangeIndex = (int)settings.yuvRange;
+    bool yuvAllowed = !exporter && !frameServer;
+    FrameReadback *readback = readbackEnabled ? new FrameReadback(readbackDepth, readbackCallback, settings.yuvMatrix, settings.yuvRange) : nullptr;
+    // 脏矩形回读：按快照比较出变化的分块，非关键帧只回读这些分块
+    DamageTracker *damage = settings.damageKeyframe > 0 ? new DamageTracker(settings.damageKeyframe, settings.damageTile) : nullptr;
+    int residentCount = 0;
+    if (readback) readback->SetDamageTracker(damage);
+
     while (!glfwWindowShouldClose(window))
     {
         // 处理事件
@@ -129,66 +288,286 @@ int main(int argc, char** argv)
         ImGui::Begin(u8"性能测试控制面板");
         
         // 分别显示渲染帧率和 UI 帧率
-        double renderFps = useMultiThread ? worker->GetFPS() : lastFps;
+        double renderFps = lastFps;
+        if (renderMode == RenderMode::Multi) renderFps = workerPool->GetFPS();
+        else if (renderMode == RenderMode::Split) renderFps = splitRenderer->GetFPS();
         
         ImGui::Text(u8"UI 更新率 (UI FPS): %.1f", lastFps);
         ImGui::Text(u8"画面更新率 (Render FPS): %.1f", renderFps);
         ImGui::Text(u8"平均每帧用时: %.3f ms", lastAvgMs);
+        ImGui::Text(u8"模式切换耗时: %.1f us", workerPool->GetSwitchLatencyUs());
         
         ImGui::Separator();
         
-        bool modeChanged = false;
-        if (ImGui::RadioButton(u8"单线程", !useMultiThread)) {
-            useMultiThread = false;
-            modeChanged = true;
+        if (ImGui::RadioButton(u8"单线程", renderMode == RenderMode::Single)) {
+            renderMode = RenderMode::Single;
         }
         ImGui::SameLine();
-        if (ImGui::RadioButton(u8"多线程", useMultiThread)) {
-            useMultiThread = true;
-            modeChanged = true;
+        if (ImGui::RadioButton(u8"多线程", renderMode == RenderMode::Multi)) {
+            renderMode = RenderMode::Multi;
+        }
+        ImGui::SameLine();
+        if (ImGui::RadioButton(u8"分块多线程 (SFR)", renderMode == RenderMode::Split)) {
+            renderMode = RenderMode::Split;
         }
 
         ImGui::Separator();
         ImGui::SliderInt(u8"主线程UI界面负载", &cpuLoad, 0, 1000);
         ImGui::SliderInt(u8"渲染线程负载", &renderLoad, 0, 1000);
 
+        // 多重采样：单线程渲染器立即重建目标，Worker 在下一帧前重建队列，分块渲染需要重启线程
+        int msaaIndex = msaaSamples == 8 ? 3 : msaaSamples == 4 ? 2 : msaaSamples == 2 ? 1 : 0;
+        bool msaaChanged = ImGui::Combo(u8"多重采样 (MSAA)", &msaaIndex, u8"关闭\0" "2x\0" "4x\0" "8x\0");
+        if (msaaChanged)
+        {
+            msaaSamples = msaaIndex ? 1 << msaaIndex : 0;
+            singleRenderer->SetSamples(msaaSamples);
+            workerPool->SetSamples(msaaSamples);
+            splitRenderer->SetSamples(msaaSamples);
+        }
+        ImGui::Text(u8"单线程离屏 GPU 耗时: 绘制 %.3f ms    解析 %.3f ms    实际采样数: %d", singleRenderer->GetSceneGpuMs(),
+                    singleRenderer->GetResolveGpuMs(), singleRenderer->GetSamples());
+
+        // 动态分辨率（单线程与多线程模式）：回读需要固定尺寸，开启回读时固定 100%
+        ImGui::Checkbox(u8"动态分辨率", &dynamicResolution);
+        ImGui::SameLine();
+        ImGui::SliderFloat(u8"帧耗时预算 (ms)", &resolutionBudget, 2.0f, 50.0f, "%.1f");
+        if (ImGui::Combo(u8"放大方式", &upscaleIndex, u8"双线性\0锐化\0"))
+        {
+            singleRenderer->SetUpscaleFilter((UpscaleFilter)upscaleIndex);
+            screen->SetUpscaleFilter((UpscaleFilter)upscaleIndex);
+        }
+        {
+            const DynamicResolution &resolution = renderMode == RenderMode::Multi ? workerPool->GetResolution() : singleRenderer->GetResolution();
+            float scaleHistory[DynamicResolution::HistoryLength];
+            int historyCount = resolution.GetHistory(scaleHistory, DynamicResolution::HistoryLength);
+            char overlay[64];
+            std::snprintf(overlay, sizeof(overlay), u8"当前 %d%%    换档 %llu 次", resolution.GetPercent(), resolution.GetChanges());
+            ImGui::PlotLines(u8"渲染比例历史", scaleHistory, historyCount, 0, overlay, DynamicResolution::MinPercent / 100.0f, 1.0f,
+                             ImVec2(0, 50));
+        }
+
+        // 渲染队列配置（仅多线程模式使用）
+        ImGui::Separator();
+        ImGui::SliderInt(u8"渲染队列深度", &queueDepth, FrameQueue::MinDepth, FrameQueue::MaxDepth);
+        bool depthChanged = ImGui::IsItemDeactivatedAfterEdit();
+        int modeIndex = (int)presentMode;
+        if (ImGui::Combo(u8"呈现模式", &modeIndex, "FIFO\0Mailbox (最新帧优先)\0Discard (未消费即丢弃)\0"))
+        {
+            presentMode = (PresentMode)modeIndex;
+            workerPool->SetPresentMode(presentMode);
+        }
+        ImGui::SliderInt(u8"渲染线程数 (AFR)", &workerCount, 1, WorkerPool::MaxWorkers);
+        bool workerCountChanged = ImGui::IsItemDeactivatedAfterEdit();
+        ImGui::Text(u8"队列占用: %d / %d    丢弃帧数: %llu", workerPool->GetQueueOccupancy(), queueDepth * workerCount, workerPool->GetDroppedFrames());
+        ImGui::Text(u8"待执行命令: %zu    命令队列满被拒绝的帧: %llu    渲染分辨率: %dx%d", workerPool->GetPendingCommands(), workerPool->GetRejectedSubmits(),
+                    workerPool->GetRenderWidth(), workerPool->GetRenderHeight());
+
+        // 渲染节奏控制
+        int pacingIndex = (int)pacingMode;
+        bool pacingChanged = ImGui::Combo(u8"渲染节奏", &pacingIndex, u8"不限速\0帧率上限 (sleep)\0按需渲染\0帧率上限 (sleep + 自旋)\0");
+        pacingChanged |= ImGui::SliderInt(u8"目标帧率", &targetFps, 10, 500);
+        if (pacingChanged)
+        {
+            pacingMode = (PacingMode)pacingIndex;
+            workerPool->SetPacing(pacingMode, targetFps);
+        }
+        unsigned long long rendered = workerPool->GetRenderedFrames();
+        unsigned long long unpresented = workerPool->GetDroppedFrames();
+        ImGui::Text(u8"已渲染: %llu    未呈现: %llu (%.1f%%)    渲染线程空闲: %.0f%%",
+                    rendered, unpresented, rendered ? 100.0 * unpresented / rendered : 0.0, workerPool->GetIdleRatio() * 100.0);
+
+        // 分块渲染配置（仅分块多线程模式使用）
+        ImGui::Separator();
+        ImGui::SliderInt(u8"分块线程数", &sfrThreads, 1, SplitFrameRenderer::MaxThreads);
+        bool sfrChanged = ImGui::IsItemDeactivatedAfterEdit();
+        ImGui::SliderInt(u8"分块数", &sfrTiles, 1, SplitFrameRenderer::MaxTiles);
+        sfrChanged |= ImGui::IsItemDeactivatedAfterEdit();
+        int balanceIndex = (int)tileBalance;
+        if (ImGui::Combo(u8"分块分配", &balanceIndex, u8"静态\0动态 (负载均衡)\0"))
+        {
+            tileBalance = (TileBalance)balanceIndex;
+            splitRenderer->SetBalance(tileBalance);
+        }
+        std::string tileStats;
+        for (int count : splitRenderer->GetTilesPerThread())
+            tileStats += std::to_string(count) + " ";
+        ImGui::Text(u8"整帧延迟: %.2f ms    各线程分块数: %s", splitRenderer->GetFrameLatencyMs(), tileStats.c_str());
+
+        // 异步上传
+        ImGui::Separator();
+        if (ImGui::Button(u8"异步上传演示资源") && orbitMesh < 0) RequestUploadDemo();
+        ImGui::SameLine();
+        ImGui::Text(u8"待上传: %d    已上传: %.1f MB    上传吞吐: %.0f MB/s", uploader->GetPendingUploads(),
+                    uploader->GetUploadedBytes() / (1024.0 * 1024.0), uploader->GetThroughputMBps());
+        RenderTargetStats targetStats = RenderTargetPool::GetTotalStats();
+        ImGui::Text(u8"渲染目标池: 命中 %llu    未命中 %llu    逐出 %llu    驻留 %.1f MB (空闲 %.1f MB)", targetStats.hits,
+                    targetStats.misses, targetStats.evictions, targetStats.residentBytes / (1024.0 * 1024.0),
+                    targetStats.idleBytes / (1024.0 * 1024.0));
+        ImGui::Text(u8"瞬态附件共享: %.1f MB -> %.1f MB    显存峰值: 不共享 %.1f MB / 实际 %.1f MB",
+                    targetStats.transientBytes / (1024.0 * 1024.0), targetStats.aliasedBytes / (1024.0 * 1024.0),
+                    targetStats.peakUnaliasedBytes / (1024.0 * 1024.0), targetStats.peakBytes / (1024.0 * 1024.0));
+
+        // 像素回读
+        ImGui::Separator();
+        bool readbackToggled = ImGui::Checkbox(u8"PBO 异步回读", &readbackEnabled);
+        ImGui::SameLine();
+        ImGui::SliderInt(u8"回读环深度", &readbackDepth, FrameReadback::MinDepth, FrameReadback::MaxDepth);
+        readbackToggled |= ImGui::IsItemDeactivatedAfterEdit();
+        if (yuvAllowed)
+        {
+            readbackToggled |= ImGui::Combo(u8"GPU YUV 转换", &yuvMatrixIndex, u8"关闭 (RGBA)\0BT.601\0BT.709\0");
+            ImGui::SameLine();
+            readbackToggled |= ImGui::Combo(u8"量化范围", &yuvRangeIndex, u8"全范围\0有限范围\0");
+        }
+        if (readback)
+            ImGui::Text(u8"回读延迟: %.2f ms    回读吞吐: %.1f MB/s    已完成: %llu    环满跳过: %llu", readback->GetLatencyMs(),
+                        readback->GetThroughputMBps(), readback->GetDeliveredFrames(), readback->GetSkippedFrames());
+        if (exporter)
+            ImGui::Text(u8"图像导出: %llu 帧    %.1f 帧/s    单核编码: %.1f MB/s x %d 线程    在途: %d    压缩比: %.1f%%",
+                        exporter->GetWrittenFrames(), exporter->GetFramesPerSecond(), exporter->GetPerCoreMBps(),
+                        exporter->GetThreadCount(), exporter->GetInFlight(), exporter->GetCompressionRatio() * 100.0);
+        if (damage)
+            ImGui::Text(u8"脏矩形: 关键帧 %llu    增量帧 %llu    平均脏区域 %.1f%%    分块 %d px", damage->GetKeyframes(),
+                        damage->GetDeltaFrames(), damage->GetAverageCoverage() * 100.0, damage->GetTileSize());
+        if (container)
+            ImGui::Text(u8"帧容器: %llu 帧    跳过: %llu", container->GetWrittenFrames(), container->GetSkippedFrames());
+
         ImGui::End();
 
-        // 处理模式切换
-        if (prevMultiThread != useMultiThread) {
-            if (useMultiThread) {
-                worker->Start();
-                // 切换到多线程模式时，重置上一帧纹理ID，防止使用非法纹理
-                lastTex = 0; 
-            } else {
-                worker->Stop();
+        // 开关回读或修改深度时重建回读环，先取回在途的帧
+        if (readbackToggled)
+        {
+            if (readback) readback->Flush();
+            delete readback;
+            readback = readbackEnabled ? new FrameReadback(readbackDepth, readbackCallback, (YuvMatrix)yuvMatrixIndex, (YuvRange)yuvRangeIndex) : nullptr;
+            if (readback) readback->SetDamageTracker(damage);
+        }
+
+        // 分块配置或多重采样变化需要重建线程
+        if (sfrChanged || msaaChanged)
+        {
+            splitRenderer->Stop();
+            splitRenderer->Configure(sfrThreads, sfrTiles);
+            splitRenderer->Start(renderMode != RenderMode::Split);
+        }
+
+        // 队列深度或渲染线程数变化需要重建渲染目标（松开滑块后才生效）
+        if (depthChanged || workerCountChanged)
+        {
+            workerPool->SetQueueDepth(queueDepth);
+            workerPool->SetWorkerCount(workerCount);
+            workerPool->Stop();
+            workerPool->Start(renderMode != RenderMode::Multi);
+            // 旧队列的纹理已被销毁，重置上一帧纹理ID，防止使用非法纹理
+            lastTex = 0;
+            // 新建的 Worker 需要重新接收参数
+            sentWorkload = -1;
+        }
+
+        // 处理模式切换：Worker 只在热待命与运行之间切换，不重建上下文
+        if (prevRenderMode != renderMode) {
+            if (prevRenderMode == RenderMode::Multi) workerPool->Pause();
+            if (prevRenderMode == RenderMode::Split) splitRenderer->Pause();
+            if (renderMode == RenderMode::Multi) {
+                workerPool->Resume();
+                // 继续呈现暂停前的最后一帧，直到新帧就绪
+                lastTex = workerPool->GetTextureID();
             }
-            prevMultiThread = useMultiThread;
+            if (renderMode == RenderMode::Split) splitRenderer->Resume();
+            prevRenderMode = renderMode;
+        }
+
+        // 窗口尺寸变化转发给 Worker（包括热待命的 Worker，恢复后即为新尺寸）；命令队列满时下一帧重试
+        if (resizePending && workerPool->Resize(pendingResizeWidth, pendingResizeHeight))
+            resizePending = false;
+
+        // 动态分辨率预算
+        double budget = dynamicResolution && !readback ? resolutionBudget : 0.0;
+        if (budget != appliedBudget)
+        {
+            singleRenderer->SetResolutionBudget(budget);
+            workerPool->SetResolutionBudget(budget);
+            appliedBudget = budget;
         }
 
         // 更新负载设置
         singleRenderer->SetSceneWorkload(renderLoad);
-        worker->SetSceneWorkload(renderLoad);
+        splitRenderer->SetSceneWorkload(renderLoad);
 
         // 渲染主逻辑
         auto t0 = clock::now();
         
         // 模拟主线程 CPU 负载
-        DoHeavyWork(cpuLoad);
+        SimulateLogicLoad(cpuLoad);
+
+        // 场景逻辑：计算本帧快照（回放时读取录制的快照）
+        SceneState state;
+        if (!player || !player->Next(state))
+        {
+            int fbWidth, fbHeight;
+            glfwGetFramebufferSize(window, &fbWidth, &fbHeight);
+            float aspect = (fbWidth > 0 && fbHeight > 0) ? (float)fbWidth / (float)fbHeight : (float)SCR_WIDTH / (float)SCR_HEIGHT;
+            state = SimulateScene(simFrame + 1, glfwGetTime(), aspect, orbitMesh);
+        }
+        state.frame = ++simFrame;
+        if (recorder)
+            recorder->Write(state);
+        if (damage)
+        {
+            damage->Record(state);
+            if (orbitMesh >= 0)
+            {
+                glm::vec3 extent(Scene::TorusMajor + Scene::TorusMinor, Scene::TorusMinor, Scene::TorusMajor + Scene::TorusMinor);
+                damage->SetMeshBounds(orbitMesh, -extent, extent);
+            }
+            // 新驻留的网格或纹理改变画面但不改变快照
+            int resident = uploader->CountResident();
+            if (resident != residentCount)
+                damage->Invalidate(simFrame);
+            residentCount = resident;
+        }
 
-        if (!useMultiThread) {
+        if (renderMode == RenderMode::Multi) {
+            // 参数变化走命令流；队列满时留到下一帧重新提交
+            frameCommands.Clear();
+            if (renderLoad != sentWorkload)
+                frameCommands.SetWorkload(renderLoad);
+            if (frameCommands.Empty() || workerPool->SubmitCommands(frameCommands))
+                sentWorkload = renderLoad;
+            // 快照只保留最新一份，渲染线程落后时自动跳过中间状态
+            workerPool->PublishScene(state);
+        } else if (renderMode == RenderMode::Split) {
+            splitRenderer->PublishScene(state);
+        }
+
+        if (renderMode == RenderMode::Single) {
             // 单线程模式：直接在主线程渲染
-            singleRenderer->Render();
+            singleRenderer->Render(state);
+            if (readback)
+                readback->ReadTexture(singleRenderer->GetTextureID(), singleRenderer->GetTextureWidth(),
+                                      singleRenderer->GetTextureHeight(), state.frame, state.frame);
+        } else if (renderMode == RenderMode::Split) {
+            // 分块模式：取得完整的新帧后合成所有分块
+            if (splitRenderer->TryAcquireFrame() && readback) splitRenderer->Readback(readback);
+            glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT);
+            screen->SetSource(nullptr);
+            splitRenderer->Composite(screen);
         } else {
             // 多线程模式：获取 Worker 渲染好的纹理并上屏
-            unsigned int tex = worker->TryGetReadyTexture();
+            unsigned int tex = workerPool->TryGetReadyTexture();
             if (tex)
             {
                 lastTex = tex;
+                // 按该帧的内容尺寸放大（动态分辨率）
+                screen->SetSource(workerPool->GetPresentTarget());
                 screen->DrawTexture(tex);
+                if (readback) readback->ReadTexture(tex, state.frame, workerPool->GetSceneFrame());
             }
             else if (lastTex != 0)
             {
+                screen->SetSource(workerPool->GetPresentTarget());
                 screen->DrawTexture(lastTex);
             }
             else 
@@ -199,6 +578,9 @@ int main(int argc, char** argv)
             }
         }
         
+        // 交付已完成的回读帧（非阻塞）
+        if (readback) readback->Poll();
+
         // 渲染 ImGui UI
         ImGui::Render();
         ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
@@ -228,10 +610,27 @@ int main(int argc, char** argv)
     }
 
     // 清理资源
-    worker->Stop();
-    delete worker;
+    if (readback) readback->Flush();
+    delete readback;
+    delete damage;
+    // 回读已全部交付，写完队列中剩余的帧
+    if (sink) sink->Close();
+    delete sink;
+    if (exporter) exporter->Close();
+    delete exporter;
+    delete frameServer;
+    delete container;
+    delete recorder;
+    delete player;
+    workerPool->Stop();
+    delete workerPool;
+    splitRenderer->Stop();
+    delete splitRenderer;
     delete singleRenderer;
     delete screen;
+    // 所有渲染线程的场景已销毁，最后回收上传的资源
+    uploader->Stop();
+    delete uploader;
 
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
@@ -248,4 +647,11 @@ void framebuffer_size_callback(GLFWwindow *window, int width, int height)
     {
         globalSingleRenderer->Resize(width, height);
     }
+    // 最小化时尺寸为 0，保持原有渲染目标
+    if (width > 0 && height > 0)
+    {
+        pendingResizeWidth = width;
+        pendingResizeHeight = height;
+        resizePending = true;
+    }
 }
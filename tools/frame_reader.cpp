@@ -0,0 +1,163 @@
+// 帧容器读取工具：打开 --container 写出的文件，列出索引或随机取出任意一帧。
+// 用法: frame_reader 容器文件 [--list] [--frame N | --at K] [--out 路径]
+//   --list   列出所有帧的序号、尺寸、偏移与时间戳
+//   --frame  按渲染帧序号取帧；--at 按写入顺序取第 K 帧
+//   --out    写出取到的帧：.png / .qoi 编码为图像，其余（或 - 表示 stdout）写原始 RGBA，行序自顶向下；
+//            GPU 转换的 I420 帧只能原样写出平面（ffmpeg -f rawvideo -pix_fmt yuv420p）
+//            只记录脏分块的帧会从之前最近的整帧叠加还原
+#include "FrameContainerReader.h"
+#include "ImageEncoder.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+static bool EndsWith(const std::string &text, const char *suffix)
+{
+    size_t n = std::strlen(suffix);
+    return text.size() >= n && text.compare(text.size() - n, n, suffix) == 0;
+}
+
+static bool WriteFrame(const ContainerFrame &frame, const std::string &path)
+{
+    std::vector<unsigned char> data;
+    ImageFormat format;
+    if (frame.format == FrameFile::I420TopDown)
+    {
+        if (EndsWith(path, ".png") || EndsWith(path, ".qoi"))
+        {
+            std::fprintf(stderr, "I420 帧只能写出原始平面，请使用 .yuv 或 -\n");
+            return false;
+        }
+        data.assign(frame.pixels, frame.pixels + frame.size);
+    }
+    else if (EndsWith(path, ".png") || EndsWith(path, ".qoi"))
+    {
+        ParseImageFormat(EndsWith(path, ".png") ? "png" : "qoi", format);
+        EncodeImage(format, frame.pixels, frame.width, frame.height, data);
+    }
+    else
+    {
+        // 原始 RGBA：翻转为自顶向下
+        size_t rowBytes = (size_t)frame.width * 4;
+        data.resize(rowBytes * frame.height);
+        for (int y = 0; y < frame.height; ++y)
+            std::memcpy(&data[rowBytes * y], frame.pixels + rowBytes * (frame.height - 1 - y), rowBytes);
+    }
+
+    FILE *file = path == "-" ? stdout : std::fopen(path.c_str(), "wb");
+    if (!file)
+    {
+        std::perror(("无法写入 " + path).c_str());
+        return false;
+    }
+    bool ok = std::fwrite(data.data(), 1, data.size(), file) == data.size();
+    if (file != stdout)
+        ok = std::fclose(file) == 0 && ok;
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    std::string path, outPath;
+    bool list = false;
+    long long frameIndex = -1, ordinal = -1;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--list") == 0) list = true;
+        else if (std::strcmp(argv[i], "--frame") == 0 && i + 1 < argc) frameIndex = std::atoll(argv[++i]);
+        else if (std::strcmp(argv[i], "--at") == 0 && i + 1 < argc) ordinal = std::atoll(argv[++i]);
+        else if (std::strcmp(argv[i], "--out") == 0 && i + 1 < argc) outPath = argv[++i];
+        else path = argv[i];
+    }
+    if (path.empty())
+    {
+        std::fprintf(stderr, "用法: frame_reader 容器文件 [--list] [--frame N | --at K] [--out 路径]\n");
+        return 2;
+    }
+    // 帧写到 stdout 时日志改写到 stderr
+    FILE *log = outPath == "-" ? stderr : stdout;
+
+    using clock = std::chrono::steady_clock;
+    auto openStart = clock::now();
+    FrameContainerReader reader;
+    if (!reader.Open(path))
+    {
+        std::fprintf(stderr, "无法打开帧容器 %s（文件不存在或格式不符）\n", path.c_str());
+        return 1;
+    }
+    double openMs = std::chrono::duration<double, std::milli>(clock::now() - openStart).count();
+
+    const FrameFile::Header *header = reader.GetHeader();
+    uint64_t count = reader.GetFrameCount();
+    std::fprintf(log, "%s  帧数: %llu/%llu  最大尺寸: %ux%u  槽位: %.1f MB  %s%s  打开: %.3f ms\n", path.c_str(),
+                 (unsigned long long)count, (unsigned long long)header->frameCapacity, header->maxWidth, header->maxHeight,
+                 header->slotStride / (1024.0 * 1024.0), reader.IsComplete() ? "已完成" : "未完成（写者仍在运行或异常退出）",
+                 (header->flags & FrameFile::FlagSorted) ? "" : "  帧序号无序", openMs);
+    ContainerFrame first, last;
+    if (reader.GetFrame(0, first) && reader.GetFrame(count - 1, last))
+        std::fprintf(log, "帧序号: %llu – %llu  时间跨度: %.3f s\n", (unsigned long long)first.frameIndex,
+                     (unsigned long long)last.frameIndex, last.timestamp - first.timestamp);
+
+    if (list)
+    {
+        std::fprintf(log, "%8s %10s %11s %6s %14s %12s %18s\n", "#", "frame", "size", "format", "offset", "bytes", "timestamp");
+        for (uint64_t i = 0; i < count; ++i)
+        {
+            ContainerFrame frame;
+            if (!reader.GetFrame(i, frame))
+                break;
+            char size[32];
+            std::snprintf(size, sizeof(size), "%dx%d", frame.width, frame.height);
+            const char *format = frame.format == FrameFile::Rgba8BottomUp ? "rgba" : frame.format == FrameFile::I420TopDown ? "i420" : "tiles";
+            std::fprintf(log, "%8llu %10llu %11s %6s %14llu %12llu %18.6f\n", (unsigned long long)i, (unsigned long long)frame.frameIndex,
+                         size, format, (unsigned long long)(frame.pixels - (const unsigned char *)header), (unsigned long long)frame.size,
+                         frame.timestamp);
+        }
+    }
+
+    if (frameIndex < 0 && ordinal < 0)
+        return 0;
+
+    // 随机访问：二分查找索引后直接读取映射，只有这一帧的页会被读入
+    auto findStart = clock::now();
+    ContainerFrame frame;
+    bool found = frameIndex >= 0 ? reader.FindFrame((uint64_t)frameIndex, frame) : reader.GetFrame((uint64_t)ordinal, frame);
+    if (!found)
+    {
+        if (frameIndex >= 0)
+            std::fprintf(stderr, "容器中没有帧序号 %lld\n", frameIndex);
+        else
+            std::fprintf(stderr, "容器中没有第 %lld 帧（共 %llu 帧）\n", ordinal, (unsigned long long)count);
+        return 1;
+    }
+    std::vector<unsigned char> reconstructed;
+    if (frame.format == FrameFile::Rgba8Tiles && !reader.Reconstruct(frame, reconstructed))
+    {
+        std::fprintf(stderr, "无法还原分块帧 %llu（之前没有完整的整帧或数据损坏）\n", (unsigned long long)frame.frameIndex);
+        return 1;
+    }
+    if (frame.format != FrameFile::Rgba8BottomUp && frame.format != FrameFile::I420TopDown)
+    {
+        std::fprintf(stderr, "不支持的像素格式 %u\n", frame.format);
+        return 1;
+    }
+    // 逐页触碰一次，把缺页计入读入耗时
+    volatile unsigned long long checksum = 0;
+    for (uint64_t i = 0; i < frame.size; i += 4096)
+        checksum += frame.pixels[i];
+    double findMs = std::chrono::duration<double, std::milli>(clock::now() - findStart).count();
+    std::fprintf(log, "帧 %llu  %dx%d  %.2f MB  定位并读入: %.3f ms\n", (unsigned long long)frame.frameIndex, frame.width, frame.height,
+                 frame.size / (1024.0 * 1024.0), findMs);
+
+    if (!outPath.empty())
+    {
+        if (!WriteFrame(frame, outPath))
+            return 1;
+        if (outPath != "-")
+            std::fprintf(log, "已写入 %s\n", outPath.c_str());
+    }
+    return 0;
+}
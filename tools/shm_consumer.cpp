@@ -0,0 +1,116 @@
+// 共享内存帧环的演示读者：零拷贝读取最新帧，统计平均亮度、延迟、漏帧与被覆盖的读取。
+// 用法: shm_consumer [名称] [--slow 毫秒] [--copy] [--frames N]
+//   --slow  每帧额外停顿，模拟处理很慢的读者（写端不受影响，只会出现漏帧）
+//   --copy  使用 CopyLatest 先复制再处理，而不是直接在映射上处理
+#include "FrameShmReader.h"
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+static volatile std::sig_atomic_t stopRequested = 0;
+
+static void OnSignal(int)
+{
+    stopRequested = 1;
+}
+
+// 每隔 step 个像素采样一次的平均亮度（0–255）
+static double AverageLuma(const unsigned char *pixels, int width, int height, int step)
+{
+    double sum = 0.0;
+    size_t count = 0;
+    size_t total = (size_t)width * height;
+    for (size_t i = 0; i < total; i += step)
+    {
+        const unsigned char *p = pixels + i * 4;
+        sum += 0.299 * p[0] + 0.587 * p[1] + 0.114 * p[2];
+        count++;
+    }
+    return count ? sum / count : 0.0;
+}
+
+int main(int argc, char **argv)
+{
+    std::string name = "/offscreen";
+    int slowMs = 0;
+    bool copy = false;
+    long long frameLimit = 0;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--slow") == 0 && i + 1 < argc) slowMs = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--copy") == 0) copy = true;
+        else if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc) frameLimit = std::atoll(argv[++i]);
+        else name = argv[i];
+    }
+    std::signal(SIGINT, OnSignal);
+    std::signal(SIGTERM, OnSignal);
+
+    FrameShmReader reader;
+    std::printf("等待帧服务 %s ...\n", name.c_str());
+    while (!reader.Open(name))
+    {
+        if (stopRequested)
+            return 0;
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    std::printf("已连接  槽位: %d  已发布: %llu 帧\n", reader.GetSlotCount(), (unsigned long long)reader.GetPublished());
+
+    using clock = std::chrono::steady_clock;
+    auto lastReport = clock::now();
+    uint64_t lastGeneration = reader.GetPublished();
+    unsigned long long consumed = 0, skipped = 0, torn = 0, totalConsumed = 0;
+    double latencySum = 0.0, luma = 0.0;
+    std::vector<unsigned char> copyBuffer;
+
+    while (!stopRequested && (frameLimit <= 0 || (long long)totalConsumed < frameLimit))
+    {
+        FrameView view;
+        bool ok = copy ? reader.CopyLatest(copyBuffer, view, lastGeneration) : reader.AcquireLatest(view, lastGeneration);
+        if (!ok)
+        {
+            if (!reader.IsWriterAlive())
+            {
+                std::printf("帧服务已退出\n");
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(500));
+            continue;
+        }
+
+        // 直接在共享内存上计算，完成后确认期间没有被写端覆盖
+        double frameLuma = AverageLuma(view.pixels, view.width, view.height, 16);
+        if (slowMs > 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds(slowMs));
+        if (!copy && !reader.Validate(view))
+        {
+            torn++;
+            lastGeneration = view.generation;
+            continue;
+        }
+
+        skipped += view.generation - lastGeneration - 1;
+        lastGeneration = view.generation;
+        latencySum += FrameShmReader::Now() - view.timestamp;
+        luma = frameLuma;
+        consumed++;
+        totalConsumed++;
+
+        auto now = clock::now();
+        std::chrono::duration<double> elapsed = now - lastReport;
+        if (elapsed.count() >= 1.0)
+        {
+            std::printf("帧 %llu (%dx%d)  读取: %.1f 帧/s  平均亮度: %.1f  延迟: %.2f ms  漏帧: %llu  被覆盖: %llu\n",
+                        (unsigned long long)view.frameIndex, view.width, view.height, consumed / elapsed.count(), luma,
+                        consumed ? latencySum / consumed * 1000.0 : 0.0, skipped, torn);
+            std::fflush(stdout);
+            consumed = 0;
+            latencySum = 0.0;
+            lastReport = now;
+        }
+    }
+    std::printf("读取结束  共 %llu 帧  漏帧: %llu  被覆盖: %llu\n", totalConsumed, skipped, torn);
+    return 0;
+}